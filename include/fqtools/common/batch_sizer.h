@@ -0,0 +1,78 @@
+/**
+ * @file batch_sizer.h
+ * @brief 按字节与实测阶段耗时自适应调整批次大小
+ * @details 固定的记录数对 50 bp 与 20 kb 的 read 意味着相差几百倍的批次字节数。
+ *          AdaptiveBatchSizer 以字节为单位给出下一批的目标大小，并按流水线各阶段实测的
+ *          每字节耗时调整：并行阶段是瓶颈时，让每批的处理耗时接近 targetLatency，
+ *          批次足够小，令牌窗口内有足够多的批次分给各线程；读取或写出等串行阶段是瓶颈时，
+ *          逐步增大批次以摊薄每批的固定开销。目标大小始终限制在 [minBytes, maxBytes] 内，
+ *          单次调整不超过两倍。
+ *
+ * @author LessUp
+ * @date 2026-10-17
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2026 LessUp
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace fq::common {
+
+/**
+ * @brief 流水线阶段
+ */
+enum class BatchStage : std::uint8_t {
+    Read,     ///< 串行：读取并切分数据块
+    Process,  ///< 并行：解析与处理
+    Write,    ///< 串行：写出
+};
+
+struct AdaptiveBatchOptions {
+    size_t initialBytes = 1 * 1024 * 1024;
+    size_t minBytes = 64 * 1024;
+    size_t maxBytes = 4 * 1024 * 1024;
+    size_t workers = 1;  ///< 并行阶段的线程数
+    std::chrono::nanoseconds targetLatency = std::chrono::milliseconds(20);  ///< 并行阶段每批的目标耗时
+};
+
+/**
+ * @brief 批次大小控制器
+ * @details batchBytes() 无锁，可在串行读取阶段每批调用；record() 每批每阶段调用一次，
+ *          各阶段可以在不同线程上并发调用。
+ */
+class AdaptiveBatchSizer {
+public:
+    explicit AdaptiveBatchSizer(const AdaptiveBatchOptions& options);
+
+    /// 下一批的目标字节数
+    [[nodiscard]] auto batchBytes() const -> size_t {
+        return batchBytes_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 记录一批在某阶段的耗时，并在并行阶段的记录到达时更新目标大小
+     * @param bytes 该批的数据字节数，为 0 时忽略
+     */
+    void record(BatchStage stage, size_t bytes, std::chrono::nanoseconds elapsed);
+
+private:
+    void update();
+
+    AdaptiveBatchOptions options_;
+    std::atomic<size_t> batchBytes_;
+
+    std::mutex mutex_;
+    // 各阶段每字节耗时（纳秒）的指数滑动平均，0 表示尚无样本
+    double readNsPerByte_ = 0.0;
+    double processNsPerByte_ = 0.0;
+    double writeNsPerByte_ = 0.0;
+};
+
+}  // namespace fq::common
@@ -0,0 +1,96 @@
+/**
+ * @file simd.h
+ * @brief 运行时 CPU 指令集分派
+ * @details 发行版二进制以 x86-64 基线编译，SIMD 内核各自以 target 属性单独编译，
+ *          首次使用时通过 cpuid 检测 CPU 支持的最高级别，之后所有内核按同一级别选择实现。
+ *          命令行 --simd= 可以把级别压低（用于测试与排查），但不会高于 CPU 实际支持的级别。
+ *
+ * @author LessUp
+ * @date 2026-10-17
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2026 LessUp
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace fq::common {
+
+/**
+ * @brief SIMD 级别，按能力递增排列
+ */
+enum class SimdLevel : std::uint8_t {
+    Scalar,
+    Sse42,
+    Avx2,
+    Avx512,  ///< AVX-512F + AVX-512BW
+};
+
+/**
+ * @brief CPU 支持的最高级别（只检测一次）
+ */
+[[nodiscard]] auto detectSimdLevel() -> SimdLevel;
+
+/**
+ * @brief 当前生效的级别：detectSimdLevel() 与 setSimdLevel() 所设上限中的较低者
+ */
+[[nodiscard]] auto activeSimdLevel() -> SimdLevel;
+
+/**
+ * @brief 设置生效级别的上限，高于 CPU 支持的级别时按 CPU 支持的级别处理
+ * @details 应在创建使用 SIMD 内核的对象之前调用；已取得内核的对象不受影响。
+ */
+void setSimdLevel(SimdLevel level);
+
+/**
+ * @brief 解析级别名称：auto、scalar、sse4.2、avx2、avx512
+ * @details auto 返回 detectSimdLevel()。
+ * @throw std::runtime_error 名称无效
+ */
+[[nodiscard]] auto parseSimdLevel(std::string_view name) -> SimdLevel;
+
+/**
+ * @brief 级别名称（与 parseSimdLevel 接受的名称一致）
+ */
+[[nodiscard]] auto simdLevelName(SimdLevel level) -> std::string_view;
+
+/**
+ * @brief 按字节扫描的通用内核
+ * @details 字节均按有符号 char 解释，与标量代码中 static_cast<int>(char) 的语义一致。
+ */
+struct ByteKernels {
+    /// 第一个不小于 threshold 的字节下标，不存在时返回 size
+    std::size_t (*findFirstAtLeast)(const char* data, std::size_t size, int threshold);
+    /// 最后一个不小于 threshold 的字节之后的位置，不存在时返回 0
+    std::size_t (*findLastAtLeast)(const char* data, std::size_t size, int threshold);
+    /// 所有字节之和
+    std::int64_t (*sum)(const char* data, std::size_t size);
+    /// 等于 lowerLetter 或其大写形式的字节数（lowerLetter 须为小写字母）
+    std::size_t (*countLetter)(const char* data, std::size_t size, char lowerLetter);
+    /// G、C（不区分大小写）的字节数
+    std::size_t (*countGc)(const char* data, std::size_t size);
+    /// 按 64 字节分块标记结构字符：newlines[k] 的第 j 位表示 data[64k + j] 为 '\n'，
+    /// separators[k] 同理标记空格与制表符；data 须至少有 64 * blocks 字节
+    void (*structuralMasks)(const char* data,
+                            std::size_t blocks,
+                            std::uint64_t* newlines,
+                            std::uint64_t* separators);
+};
+
+/**
+ * @brief 指定级别的字节内核；高于 CPU 支持的级别时退回可用的最高级别
+ */
+[[nodiscard]] auto byteKernels(SimdLevel level) -> const ByteKernels&;
+
+/**
+ * @brief 当前生效级别的字节内核
+ */
+[[nodiscard]] inline auto byteKernels() -> const ByteKernels& {
+    return byteKernels(activeSimdLevel());
+}
+
+}  // namespace fq::common
@@ -7,6 +7,7 @@
 
 #include "fqtools/cli/app_info.h"
 #include "fqtools/common/common.h"
+#include "fqtools/common/simd.h"
 #include "fqtools/processing/processing_pipeline_interface.h"
 #include "fqtools/processing/read_mutator_interface.h"
 #include "fqtools/processing/read_predicate_interface.h"
@@ -23,7 +23,7 @@ namespace fq::io {
 /**
  * @brief FastqBatch 默认重置函数
  * @param batch 要重置的批次对象
- * @details 清空批次中的所有记录和缓冲区数据，但保留已分配的内存容量
+ * @details 清空批次中的所有记录、缓冲区数据与 arena 中的改写内容，但保留已分配的内存容量
  */
 inline void resetFastqBatch(FastqBatch& batch) {
     batch.clear();
@@ -0,0 +1,100 @@
+/**
+ * @file fastq_index.h
+ * @brief FASTQ 记录索引（.fqi 旁路文件）
+ * @details 每隔固定条数记录一个检查点（记录序号 + 字节偏移，BGZF 输入另记虚拟偏移），
+ *          FastqReader 可据此直接跳到任意记录，无需从头扫描；多个进程/节点可按记录区间切分同一文件。
+ *
+ *          文件格式（小端）：
+ *          - 头部：magic "FQI\0"、version(u32)、format(u32)、reserved(u32)、
+ *            sourceSize(u64)、interval(u64)、totalRecords(u64)、entryCount(u64)
+ *          - 条目：recordNumber(u64)、offset(u64)、virtualOffset(u64)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fq::io {
+
+/**
+ * @brief 被索引文件的格式
+ * @details 普通 gzip 无法随机访问，不支持建立索引
+ */
+enum class FastqIndexFormat : std::uint8_t {
+    Plain,  ///< 未压缩文本，offset 为文件偏移
+    Bgzf,   ///< BGZF，virtualOffset 为 (块压缩偏移 << 16) | 块内偏移
+};
+
+/**
+ * @brief 索引检查点
+ */
+struct FastqIndexEntry {
+    uint64_t recordNumber = 0;   ///< 记录序号（从 0 开始）
+    uint64_t offset = 0;         ///< 记录在解压后文本中的字节偏移
+    uint64_t virtualOffset = 0;  ///< BGZF 虚拟偏移（仅 Bgzf 格式有效）
+};
+
+class FastqIndex {
+public:
+    static constexpr uint64_t kDefaultInterval = 10000;
+
+    /**
+     * @brief 扫描 FASTQ 文件建立索引
+     * @param fastqPath 未压缩或 BGZF 压缩的 FASTQ 文件
+     * @param interval 检查点间隔（记录数）
+     * @throw std::runtime_error 文件无法打开、为普通 gzip 或格式错误
+     */
+    static auto build(const std::string& fastqPath, uint64_t interval = kDefaultInterval)
+        -> FastqIndex;
+
+    /**
+     * @brief 读取 .fqi 文件
+     * @throw std::runtime_error 文件无法打开或格式不正确
+     */
+    static auto load(const std::string& indexPath) -> FastqIndex;
+
+    /**
+     * @brief 写出 .fqi 文件
+     * @throw std::runtime_error 文件无法写入
+     */
+    void save(const std::string& indexPath) const;
+
+    /**
+     * @brief 索引文件的默认路径：<fastqPath>.fqi
+     */
+    [[nodiscard]] static auto defaultPath(const std::string& fastqPath) -> std::string;
+
+    [[nodiscard]] auto format() const -> FastqIndexFormat {
+        return format_;
+    }
+    [[nodiscard]] auto sourceSize() const -> uint64_t {
+        return sourceSize_;
+    }
+    [[nodiscard]] auto interval() const -> uint64_t {
+        return interval_;
+    }
+    [[nodiscard]] auto totalRecords() const -> uint64_t {
+        return totalRecords_;
+    }
+    [[nodiscard]] auto entries() const -> const std::vector<FastqIndexEntry>& {
+        return entries_;
+    }
+
+    /**
+     * @brief 不晚于 recordNumber 的最近检查点
+     * @pre recordNumber < totalRecords()
+     */
+    [[nodiscard]] auto checkpointFor(uint64_t recordNumber) const -> const FastqIndexEntry&;
+
+private:
+    FastqIndexFormat format_ = FastqIndexFormat::Plain;
+    uint64_t sourceSize_ = 0;
+    uint64_t interval_ = kDefaultInterval;
+    uint64_t totalRecords_ = 0;
+    std::vector<FastqIndexEntry> entries_;
+};
+
+}  // namespace fq::io
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <span>
 #include <string_view>
 #include <vector>
@@ -34,9 +35,88 @@ struct FastqRecord {
     }
 };
 
+/**
+ * @brief 批次内的追加式内存区
+ * @details 供需要生成新字节的修改器（反向互补、N 屏蔽、质量分箱、把 UMI 移入头部等）存放改写后的内容，
+ *          记录视图可以直接指向这里，不必逐条 read 分配堆内存。
+ *          - 内存按块分配，块从不移动，已分配的地址在 reset() 之前一直有效；
+ *          - reset() 把用过的多个块合并为一块（容量为各块之和）留给下一批，批次大小稳定后不再分配；
+ *          - 首次 allocate() 前不分配任何内存，不改写序列的流程没有额外开销。
+ *          不是线程安全的：与批次本身一样，同一时间只由一个线程使用。
+ */
+class FastqArena {
+public:
+    FastqArena() = default;
+
+    FastqArena(const FastqArena&) = delete;
+    FastqArena& operator=(const FastqArena&) = delete;
+    FastqArena(FastqArena&&) noexcept = default;
+    FastqArena& operator=(FastqArena&&) noexcept = default;
+
+    /**
+     * @brief 分配 size 字节（不初始化、不对齐）
+     * @return 在下一次 reset() 之前有效的地址
+     */
+    [[nodiscard]] auto allocate(size_t size) -> char* {
+        if (chunks_.empty() || used_ + size > chunks_.back().capacity) {
+            // 新块至少与已有总容量相当，块数按对数增长
+            addChunk(std::max({size, kMinChunkBytes, capacity_}));
+        }
+        char* ptr = chunks_.back().data.get() + used_;
+        used_ += size;
+        return ptr;
+    }
+
+    /// 把 text 拷入 arena，返回指向副本的视图
+    [[nodiscard]] auto copy(std::string_view text) -> std::string_view {
+        if (text.empty()) {
+            return {};
+        }
+        char* dst = allocate(text.size());
+        std::memcpy(dst, text.data(), text.size());
+        return {dst, text.size()};
+    }
+
+    /// 释放本批分配的全部内容，保留容量
+    void reset() {
+        if (chunks_.size() > 1) {
+            chunks_.clear();
+            addChunk(capacity_);
+        }
+        used_ = 0;
+    }
+
+    /// 当前持有的字节数
+    [[nodiscard]] auto capacity() const -> size_t {
+        return capacity_;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t capacity = 0;
+    };
+
+    static constexpr size_t kMinChunkBytes = 64 * 1024;
+
+    void addChunk(size_t bytes) {
+        chunks_.push_back(Chunk{std::unique_ptr<char[]>(new char[bytes]), bytes});
+        capacity_ = 0;
+        for (const auto& chunk : chunks_) {
+            capacity_ += chunk.capacity;
+        }
+        used_ = 0;
+    }
+
+    std::vector<Chunk> chunks_;
+    size_t used_ = 0;      // 最后一块中已分配的字节数
+    size_t capacity_ = 0;  // 各块容量之和
+};
+
 /**
  * @brief FastqBatch 数据容器
  * @details 拥有并管理一块连续内存，用于存储批量的 FASTQ 记录。
+ *          修改器生成的新内容存放在 arena() 中，随 clear() 一起重置。
  */
 class FastqBatch {
 public:
@@ -55,6 +135,9 @@ public:
         buffer_.clear();
         records_.clear();
         remainderOffset_ = 0;
+        externalData_ = {};
+        externalOwner_.reset();
+        arena_.reset();
     }
 
     // 记录访问
@@ -89,6 +172,28 @@ public:
         return buffer_;
     }
 
+    // 改写记录用的内存区，指向其中的视图在 clear() 前有效
+    [[nodiscard]] auto arena() -> FastqArena& {
+        return arena_;
+    }
+
+    /**
+     * @brief 绑定外部数据（供 Reader 的零拷贝模式使用）
+     * @details 记录直接指向外部内存（如 mmap 映射），owner 保证其在批次存活期间有效。
+     */
+    void setExternalData(std::string_view data, std::shared_ptr<const void> owner) {
+        externalData_ = data;
+        externalOwner_ = std::move(owner);
+    }
+
+    // 批次对应的原始文本：外部数据优先，否则为内部 buffer
+    [[nodiscard]] auto data() const -> std::string_view {
+        if (externalOwner_) {
+            return externalData_;
+        }
+        return {buffer_.data(), buffer_.size()};
+    }
+
     // 将未处理完的碎片移动到 Buffer 头部（供 Reader 使用）
     // 返回移动的字节数
     auto moveRemainderToStart(size_t validEndPos) -> size_t {
@@ -112,6 +217,9 @@ private:
     std::vector<char> buffer_;
     std::vector<FastqRecord> records_;
     size_t remainderOffset_ = 0;
+    std::string_view externalData_;
+    std::shared_ptr<const void> externalOwner_;
+    FastqArena arena_;
 };
 
 }  // namespace fq::io
@@ -0,0 +1,30 @@
+/**
+ * @file fastq_merge.h
+ * @brief 按顺序合并多个 FASTQ 文件（例如各分片的输出）
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "fastq_reader.h"
+#include "fastq_writer.h"
+
+namespace fq::io {
+
+/**
+ * @brief 按给定顺序把 inputs 合并为 outputPath
+ * @details 输出格式由 options.compression 决定（Auto 时按 .gz 后缀）。所有输入与输出格式一致时
+ *          直接拼接字节：未压缩文件原样拼接，BGZF 文件去掉中间的 EOF 块后拼接，不解压也不重新压缩；
+ *          否则逐条读取记录并重新写出：此时 readerOptions 用于读取各输入（如 BGZF 输入的解压线程数），
+ *          options 用于写出。
+ * @return 是否走了直接拼接路径
+ * @throw std::runtime_error 输入无法打开、格式错误或输出无法写入
+ */
+auto mergeFastqFiles(const std::vector<std::string>& inputs,
+                     const std::string& outputPath,
+                     const FastqWriterOptions& options = {},
+                     const FastqReaderOptions& readerOptions = {}) -> bool;
+
+}  // namespace fq::io
@@ -1,22 +1,70 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 
+#include "fastq_index.h"
 #include "fastq_io.h"
 
 namespace fq::io {
 
+/**
+ * @brief 输入读取方式
+ * @details Auto 对未压缩的常规文件使用 mmap，其余情况（gzip、管道等）使用流式读取；
+ *          Mmap 在无法映射时同样回退到流式读取。
+ */
+enum class FastqReaderInputMode : std::uint8_t {
+    Auto,
+    Stream,
+    Mmap,
+};
+
+/**
+ * @brief Reader 配置
+ * @details BGZF 输入按块并行解压，decompressionThreads 为 1 时串行，0 时使用全部可用核心；
+ *          其他 gzip 输入默认通过 zlib 顺序解压。speculativeInflate 为 true 时，普通 gzip 常规文件
+ *          改用推测式并行解压：压缩流按 readChunkBytes 切段，各段从猜测的块边界开始并行解码，
+ *          无法与前一段衔接的段会被丢弃并顺序重解，输出与顺序解压完全一致。
+ *
+ *          shardCount 大于 1 时只读取第 shardIndex 个分片（从 0 开始），供多进程/多节点切分同一输入：
+ *          - 未压缩文件按字节均分，分片边界向后推进到下一个真正的记录起点，各分片首尾相接、互不重叠；
+ *          - BGZF 文件需要 <input>.fqi 索引（见 FastqIndex），按记录数均分；
+ *          - 普通 gzip 无法随机访问，不支持分片。
+ *
+ *          targetBatchBytes 非 0 时，nextBatch()/nextChunk() 每批读取约该字节数（不超过
+ *          maxBufferBytes），maxRecords 只限制解析的记录数；为 0 时按 maxRecords 乘以实测的
+ *          每条记录平均字节数估算（尚无样本时按 512 字节）。
+ *
+ *          readAheadBuffers 非 0 时，流式读取（含各类 gzip）改由后台 I/O 线程进行：该线程最多提前读入
+ *          readAheadBuffers 段 readChunkBytes 大小的数据，磁盘或网络文件系统的等待与解析、处理重叠。
+ *          数据直接读入批次共享的数据块，不额外拷贝。gzip 的解压也在该线程上完成。mmap 读取不受影响。
+ *
+ *          ioUring 为 true 时，未压缩的常规文件通过 io_uring 保持多个读请求在途，不需要额外线程；
+ *          此时 Auto 模式改用流式读取而不是 mmap。内核不支持（或被容器禁用）时回退到原来的方式。
+ */
 struct FastqReaderOptions {
     size_t readChunkBytes = 1 * 1024 * 1024;
     size_t zlibBufferBytes = 128 * 1024;
     size_t maxBufferBytes = 0;
+    FastqReaderInputMode inputMode = FastqReaderInputMode::Auto;
+    size_t decompressionThreads = 1;
+    bool speculativeInflate = false;
+    size_t shardIndex = 0;
+    size_t shardCount = 1;
+    size_t targetBatchBytes = 0;
+    size_t readAheadBuffers = 0;
+    bool ioUring = false;
 };
 
 class FastqReader {
 public:
     explicit FastqReader(const std::string& path);
+    /**
+     * @throw std::runtime_error 分片参数无效，或输入格式不支持分片（普通 gzip、缺少索引的 BGZF）
+     */
     FastqReader(const std::string& path, const FastqReaderOptions& options);
     ~FastqReader();
 
@@ -32,11 +80,53 @@ public:
 
     [[nodiscard]] auto nextBatch(FastqBatch& batch, size_t maxRecords) -> bool;
 
+    /**
+     * @brief 读取下一段原始数据块，不解析记录
+     * @details 数据块在安全的记录边界处截断，只包含完整记录，batch.records() 为空；
+     *          随后可在任意线程调用 parseChunk() 生成记录视图。maxRecords 仅用于估算块大小，
+     *          设置了 targetBatchBytes 时不使用。
+     *          通过 seekToRecord() 限定了记录数时，需要在读取时截断，返回的批次已解析。
+     */
+    [[nodiscard]] auto nextChunk(FastqBatch& batch, size_t maxRecords) -> bool;
+
+    /**
+     * @brief 调整之后各批的目标字节数（见 FastqReaderOptions::targetBatchBytes），0 表示按记录数估算
+     * @details 供自适应批次控制在两次读取之间调用，不能与 nextBatch()/nextChunk() 并发。
+     */
+    void setTargetBatchBytes(size_t bytes);
+
+    /**
+     * @brief 将 nextChunk() 得到的数据块解析为记录视图
+     * @details 不访问 Reader 状态，可在并行阶段对不同批次并发调用；已解析的批次保持不变。
+     * @throw std::runtime_error 数据块格式错误
+     */
+    static void parseChunk(FastqBatch& batch);
+
+    /**
+     * @brief 借助索引跳到第 firstRecord 条记录（从 0 开始），此后最多返回 recordCount 条记录
+     * @details 先定位到不晚于 firstRecord 的检查点，再顺序跳过至多 index.interval() 条记录。
+     *          firstRecord 不小于记录总数时后续读取直接返回 false。
+     * @throw std::runtime_error 索引格式或文件大小与输入不符
+     */
+    void seekToRecord(const FastqIndex& index,
+                      uint64_t firstRecord,
+                      uint64_t recordCount = std::numeric_limits<uint64_t>::max());
+
     /**
      * @brief 检查文件是否成功打开
      */
     [[nodiscard]] auto isOpen() const -> bool;
 
+    /**
+     * @brief 是否以 mmap 方式读取（记录直接指向映射内存，批次不拷贝数据）
+     */
+    [[nodiscard]] auto isMemoryMapped() const -> bool;
+
+    /**
+     * @brief 输入是否为 BGZF 并使用按块并行解压
+     */
+    [[nodiscard]] auto isBgzf() const -> bool;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
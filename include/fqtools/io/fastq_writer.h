@@ -14,10 +14,17 @@ enum class FastqWriterCompressionMode : std::uint8_t {
     None,
 };
 
+/**
+ * @brief Writer 配置
+ * @details Gzip 输出为 BGZF 兼容格式：由独立可解压的 gzip 成员组成（每块未压缩数据不超过
+ *          0xff00 字节，FEXTRA 中带 BC 子字段），末尾追加 BGZF EOF 块，可被 zcat/htslib 直接读取。
+ */
 struct FastqWriterOptions {
-    size_t zlibBufferBytes = static_cast<size_t>(128) * 1024;
     size_t outputBufferBytes = static_cast<size_t>(128) * 1024;
     FastqWriterCompressionMode compression = FastqWriterCompressionMode::Auto;
+    int compressionLevel = 6;        ///< libdeflate 压缩级别（0-12）
+    size_t compressionThreads = 1;   ///< 压缩线程数：1 为串行，0 为使用全部可用核心
+    bool ioUring = false;            ///< 常规文件经 io_uring 异步写出，不支持时回退到 ::write
 };
 
 class FastqWriter {
@@ -34,6 +41,10 @@ public:
     FastqWriter(FastqWriter&&) noexcept;
     FastqWriter& operator=(FastqWriter&&) noexcept;
 
+    /**
+     * @brief 写出批次中的全部记录
+     * @details 与批次原文逐字节一致的相邻记录整段写出，其余记录逐条拼装，输出与逐条写出相同
+     */
     void write(const FastqBatch& batch);
     void write(const FastqRecord& record);
     bool isOpen() const;
@@ -1,8 +1,8 @@
 #pragma once
 
+#include "fqtools/common/simd.h"
 #include "fqtools/io/fastq_io.h"
 
-#include <atomic>
 #include <string>
 #include <vector>
 
@@ -20,24 +20,33 @@ public:
                    int qualityEncoding = 33);
 
     void process(fq::io::FastqRecord& read) override;
+    void processBatch(std::span<fq::io::FastqRecord> reads, const ReadPassMask& passMask) override;
+    auto metricsRequest() const -> ReadMetricsRequest override;
+    void processBatchWithMetrics(std::span<fq::io::FastqRecord> reads,
+                                 const ReadMetricsBatch& metrics,
+                                 const ReadPassMask& passMask) override;
 
-    auto getName() const -> std::string;
+    auto getName() const -> std::string override;
     auto getDescription() const -> std::string;
-    void reset();
+
+    [[nodiscard]] auto trimMode() const -> TrimMode { return trimMode_; }
+    [[nodiscard]] auto minLength() const -> size_t { return minLength_; }
+    /// 质量字符不小于该值即保留（已按编码偏移换算）
+    [[nodiscard]] auto qualityTarget() const -> int { return qualityTarget_; }
 
 private:
     double qualityThreshold_;
     size_t minLength_;
     TrimMode trimMode_;
     int qualityEncoding_;
-
-    std::atomic<size_t> totalProcessed_{0};
-    std::atomic<size_t> trimmedCount_{0};
-    std::atomic<size_t> totalBasesRemoved_{0};
+    // 质量字符不小于该值即为高质量，等价于 q - encoding >= qualityThreshold_
+    int qualityTarget_;
+    const fq::common::ByteKernels* kernels_;
 
     auto trimFivePrime(std::string_view sequence, std::string_view quality) const -> size_t;
     auto trimThreePrime(std::string_view sequence, std::string_view quality) const -> size_t;
-    auto isHighQuality(char qualityChar) const -> bool;
+    // 按首个/末个高质量碱基位置（见 ReadMetrics）修剪非空 read
+    void applyTrim(fq::io::FastqRecord& read, size_t firstHighQuality, size_t lastHighQuality) const;
 };
 
 class LengthTrimmer : public ReadMutatorInterface {
@@ -48,17 +57,12 @@ public:
 
     void process(fq::io::FastqRecord& read) override;
 
-    auto getName() const -> std::string;
+    auto getName() const -> std::string override;
     auto getDescription() const -> std::string;
-    void reset();
 
 private:
     size_t targetLength_;
     TrimStrategy strategy_;
-
-    std::atomic<size_t> totalProcessed_{0};
-    std::atomic<size_t> trimmedCount_{0};
-    std::atomic<size_t> totalBasesRemoved_{0};
 };
 
 class AdapterTrimmer : public ReadMutatorInterface {
@@ -69,19 +73,14 @@ public:
 
     void process(fq::io::FastqRecord& read) override;
 
-    auto getName() const -> std::string;
+    auto getName() const -> std::string override;
     auto getDescription() const -> std::string;
-    void reset();
 
 private:
     std::vector<std::string> adapters_;
     size_t minOverlap_;
     size_t maxMismatches_;
 
-    std::atomic<size_t> totalProcessed_{0};
-    std::atomic<size_t> adapterFound_{0};
-    std::atomic<size_t> totalBasesRemoved_{0};
-
     auto findAdapter(std::string_view sequence, std::string_view adapter) const -> size_t;
     auto countMismatches(std::string_view seq1, std::string_view seq2) const -> size_t;
 };
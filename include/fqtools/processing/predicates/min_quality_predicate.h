@@ -1,76 +1,131 @@
 #pragma once
 
+#include "fqtools/common/simd.h"
 #include "fqtools/io/fastq_io.h"
 
-#include <atomic>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "fqtools/processing/read_predicate_interface.h"
 
 namespace fq::processing {
 
+/**
+ * @brief 平均质量阈值的整数判定
+ * @details 平均质量 >= minQuality 等价于 质量和 >= ceil(minQuality * 长度)。
+ *          常见长度的右端在构造时算好，逐 read 只做一次整数比较，不做浮点除法。
+ */
+class AverageQualityThreshold {
+public:
+    AverageQualityThreshold(double minQuality, int qualityEncoding);
+
+    /**
+     * @brief 判定平均质量是否达到阈值
+     * @param qualitySum 质量字节之和（有符号 char，未减编码偏移）
+     * @param length 质量串长度，为 0 时不通过
+     */
+    [[nodiscard]] auto passes(std::int64_t qualitySum, size_t length) const -> bool {
+        if (length == 0 || neverPasses_) {
+            return false;
+        }
+        // 与逐字符累加到 uint64_t 的结果一致（含低于编码偏移时的回绕）
+        const auto sumQual = static_cast<std::uint64_t>(
+            qualitySum - static_cast<std::int64_t>(length) * qualityEncoding_);
+        return sumQual >= requiredSum(length);
+    }
+
+    [[nodiscard]] auto minQuality() const -> double { return minQuality_; }
+    [[nodiscard]] auto qualityEncoding() const -> int { return qualityEncoding_; }
+
+private:
+    static constexpr size_t kTableSize = 1024;
+
+    double minQuality_;
+    int qualityEncoding_;
+    bool neverPasses_;
+    std::vector<std::uint64_t> requiredSums_;  ///< 下标为长度
+
+    [[nodiscard]] auto requiredSum(size_t length) const -> std::uint64_t {
+        return length < requiredSums_.size() ? requiredSums_[length] : computeRequiredSum(length);
+    }
+    [[nodiscard]] auto computeRequiredSum(size_t length) const -> std::uint64_t;
+};
+
 class MinQualityPredicate : public ReadPredicateInterface {
 public:
     explicit MinQualityPredicate(double minQuality, int qualityEncoding = 33);
     auto evaluate(const fq::io::FastqRecord& read) const -> bool override;
-
-    auto getName() const -> std::string;
+    void evaluateBatch(std::span<const fq::io::FastqRecord> reads,
+                       ReadPassMask& passMask) const override;
+    auto metricsRequest() const -> ReadMetricsRequest override;
+    void evaluateBatchWithMetrics(std::span<const fq::io::FastqRecord> reads,
+                                  const ReadMetricsBatch& metrics,
+                                  ReadPassMask& passMask) const override;
+
+    auto getName() const -> std::string override;
     auto getDescription() const -> std::string;
-    auto getStatistics() const -> std::string;
+
+    [[nodiscard]] auto threshold() const -> const AverageQualityThreshold& { return threshold_; }
 
 private:
-    double minQuality_;
-    int qualityEncoding_;
-    mutable std::atomic<size_t> totalEvaluated_{0};
-    mutable std::atomic<size_t> passedCount_{0};
+    AverageQualityThreshold threshold_;
+    const fq::common::ByteKernels* kernels_;
 
-    // Helper to calculate average quality from string_view
-    auto calculateAverageQuality(std::string_view qualityString) const -> double;
+    auto passesQuality(std::string_view qualityString) const -> bool;
 };
 
 class MinLengthPredicate : public ReadPredicateInterface {
 public:
     explicit MinLengthPredicate(size_t minLength);
     auto evaluate(const fq::io::FastqRecord& read) const -> bool override;
+    void evaluateBatch(std::span<const fq::io::FastqRecord> reads,
+                       ReadPassMask& passMask) const override;
 
-    auto getName() const -> std::string;
+    auto getName() const -> std::string override;
     auto getDescription() const -> std::string;
-    auto getStatistics() const -> std::string;
+
+    [[nodiscard]] auto minLength() const -> size_t { return minLength_; }
 
 private:
     size_t minLength_;
-    mutable std::atomic<size_t> totalEvaluated_{0};
-    mutable std::atomic<size_t> passedCount_{0};
 };
 
 class MaxLengthPredicate : public ReadPredicateInterface {
 public:
     explicit MaxLengthPredicate(size_t maxLength);
     auto evaluate(const fq::io::FastqRecord& read) const -> bool override;
+    void evaluateBatch(std::span<const fq::io::FastqRecord> reads,
+                       ReadPassMask& passMask) const override;
 
-    auto getName() const -> std::string;
+    auto getName() const -> std::string override;
     auto getDescription() const -> std::string;
-    auto getStatistics() const -> std::string;
+
+    [[nodiscard]] auto maxLength() const -> size_t { return maxLength_; }
 
 private:
     size_t maxLength_;
-    mutable std::atomic<size_t> totalEvaluated_{0};
-    mutable std::atomic<size_t> passedCount_{0};
 };
 
 class MaxNRatioPredicate : public ReadPredicateInterface {
 public:
     explicit MaxNRatioPredicate(double maxNRatio);
     auto evaluate(const fq::io::FastqRecord& read) const -> bool override;
-
-    auto getName() const -> std::string;
+    void evaluateBatch(std::span<const fq::io::FastqRecord> reads,
+                       ReadPassMask& passMask) const override;
+    auto metricsRequest() const -> ReadMetricsRequest override;
+    void evaluateBatchWithMetrics(std::span<const fq::io::FastqRecord> reads,
+                                  const ReadMetricsBatch& metrics,
+                                  ReadPassMask& passMask) const override;
+
+    auto getName() const -> std::string override;
     auto getDescription() const -> std::string;
-    auto getStatistics() const -> std::string;
+
+    [[nodiscard]] auto maxNRatio() const -> double { return maxNRatio_; }
 
 private:
     double maxNRatio_;
-    mutable std::atomic<size_t> totalEvaluated_{0};
-    mutable std::atomic<size_t> passedCount_{0};
+    const fq::common::ByteKernels* kernels_;
 
     auto calculateNRatio(std::string_view sequence) const -> double;
 };
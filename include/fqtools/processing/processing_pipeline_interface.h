@@ -24,6 +24,19 @@
 
 namespace fq::processing {
 
+/**
+ * @brief 单个处理阶段的计数
+ * @details 谓词只有 evaluated/passed；修改器的 passed 为修改后仍非空的读取数，
+ *          并记录被修改的读取数与修剪掉的碱基数
+ */
+struct StageStatistics {
+    std::string name;           ///< 阶段名称（getName()）
+    uint64_t evaluated = 0;     ///< 到达该阶段的读取数
+    uint64_t passed = 0;        ///< 通过该阶段的读取数
+    uint64_t modified = 0;      ///< 被修改的读取数（仅修改器）
+    uint64_t basesRemoved = 0;  ///< 被修剪掉的碱基数（仅修改器）
+};
+
 /**
  * @brief 处理统计信息结构体
  * @details 记录 FastQ 数据处理过程中的各项统计指标，用于性能监控和结果分析
@@ -39,6 +52,8 @@ struct ProcessingStatistics {
     uint64_t elapsedMs = 0;          ///< 处理时间（毫秒）
     double processingTimeMs = 0.0;  ///< 处理时间（毫秒，浮点数，保留兼容）
     double throughputMbps = 0.0;     ///< 吞吐量（MB/s）
+    /// 各阶段计数：先谓词后修改器，各自按添加顺序
+    std::vector<StageStatistics> stages;
 
     auto getPassRate() const -> double {
         return totalReads > 0 ? static_cast<double>(passedReads) / totalReads : 0.0;
@@ -48,6 +63,12 @@ struct ProcessingStatistics {
         return totalReads > 0 ? static_cast<double>(filteredReads) / totalReads : 0.0;
     }
 
+    /**
+     * @brief 累加另一份统计的计数字段（读取数、字节数与各阶段计数），不含耗时与吞吐量
+     * @details 每个批次在工作线程内单独计数，由串行的写出阶段合并，热路径上没有共享计数器
+     */
+    void merge(const ProcessingStatistics& other);
+
     auto toString() const -> std::string;
 };
 
@@ -61,13 +82,24 @@ struct ProcessingStatistics {
 struct ProcessingConfig {
     size_t batchSize = 10000;  ///< 批处理大小（每个批次的读取数量）
     size_t threadCount = 1;    ///< 线程数量（1表示串行处理）
+    size_t batchBytes = 0;     ///< 每批目标字节数，非 0 时取代 batchSize
+    bool adaptiveBatch = false;  ///< 按实测的阶段耗时调整每批字节数（从 batchBytes 起步）
 
     size_t readChunkBytes = 1 * 1024 * 1024;
-    size_t zlibBufferBytes = 128 * 1024;
+    size_t zlibBufferBytes = 128 * 1024;  ///< zlib 解压缓冲区，只用于读取普通 gzip 输入
+    bool speculativeInflate = false;  ///< 普通 gzip 输入使用推测式并行解压
+    size_t readAheadBuffers = 0;      ///< 后台 I/O 线程预读的数据块数，0 表示不预读
+    bool ioUring = false;             ///< 常规文件的输入输出经 io_uring 异步读写
+    size_t shardIndex = 0;            ///< 只处理第 shardIndex 个输入分片（从 0 开始）
+    size_t shardCount = 1;            ///< 输入分片总数，1 表示处理整个文件
     size_t writerBufferBytes = 128 * 1024;
+    int compressionLevel = 6;         ///< gzip 输出压缩级别
+    size_t compressionThreads = 0;    ///< gzip 输出压缩线程数（0 表示与 threadCount 相同）
     size_t batchCapacityBytes = 4 * 1024 * 1024;
     size_t memoryLimitBytes = 0;
     size_t maxInFlightBatches = 0;
+    /// 多线程时按完成顺序写出各批（批内记录顺序不变），不再保持输入顺序
+    bool unorderedOutput = false;
 };
 
 /**
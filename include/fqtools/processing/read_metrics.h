@@ -0,0 +1,113 @@
+#pragma once
+
+/**
+ * @file read_metrics.h
+ * @brief 每条 read 的共享度量
+ * @details 质量和、N 数、GC 数与高质量碱基边界在每批开始时按各阶段的需求合并计算一次，
+ *          趁 read 还在缓存中时用 SIMD 内核一次算完，之后各谓词/修改器直接读取，
+ *          不再各自整批重新扫描序列与质量串。
+ *
+ * @author LessUp
+ * @date 2026-10-17
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2026 LessUp
+ */
+
+#include "fqtools/common/simd.h"
+#include "fqtools/io/fastq_io.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace fq::processing {
+
+// 每条 read 一个字节：1 表示仍在通过，0 表示已被过滤
+using ReadPassMask = std::vector<std::uint8_t>;
+
+/**
+ * @brief 可请求的度量，按位组合
+ */
+enum ReadMetric : unsigned {
+    kMetricQualitySum = 1U << 0,
+    kMetricNCount = 1U << 1,
+    kMetricGcCount = 1U << 2,
+    kMetricHighQualityBounds = 1U << 3,
+};
+
+/**
+ * @brief 阶段对度量的需求
+ */
+struct ReadMetricsRequest {
+    unsigned metrics = 0;   ///< ReadMetric 位
+    int qualityTarget = 0;  ///< 高质量边界的阈值（质量字符不小于该值），仅在请求边界时有效
+
+    /// 合并另一阶段的需求；边界阈值不同时保留先请求的阈值
+    void merge(const ReadMetricsRequest& other) {
+        if ((other.metrics & kMetricHighQualityBounds) != 0 &&
+            (metrics & kMetricHighQualityBounds) == 0) {
+            qualityTarget = other.qualityTarget;
+        }
+        metrics |= other.metrics;
+    }
+};
+
+/**
+ * @brief 一条 read 的度量
+ * @details 未请求的字段保持为 0。
+ */
+struct ReadMetrics {
+    std::int64_t qualitySum = 0;  ///< 全部质量字节之和（有符号 char，未减编码偏移）
+    size_t nCount = 0;            ///< 序列中 N/n 的个数
+    size_t gcCount = 0;           ///< 序列中 G/C（不区分大小写）的个数
+    size_t length = 0;            ///< 序列长度
+    /// 在 min(序列长度, 质量长度) 范围内首个高质量碱基的下标，不存在时为该范围长度
+    size_t firstHighQuality = 0;
+    /// 同一范围内最后一个高质量碱基之后的位置，不存在时为 0
+    size_t lastHighQuality = 0;
+};
+
+/**
+ * @brief 按需求计算一条 read 的度量
+ */
+[[nodiscard]] auto measureRead(const fq::common::ByteKernels& kernels,
+                               const fq::io::FastqRecord& read,
+                               const ReadMetricsRequest& request) -> ReadMetrics;
+
+/**
+ * @brief 一批 read 的度量，与 FastqBatch::records() 一一对应
+ */
+class ReadMetricsBatch {
+public:
+    ReadMetricsBatch() : kernels_(&fq::common::byteKernels()) {}
+
+    /**
+     * @brief 计算 passMask 中为 1 的 read 的度量，其余 read 的度量为 0
+     */
+    void compute(std::span<const fq::io::FastqRecord> reads,
+                 const ReadPassMask& passMask,
+                 const ReadMetricsRequest& request);
+
+    /// 是否已计算给定的全部度量
+    [[nodiscard]] auto has(unsigned metrics) const -> bool {
+        return (request_.metrics & metrics) == metrics;
+    }
+
+    /// 是否已按给定阈值计算高质量边界
+    [[nodiscard]] auto hasHighQualityBounds(int qualityTarget) const -> bool {
+        return has(kMetricHighQualityBounds) && request_.qualityTarget == qualityTarget;
+    }
+
+    [[nodiscard]] auto operator[](size_t index) const -> const ReadMetrics& {
+        return values_[index];
+    }
+
+private:
+    const fq::common::ByteKernels* kernels_;
+    ReadMetricsRequest request_;
+    std::vector<ReadMetrics> values_;
+};
+
+}  // namespace fq::processing
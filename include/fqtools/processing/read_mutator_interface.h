@@ -1,5 +1,9 @@
 #pragma once
 #include "fqtools/io/fastq_io.h"
+#include "fqtools/processing/read_predicate_interface.h"
+
+#include <span>
+#include <string>
 
 namespace fq::processing {
 
@@ -7,6 +11,44 @@ class ReadMutatorInterface {
 public:
     virtual ~ReadMutatorInterface() = default;
     virtual void process(fq::io::FastqRecord& read) = 0;
+
+    // 阶段名称，用于 ProcessingStatistics::stages
+    [[nodiscard]] virtual auto getName() const -> std::string {
+        return "ReadMutator";
+    }
+
+    // 批量修改 passMask 中为 1 的 read。默认逐条调用 process()，子类可覆盖。
+    virtual void processBatch(std::span<fq::io::FastqRecord> reads, const ReadPassMask& passMask) {
+        for (size_t i = 0; i < reads.size(); ++i) {
+            if (passMask[i] != 0) {
+                process(reads[i]);
+            }
+        }
+    }
+
+    // 需要的共享度量（见 read_metrics.h），默认不需要
+    [[nodiscard]] virtual auto metricsRequest() const -> ReadMetricsRequest {
+        return {};
+    }
+
+    // 带共享度量的批量修改。度量按修改前的 read 计算，只有第一个修改器会收到。默认忽略度量。
+    virtual void processBatchWithMetrics(std::span<fq::io::FastqRecord> reads,
+                                         const ReadMetricsBatch& metrics,
+                                         const ReadPassMask& passMask) {
+        (void)metrics;
+        processBatch(reads, passMask);
+    }
+
+    // 流水线调用的入口。需要生成新字节的修改器覆盖此函数，把改写后的内容分配在 arena 中，
+    // 并让记录视图指向它；arena 随批次一起重置，不必逐条 read 分配内存。
+    // metrics 只有第一个修改器会收到，其余为空。默认忽略 arena。
+    virtual void processBatchWithArena(std::span<fq::io::FastqRecord> reads,
+                                       const ReadMetricsBatch& metrics,
+                                       const ReadPassMask& passMask,
+                                       fq::io::FastqArena& arena) {
+        (void)arena;
+        processBatchWithMetrics(reads, metrics, passMask);
+    }
 };
 
 }  // namespace fq::processing
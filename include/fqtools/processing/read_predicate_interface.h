@@ -1,6 +1,12 @@
 #pragma once
 
 #include "fqtools/io/fastq_io.h"
+#include "fqtools/processing/read_metrics.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
 
 namespace fq::processing {
 
@@ -8,6 +14,35 @@ class ReadPredicateInterface {
 public:
     virtual ~ReadPredicateInterface() = default;
     virtual auto evaluate(const fq::io::FastqRecord& read) const -> bool = 0;
+
+    // 阶段名称，用于 ProcessingStatistics::stages
+    [[nodiscard]] virtual auto getName() const -> std::string {
+        return "ReadPredicate";
+    }
+
+    // 批量判定：只检查 passMask 中仍为 1 的 read，未通过的置 0。
+    // 默认逐条调用 evaluate()，子类可覆盖为整批的紧凑循环。
+    virtual void evaluateBatch(std::span<const fq::io::FastqRecord> reads,
+                               ReadPassMask& passMask) const {
+        for (size_t i = 0; i < reads.size(); ++i) {
+            if (passMask[i] != 0 && !evaluate(reads[i])) {
+                passMask[i] = 0;
+            }
+        }
+    }
+
+    // 需要的共享度量（见 read_metrics.h），默认不需要
+    [[nodiscard]] virtual auto metricsRequest() const -> ReadMetricsRequest {
+        return {};
+    }
+
+    // 带共享度量的批量判定，metrics 已按各阶段需求合并计算。默认忽略度量。
+    virtual void evaluateBatchWithMetrics(std::span<const fq::io::FastqRecord> reads,
+                                          const ReadMetricsBatch& metrics,
+                                          ReadPassMask& passMask) const {
+        (void)metrics;
+        evaluateBatch(reads, passMask);
+    }
 };
 
 }  // namespace fq::processing
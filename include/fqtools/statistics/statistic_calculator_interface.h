@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace fq::statistic {
 
@@ -34,9 +35,19 @@ struct StatisticOptions {
 
     size_t readChunkBytes = 1 * 1024 * 1024;
     size_t zlibBufferBytes = 128 * 1024;
+    bool speculativeInflate = false;  ///< Parallel speculative decoding of plain gzip input.
+    size_t readAheadBuffers = 0;      ///< Chunks read ahead on a background I/O thread; 0 disables.
+    bool ioUring = false;             ///< Read regular input files through io_uring.
+    size_t shardIndex = 0;            ///< Zero-based input shard to process.
+    size_t shardCount = 1;            ///< Number of input shards; 1 processes the whole file.
     size_t batchCapacityBytes = 4 * 1024 * 1024;
     size_t memoryLimitBytes = 0;
     size_t maxInFlightBatches = 0;
+    size_t batchBytes = 0;       ///< Target bytes per batch; non-zero replaces batchSize.
+    bool adaptiveBatch = false;  ///< Tune batch bytes from measured stage latency.
+
+    /// Binary partial results (.fqs) to merge instead of reading inputFastqPath.
+    std::vector<std::string> mergeInputPaths;
 };
 
 /**
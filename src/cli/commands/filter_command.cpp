@@ -1,5 +1,7 @@
 #include "filter_command.h"
 
+#include "shard_option.h"
+
 #include <iomanip>
 #include <iostream>
 
@@ -37,6 +39,11 @@ auto FilterCommand::execute(int argc, char* argv[]) -> int {
         "batch-size",
         "Batch size (reads per batch)",
         cxxopts::value<size_t>()->default_value("10000"))(
+        "batch-bytes",
+        "Target bytes per batch (0=estimate from --batch-size)",
+        cxxopts::value<size_t>()->default_value("0"))(
+        "adaptive-batch",
+        "Tune bytes per batch from measured read/process/write latency")(
         "read-chunk-bytes",
         "Reader chunk size in bytes",
         cxxopts::value<size_t>()->default_value("1048576"))(
@@ -44,14 +51,32 @@ auto FilterCommand::execute(int argc, char* argv[]) -> int {
         "Batch buffer capacity in bytes",
         cxxopts::value<size_t>()->default_value("4194304"))(
         "zlib-buffer-bytes",
-        "zlib internal buffer size in bytes",
+        "zlib buffer size in bytes for plain gzip input",
         cxxopts::value<size_t>()->default_value("131072"))(
+        "speculative-inflate",
+        "Experimental: decompress plain gzip input in parallel from guessed deflate block boundaries")(
+        "read-ahead",
+        "Read input on a background I/O thread, keeping up to N chunks ahead (0=off)",
+        cxxopts::value<size_t>()->default_value("0"))(
+        "io-uring",
+        "Use io_uring for uncompressed input and output files (falls back to read/write)")(
+        "shard",
+        "Process only shard i of N (0-based, e.g. 0/4); plain or indexed BGZF input",
+        cxxopts::value<std::string>())(
         "writer-buffer-bytes",
         "Writer buffer size in bytes",
         cxxopts::value<size_t>()->default_value("131072"))(
+        "compression-level",
+        "gzip output compression level (0-12)",
+        cxxopts::value<int>()->default_value("6"))(
+        "compression-threads",
+        "gzip output compression threads (0=same as --threads)",
+        cxxopts::value<size_t>()->default_value("0"))(
         "in-flight",
         "Max in-flight batches (0=auto)",
         cxxopts::value<size_t>()->default_value("0"))(
+        "unordered",
+        "Write batches as they finish instead of in input order (with --threads > 1)")(
         "memory-limit-gb",
         "Memory limit (GB) for in-flight batches (0=unlimited)",
         cxxopts::value<size_t>()->default_value("10"))("quality-encoding",
@@ -97,11 +122,24 @@ auto FilterCommand::execute(int argc, char* argv[]) -> int {
     fq::processing::ProcessingConfig pipelineConfig;
     pipelineConfig.threadCount = config_->threadCount;
     pipelineConfig.batchSize = result["batch-size"].as<size_t>();
+    pipelineConfig.batchBytes = result["batch-bytes"].as<size_t>();
+    pipelineConfig.adaptiveBatch = result.count("adaptive-batch") > 0;
     pipelineConfig.readChunkBytes = result["read-chunk-bytes"].as<size_t>();
     pipelineConfig.batchCapacityBytes = result["batch-capacity-bytes"].as<size_t>();
     pipelineConfig.zlibBufferBytes = result["zlib-buffer-bytes"].as<size_t>();
+    pipelineConfig.speculativeInflate = result.count("speculative-inflate") > 0;
+    pipelineConfig.readAheadBuffers = result["read-ahead"].as<size_t>();
+    pipelineConfig.ioUring = result.count("io-uring") > 0;
+    if (result.count("shard")) {
+        const auto shard = parseShardSpec(result["shard"].as<std::string>());
+        pipelineConfig.shardIndex = shard.index;
+        pipelineConfig.shardCount = shard.count;
+    }
     pipelineConfig.writerBufferBytes = result["writer-buffer-bytes"].as<size_t>();
+    pipelineConfig.compressionLevel = result["compression-level"].as<int>();
+    pipelineConfig.compressionThreads = result["compression-threads"].as<size_t>();
     pipelineConfig.maxInFlightBatches = result["in-flight"].as<size_t>();
+    pipelineConfig.unorderedOutput = result.count("unordered") > 0;
     const size_t memGb = result["memory-limit-gb"].as<size_t>();
     pipelineConfig.memoryLimitBytes =
         memGb == 0 ? 0 : (memGb * 1024ULL * 1024ULL * 1024ULL);
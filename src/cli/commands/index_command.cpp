@@ -0,0 +1,62 @@
+#include "index_command.h"
+
+#include <iostream>
+
+#include <cxxopts.hpp>
+
+#include <fqtools/io/fastq_index.h>
+
+namespace fq::cli::commands {
+
+auto IndexCommand::execute(int argc, char* argv[]) -> int {
+    cxxopts::Options options(getName(), getDescription());
+    options.add_options()("i,input", "Input FASTQ file (plain or BGZF)", cxxopts::value<std::string>())(
+        "o,output", "Output index file (default: <input>.fqi)", cxxopts::value<std::string>())(
+        "interval",
+        "Records between checkpoints",
+        cxxopts::value<uint64_t>()->default_value("10000"))("h,help", "Print usage");
+
+    if (argc == 1) {
+        std::cout << options.help() << std::endl;
+        return 0;
+    }
+
+    auto result = options.parse(argc, argv);
+
+    if (result.count("help")) {
+        std::cout << options.help() << std::endl;
+        return 0;
+    }
+
+    if (!result.count("input")) {
+        std::cerr << "Error: --input is required for the index command." << std::endl;
+        std::cerr << options.help() << std::endl;
+        return 1;
+    }
+
+    const auto inputPath = result["input"].as<std::string>();
+    const auto outputPath = result.count("output") ? result["output"].as<std::string>()
+                                                   : fq::io::FastqIndex::defaultPath(inputPath);
+
+    try {
+        const auto index = fq::io::FastqIndex::build(inputPath, result["interval"].as<uint64_t>());
+        index.save(outputPath);
+        std::cout << "Indexed " << index.totalRecords() << " records ("
+                  << index.entries().size() << " checkpoints) -> " << outputPath << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+auto IndexCommand::getName() const -> std::string {
+    return "index";
+}
+
+auto IndexCommand::getDescription() const -> std::string {
+    return "Build a record index (.fqi) for a FASTQ file";
+}
+
+}  // namespace fq::cli::commands
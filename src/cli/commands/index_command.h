@@ -0,0 +1,43 @@
+/**
+ * @file index_command.h
+ * @brief 定义了 'index' 子命令。
+ * @author LessUp
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 LessUp
+ */
+
+#pragma once
+#include "commands/command_interface.h"
+
+namespace fq::cli::commands {
+
+/**
+ * @brief 实现了为 FastQ 文件建立记录索引（.fqi）的 'index' 命令。
+ */
+class IndexCommand : public fq::cli::CommandInterface {
+public:
+    /**
+     * @brief 执行索引命令
+     * @details 扫描输入文件，按固定记录间隔写出检查点
+     *
+     * @param argc 参数数量
+     * @param argv 参数数组
+     * @return 执行成功返回0，失败返回非0值
+     */
+    auto execute(int argc, char* argv[]) -> int override;
+
+    /**
+     * @brief 获取命令名称
+     * @return 返回命令名称字符串 "index"
+     */
+    [[nodiscard]] auto getName() const -> std::string override;
+
+    /**
+     * @brief 获取命令描述
+     * @return 返回命令功能的描述字符串
+     */
+    [[nodiscard]] auto getDescription() const -> std::string override;
+};
+
+}  // namespace fq::cli::commands
@@ -0,0 +1,79 @@
+#include "merge_command.h"
+
+#include <iostream>
+
+#include <cxxopts.hpp>
+
+#include <fqtools/io/fastq_merge.h>
+
+namespace fq::cli::commands {
+
+auto MergeCommand::execute(int argc, char* argv[]) -> int {
+    cxxopts::Options options(getName(), getDescription());
+    options.add_options()("o,output", "Output FASTQ file", cxxopts::value<std::string>())(
+        "t,threads",
+        "Compression threads when re-encoding gzip output",
+        cxxopts::value<size_t>()->default_value("1"))(
+        "decompression-threads",
+        "Decompression threads when re-reading BGZF inputs (0 = all cores)",
+        cxxopts::value<size_t>()->default_value("1"))(
+        "compression-level",
+        "gzip output compression level (0-12)",
+        cxxopts::value<int>()->default_value("6"))(
+        "inputs", "Input FASTQ files, in order", cxxopts::value<std::vector<std::string>>())(
+        "h,help", "Print usage");
+    options.parse_positional({"inputs"});
+    options.positional_help("<input>...");
+
+    // argv[0] 为程序名，argv[1] 为子命令名
+    if (argc <= 2) {
+        std::cout << options.help() << std::endl;
+        return 0;
+    }
+
+    // 从子命令名开始解析：它占据程序名的位置被跳过，不会成为位置参数
+    auto result = options.parse(argc - 1, argv + 1);
+
+    if (result.count("help")) {
+        std::cout << options.help() << std::endl;
+        return 0;
+    }
+
+    if (!result.count("output") || !result.count("inputs")) {
+        std::cerr << "Error: --output and at least one input are required for the merge command."
+                  << std::endl;
+        std::cerr << options.help() << std::endl;
+        return 1;
+    }
+
+    const auto outputPath = result["output"].as<std::string>();
+    const auto inputs = result["inputs"].as<std::vector<std::string>>();
+
+    fq::io::FastqWriterOptions writerOptions;
+    writerOptions.compressionLevel = result["compression-level"].as<int>();
+    writerOptions.compressionThreads = result["threads"].as<size_t>();
+    fq::io::FastqReaderOptions readerOptions;
+    readerOptions.decompressionThreads = result["decompression-threads"].as<size_t>();
+
+    try {
+        const bool concatenated =
+            fq::io::mergeFastqFiles(inputs, outputPath, writerOptions, readerOptions);
+        std::cout << "Merged " << inputs.size() << " files -> " << outputPath
+                  << (concatenated ? " (concatenated)" : " (re-encoded)") << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+auto MergeCommand::getName() const -> std::string {
+    return "merge";
+}
+
+auto MergeCommand::getDescription() const -> std::string {
+    return "Merge FASTQ files (e.g. shard outputs) in order";
+}
+
+}  // namespace fq::cli::commands
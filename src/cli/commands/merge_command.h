@@ -0,0 +1,43 @@
+/**
+ * @file merge_command.h
+ * @brief 定义了 'merge' 子命令。
+ * @author LessUp
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 LessUp
+ */
+
+#pragma once
+#include "commands/command_interface.h"
+
+namespace fq::cli::commands {
+
+/**
+ * @brief 实现了按顺序合并多个 FastQ 文件（例如分片输出）的 'merge' 命令。
+ */
+class MergeCommand : public fq::cli::CommandInterface {
+public:
+    /**
+     * @brief 执行合并命令
+     * @details 格式一致时直接拼接，否则逐条重写
+     *
+     * @param argc 参数数量
+     * @param argv 参数数组
+     * @return 执行成功返回0，失败返回非0值
+     */
+    auto execute(int argc, char* argv[]) -> int override;
+
+    /**
+     * @brief 获取命令名称
+     * @return 返回命令名称字符串 "merge"
+     */
+    [[nodiscard]] auto getName() const -> std::string override;
+
+    /**
+     * @brief 获取命令描述
+     * @return 返回命令功能的描述字符串
+     */
+    [[nodiscard]] auto getDescription() const -> std::string override;
+};
+
+}  // namespace fq::cli::commands
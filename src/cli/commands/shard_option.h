@@ -0,0 +1,51 @@
+/**
+ * @file shard_option.h
+ * @brief 解析 stat/filter 共用的 --shard i/N 选项。
+ * @author LessUp
+ * @version 1.0
+ * @date 2026-10-17
+ * @copyright Copyright (c) 2026 LessUp
+ */
+
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace fq::cli::commands {
+
+/**
+ * @brief 输入分片：第 index 片（从 0 开始），共 count 片
+ */
+struct ShardSpec {
+    size_t index = 0;
+    size_t count = 1;
+};
+
+/**
+ * @brief 解析形如 "2/8" 的分片描述
+ * @throw std::runtime_error 格式错误或 index 不小于 count
+ */
+inline auto parseShardSpec(const std::string& text) -> ShardSpec {
+    const auto slash = text.find('/');
+    auto parsePart = [&](std::string_view part, size_t& value) {
+        const auto* end = part.data() + part.size();
+        const auto [ptr, ec] = std::from_chars(part.data(), end, value);
+        return !part.empty() && ec == std::errc() && ptr == end;
+    };
+
+    ShardSpec spec;
+    const std::string_view view(text);
+    if (slash == std::string::npos || !parsePart(view.substr(0, slash), spec.index) ||
+        !parsePart(view.substr(slash + 1), spec.count) || spec.count == 0 ||
+        spec.index >= spec.count) {
+        throw std::runtime_error("Invalid --shard '" + text +
+                                 "': expected i/N with 0 <= i < N, e.g. 0/4");
+    }
+    return spec;
+}
+
+}  // namespace fq::cli::commands
@@ -1,6 +1,10 @@
 #include "stat_command.h"
 
+#include "shard_option.h"
+
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include <cxxopts.hpp>
 
@@ -11,11 +15,19 @@ namespace fq::cli::commands {
 auto StatCommand::execute(int argc, char* argv[]) -> int {
     cxxopts::Options options(getName(), getDescription());
     options.add_options()("i,input", "Input FASTQ file", cxxopts::value<std::string>())(
-        "o,output", "Output statistics file", cxxopts::value<std::string>())(
+        "o,output",
+        "Output statistics file (a .fqs path writes a mergeable binary partial)",
+        cxxopts::value<std::string>())(
+        "merge", "Merge .fqs partials given as positional arguments instead of reading --input")(
         "t,threads", "Number of threads", cxxopts::value<size_t>()->default_value("1"))(
         "batch-size",
         "Batch size (reads per batch)",
         cxxopts::value<size_t>()->default_value("50000"))(
+        "batch-bytes",
+        "Target bytes per batch (0=estimate from --batch-size)",
+        cxxopts::value<size_t>()->default_value("0"))(
+        "adaptive-batch",
+        "Tune bytes per batch from measured read/process latency")(
         "read-chunk-bytes",
         "Reader chunk size in bytes",
         cxxopts::value<size_t>()->default_value("1048576"))(
@@ -25,12 +37,25 @@ auto StatCommand::execute(int argc, char* argv[]) -> int {
         "zlib-buffer-bytes",
         "zlib internal buffer size in bytes",
         cxxopts::value<size_t>()->default_value("131072"))(
+        "speculative-inflate",
+        "Experimental: decompress plain gzip input in parallel from guessed deflate block boundaries")(
+        "read-ahead",
+        "Read input on a background I/O thread, keeping up to N chunks ahead (0=off)",
+        cxxopts::value<size_t>()->default_value("0"))(
+        "io-uring",
+        "Use io_uring for uncompressed input files (falls back to read)")(
+        "shard",
+        "Process only shard i of N (0-based, e.g. 0/4); plain or indexed BGZF input",
+        cxxopts::value<std::string>())(
         "in-flight",
         "Max in-flight batches (0=auto)",
         cxxopts::value<size_t>()->default_value("0"))(
         "memory-limit-gb",
         "Memory limit (GB) for in-flight batches (0=unlimited)",
-        cxxopts::value<size_t>()->default_value("10"))("h,help", "Print usage");
+        cxxopts::value<size_t>()->default_value("10"))(
+        "partials", "Statistics partials to merge", cxxopts::value<std::vector<std::string>>())(
+        "h,help", "Print usage");
+    options.parse_positional({"partials"});
 
     if (argc == 1) {
         std::cout << options.help() << std::endl;
@@ -44,7 +69,23 @@ auto StatCommand::execute(int argc, char* argv[]) -> int {
         return 0;
     }
 
-    if (!result.count("input") || !result.count("output")) {
+    std::vector<std::string> partials;
+    if (result.count("partials")) {
+        partials = result["partials"].as<std::vector<std::string>>();
+        // main 传入的参数保留了子命令名，它会被当作第一个位置参数
+        if (!partials.empty() && partials.front() == getName()) {
+            partials.erase(partials.begin());
+        }
+    }
+
+    const bool mergeMode = result.count("merge") > 0;
+    if (mergeMode && (partials.empty() || !result.count("output"))) {
+        std::cerr << "Error: --merge requires --output and at least one .fqs partial."
+                  << std::endl;
+        std::cerr << options.help() << std::endl;
+        return 1;
+    }
+    if (!mergeMode && (!result.count("input") || !result.count("output"))) {
         std::cerr << "Error: both --input and --output options are required for the stat command."
                   << std::endl;
         std::cerr << options.help() << std::endl;
@@ -53,18 +94,33 @@ auto StatCommand::execute(int argc, char* argv[]) -> int {
 
     // Use the interface-level options struct
     fq::statistic::StatisticOptions statOptions;
-    statOptions.inputFastqPath = result["input"].as<std::string>();
+    if (mergeMode) {
+        statOptions.mergeInputPaths = std::move(partials);
+    } else {
+        statOptions.inputFastqPath = result["input"].as<std::string>();
+    }
     statOptions.outputStatPath = result["output"].as<std::string>();
     statOptions.threadCount = static_cast<uint32_t>(result["threads"].as<size_t>());
     statOptions.batchSize = static_cast<uint32_t>(result["batch-size"].as<size_t>());
+    statOptions.batchBytes = result["batch-bytes"].as<size_t>();
+    statOptions.adaptiveBatch = result.count("adaptive-batch") > 0;
     statOptions.readChunkBytes = result["read-chunk-bytes"].as<size_t>();
     statOptions.batchCapacityBytes = result["batch-capacity-bytes"].as<size_t>();
     statOptions.zlibBufferBytes = result["zlib-buffer-bytes"].as<size_t>();
+    statOptions.speculativeInflate = result.count("speculative-inflate") > 0;
+    statOptions.readAheadBuffers = result["read-ahead"].as<size_t>();
+    statOptions.ioUring = result.count("io-uring") > 0;
     statOptions.maxInFlightBatches = result["in-flight"].as<size_t>();
     const size_t memGb = result["memory-limit-gb"].as<size_t>();
     statOptions.memoryLimitBytes = memGb == 0 ? 0 : (memGb * 1024ULL * 1024ULL * 1024ULL);
 
     try {
+        if (result.count("shard")) {
+            const auto shard = parseShardSpec(result["shard"].as<std::string>());
+            statOptions.shardIndex = shard.index;
+            statOptions.shardCount = shard.count;
+        }
+
         // Use the factory to create an instance of the calculator
         auto stater = fq::statistic::createStatisticCalculator(statOptions);
 
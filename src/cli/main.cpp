@@ -18,6 +18,8 @@
 #include <fqtools/logging.h>
 #include "commands/command_interface.h"
 #include "commands/filter_command.h"
+#include "commands/index_command.h"
+#include "commands/merge_command.h"
 #include "commands/stat_command.h"
 
 namespace fq::cli {
@@ -33,8 +35,9 @@ void printGlobalHelp(const std::map<std::string, CommandPtr>& commands);
  * @return 程序执行状态码，0 表示成功，非0表示异常
  */
 auto main(int argc, char* argv[]) -> int {
-    // 解析全局选项（--verbose, --quiet, --log-level）
+    // 解析全局选项（--verbose, --quiet, --log-level, --simd）
     std::string logLevel = "info";
+    std::string simdLevel;
 
     // 构建子命令参数列表（过滤掉全局选项）
     std::vector<char*> subArgs;
@@ -51,6 +54,8 @@ auto main(int argc, char* argv[]) -> int {
             logLevel = "error";
         } else if (arg.starts_with("--log-level=")) {
             logLevel = arg.substr(12);
+        } else if (arg.starts_with("--simd=")) {
+            simdLevel = arg.substr(7);
         } else if (arg == "--help" || arg == "-h") {
             // 全局帮助
             if (!foundSubcommand) {
@@ -58,6 +63,8 @@ auto main(int argc, char* argv[]) -> int {
                 std::map<std::string, fq::cli::CommandPtr> commands;
                 commands["stat"] = std::make_unique<fq::cli::commands::StatCommand>();
                 commands["filter"] = std::make_unique<fq::cli::commands::FilterCommand>();
+                commands["index"] = std::make_unique<fq::cli::commands::IndexCommand>();
+                commands["merge"] = std::make_unique<fq::cli::commands::MergeCommand>();
                 fq::cli::printGlobalHelp(commands);
                 return 0;
             }
@@ -74,16 +81,31 @@ auto main(int argc, char* argv[]) -> int {
     // 初始化日志
     fq::logging::setLevel(logLevel);
 
+    // 必须在创建任何使用 SIMD 内核的对象之前确定级别
+    if (!simdLevel.empty()) {
+        try {
+            fq::common::setSimdLevel(fq::common::parseSimdLevel(simdLevel));
+        } catch (const std::exception& e) {
+            fq::logging::error("{}", e.what());
+            return 1;
+        }
+    }
+
     // 打印项目 Logo
     fq::common::printLogo();
 
     // 启动主计时器
     fq::common::Timer mainTimer("FastQTools");
+    fq::logging::debug("SIMD level: {} (cpu supports {})",
+                       fq::common::simdLevelName(fq::common::activeSimdLevel()),
+                       fq::common::simdLevelName(fq::common::detectSimdLevel()));
 
     // 注册支持的子命令
     std::map<std::string, fq::cli::CommandPtr> commands;
     commands["stat"] = std::make_unique<fq::cli::commands::StatCommand>();
     commands["filter"] = std::make_unique<fq::cli::commands::FilterCommand>();
+    commands["index"] = std::make_unique<fq::cli::commands::IndexCommand>();
+    commands["merge"] = std::make_unique<fq::cli::commands::MergeCommand>();
 
     // 检查是否有子命令
     if (!foundSubcommand) {
@@ -120,7 +142,8 @@ auto printGlobalHelp(const std::map<std::string, CommandPtr>& commands) -> void
               << "Global options:\n"
               << "  -v, --verbose        Enable verbose/debug output\n"
               << "  -q, --quiet          Suppress non-error output\n"
-              << "  --log-level=LEVEL    Set log level (trace,debug,info,warn,error)\n\n"
+              << "  --log-level=LEVEL    Set log level (trace,debug,info,warn,error)\n"
+              << "  --simd=LEVEL         Cap SIMD kernels (auto,scalar,sse4.2,avx2,avx512)\n\n"
               << "Available commands:\n";
     for (const auto& [name, command] : commands) {
         std::cout << "  " << name << "\t\t" << command->getDescription() << "\n";
@@ -0,0 +1,73 @@
+#include "fqtools/common/batch_sizer.h"
+
+#include <algorithm>
+
+namespace fq::common {
+
+namespace {
+
+// 滑动平均的权重：新样本占 1/4，几批之内跟上 read 长度或压缩率的变化
+constexpr double kSmoothing = 0.25;
+
+void smooth(double& average, double sample) {
+    average = average == 0.0 ? sample : average + kSmoothing * (sample - average);
+}
+
+}  // namespace
+
+AdaptiveBatchSizer::AdaptiveBatchSizer(const AdaptiveBatchOptions& options)
+    : options_(options), batchBytes_(0) {
+    options_.minBytes = std::max<size_t>(1, options_.minBytes);
+    options_.maxBytes = std::max(options_.minBytes, options_.maxBytes);
+    options_.workers = std::max<size_t>(1, options_.workers);
+    batchBytes_.store(std::clamp(options_.initialBytes, options_.minBytes, options_.maxBytes),
+                      std::memory_order_relaxed);
+}
+
+void AdaptiveBatchSizer::record(BatchStage stage,
+                                size_t bytes,
+                                std::chrono::nanoseconds elapsed) {
+    if (bytes == 0) {
+        return;
+    }
+    const double nsPerByte = static_cast<double>(elapsed.count()) / static_cast<double>(bytes);
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+    switch (stage) {
+        case BatchStage::Read:
+            smooth(readNsPerByte_, nsPerByte);
+            break;
+        case BatchStage::Process:
+            smooth(processNsPerByte_, nsPerByte);
+            update();
+            break;
+        case BatchStage::Write:
+            smooth(writeNsPerByte_, nsPerByte);
+            break;
+    }
+}
+
+void AdaptiveBatchSizer::update() {
+    if (processNsPerByte_ <= 0.0) {
+        return;
+    }
+    const size_t current = batchBytes_.load(std::memory_order_relaxed);
+
+    // 并行阶段为瓶颈：每批处理耗时接近目标
+    auto desired = static_cast<double>(options_.targetLatency.count()) / processNsPerByte_;
+
+    // 串行阶段每交付一批的耗时超过 workers 个线程消化一批的耗时，并行阶段喂不饱；
+    // 缩小批次无济于事，增大批次可以摊薄每批的调度与系统调用开销
+    const double serialNsPerByte = std::max(readNsPerByte_, writeNsPerByte_);
+    if (serialNsPerByte * static_cast<double>(options_.workers) > processNsPerByte_) {
+        desired = std::max(desired, static_cast<double>(current) * 2.0);
+    }
+
+    desired = std::clamp(desired, static_cast<double>(current) / 2.0,
+                         static_cast<double>(current) * 2.0);
+    desired = std::clamp(desired, static_cast<double>(options_.minBytes),
+                         static_cast<double>(options_.maxBytes));
+    batchBytes_.store(static_cast<size_t>(desired), std::memory_order_relaxed);
+}
+
+}  // namespace fq::common
@@ -0,0 +1,526 @@
+#include "fqtools/common/simd.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+// 只在 x86-64 上启用：部分内核使用 _mm_cvtsi128_si64 等仅 64 位可用的指令，32 位 x86 走标量实现
+#if defined(__x86_64__)
+#define FQ_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace fq::common {
+
+namespace {
+
+constexpr std::array<std::string_view, 4> kLevelNames = {"scalar", "sse4.2", "avx2", "avx512"};
+
+std::atomic<SimdLevel> gLevelCap{SimdLevel::Avx512};
+
+// 阈值超出有符号 char 范围时结果与数据无关
+enum class ThresholdRange : std::uint8_t {
+    All,
+    None,
+    Normal,
+};
+
+inline auto classifyThreshold(int threshold) -> ThresholdRange {
+    if (threshold <= -128) {
+        return ThresholdRange::All;
+    }
+    if (threshold > 127) {
+        return ThresholdRange::None;
+    }
+    return ThresholdRange::Normal;
+}
+
+auto findFirstAtLeastScalar(const char* data, size_t size, int threshold) -> size_t {
+    for (size_t i = 0; i < size; ++i) {
+        if (static_cast<int>(data[i]) >= threshold) {
+            return i;
+        }
+    }
+    return size;
+}
+
+auto findLastAtLeastScalar(const char* data, size_t size, int threshold) -> size_t {
+    for (size_t i = size; i > 0; --i) {
+        if (static_cast<int>(data[i - 1]) >= threshold) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+auto sumScalar(const char* data, size_t size) -> int64_t {
+    int64_t total = 0;
+    for (size_t i = 0; i < size; ++i) {
+        total += static_cast<int>(data[i]);
+    }
+    return total;
+}
+
+auto countLetterScalar(const char* data, size_t size, char lowerLetter) -> size_t {
+    size_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        count += static_cast<char>(data[i] | 0x20) == lowerLetter ? 1 : 0;
+    }
+    return count;
+}
+
+auto countGcScalar(const char* data, size_t size) -> size_t {
+    size_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        const auto lower = static_cast<char>(data[i] | 0x20);
+        count += (lower == 'g' || lower == 'c') ? 1 : 0;
+    }
+    return count;
+}
+
+// 8 字节中等于 target 的字节，按字节序收成 8 位（SWAR，无需逐字节分支）
+inline auto matchBits8(uint64_t word, uint64_t target) -> uint64_t {
+    constexpr uint64_t kLow7 = 0x7f7f7f7f7f7f7f7fULL;
+    const uint64_t x = word ^ target;
+    // 字节为 0 时其最高位为 1，其余为 0（精确判定，不会受相邻字节进位影响）
+    const uint64_t zero = ~(((x & kLow7) + kLow7) | x | kLow7);
+    return ((zero >> 7) * 0x0102040810204080ULL) >> 56;
+}
+
+void structuralMasksScalar(const char* data,
+                           size_t blocks,
+                           uint64_t* newlines,
+                           uint64_t* separators) {
+    constexpr uint64_t kNewline = 0x0a0a0a0a0a0a0a0aULL;
+    constexpr uint64_t kSpace = 0x2020202020202020ULL;
+    constexpr uint64_t kTab = 0x0909090909090909ULL;
+    for (size_t k = 0; k < blocks; ++k) {
+        uint64_t nl = 0;
+        uint64_t sep = 0;
+        for (unsigned part = 0; part < 8; ++part) {
+            uint64_t word = 0;
+            std::memcpy(&word, data + k * 64 + part * 8, sizeof(word));
+            if constexpr (std::endian::native == std::endian::big) {
+                word = __builtin_bswap64(word);
+            }
+            nl |= matchBits8(word, kNewline) << (part * 8);
+            sep |= (matchBits8(word, kSpace) | matchBits8(word, kTab)) << (part * 8);
+        }
+        newlines[k] = nl;
+        separators[k] = sep;
+    }
+}
+
+constexpr ByteKernels kScalarKernels = {&findFirstAtLeastScalar,
+                                        &findLastAtLeastScalar,
+                                        &sumScalar,
+                                        &countLetterScalar,
+                                        &countGcScalar,
+                                        &structuralMasksScalar};
+
+#ifdef FQ_SIMD_X86
+
+// 求和时先异或 0x80 把有符号字节平移为无符号（+128），psadbw 累加后再减去偏移
+
+__attribute__((target("sse4.2"))) auto findFirstAtLeastSse42(const char* data, size_t size,
+                                                             int threshold) -> size_t {
+    const auto range = classifyThreshold(threshold);
+    if (range != ThresholdRange::Normal) {
+        return range == ThresholdRange::All ? 0 : size;
+    }
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(threshold - 1));
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const int mask = _mm_movemask_epi8(_mm_cmpgt_epi8(chunk, limit));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+    return i + findFirstAtLeastScalar(data + i, size - i, threshold);
+}
+
+__attribute__((target("sse4.2"))) auto findLastAtLeastSse42(const char* data, size_t size,
+                                                            int threshold) -> size_t {
+    const auto range = classifyThreshold(threshold);
+    if (range != ThresholdRange::Normal) {
+        return range == ThresholdRange::All ? size : 0;
+    }
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(threshold - 1));
+    size_t end = size;
+    for (; end >= 16; end -= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + end - 16));
+        const int mask = _mm_movemask_epi8(_mm_cmpgt_epi8(chunk, limit));
+        if (mask != 0) {
+            return end - 16 + static_cast<size_t>(32 - __builtin_clz(static_cast<unsigned>(mask)));
+        }
+    }
+    return findLastAtLeastScalar(data, end, threshold);
+}
+
+__attribute__((target("sse4.2"))) auto sumSse42(const char* data, size_t size) -> int64_t {
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_xor_si128(chunk, bias), zero));
+    }
+    const auto biased = static_cast<int64_t>(static_cast<uint64_t>(_mm_cvtsi128_si64(acc)) +
+                                             static_cast<uint64_t>(_mm_extract_epi64(acc, 1)));
+    return biased - 128 * static_cast<int64_t>(i) + sumScalar(data + i, size - i);
+}
+
+__attribute__((target("sse4.2,popcnt"))) auto countLetterSse42(const char* data, size_t size,
+                                                               char lowerLetter) -> size_t {
+    const __m128i lower = _mm_set1_epi8(0x20);
+    const __m128i letter = _mm_set1_epi8(lowerLetter);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(chunk, lower), letter));
+        count += static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(mask)));
+    }
+    return count + countLetterScalar(data + i, size - i, lowerLetter);
+}
+
+__attribute__((target("sse4.2,popcnt"))) auto countGcSse42(const char* data, size_t size)
+    -> size_t {
+    const __m128i lower = _mm_set1_epi8(0x20);
+    const __m128i g = _mm_set1_epi8('g');
+    const __m128i c = _mm_set1_epi8('c');
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i chunk =
+            _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), lower);
+        const int mask = _mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, g), _mm_cmpeq_epi8(chunk, c)));
+        count += static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(mask)));
+    }
+    return count + countGcScalar(data + i, size - i);
+}
+
+__attribute__((target("sse4.2"))) void structuralMasksSse42(const char* data,
+                                                            size_t blocks,
+                                                            uint64_t* newlines,
+                                                            uint64_t* separators) {
+    const __m128i nl = _mm_set1_epi8('\n');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    for (size_t k = 0; k < blocks; ++k) {
+        uint64_t nlMask = 0;
+        uint64_t sepMask = 0;
+        for (unsigned part = 0; part < 4; ++part) {
+            const __m128i chunk =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + k * 64 + part * 16));
+            const auto n = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, nl)));
+            const auto s = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab))));
+            nlMask |= static_cast<uint64_t>(n) << (part * 16);
+            sepMask |= static_cast<uint64_t>(s) << (part * 16);
+        }
+        newlines[k] = nlMask;
+        separators[k] = sepMask;
+    }
+}
+
+__attribute__((target("avx2"))) auto findFirstAtLeastAvx2(const char* data, size_t size,
+                                                          int threshold) -> size_t {
+    const auto range = classifyThreshold(threshold);
+    if (range != ThresholdRange::Normal) {
+        return range == ThresholdRange::All ? 0 : size;
+    }
+    const __m256i limit = _mm256_set1_epi8(static_cast<char>(threshold - 1));
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(chunk, limit)));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+    return i + findFirstAtLeastSse42(data + i, size - i, threshold);
+}
+
+__attribute__((target("avx2"))) auto findLastAtLeastAvx2(const char* data, size_t size,
+                                                         int threshold) -> size_t {
+    const auto range = classifyThreshold(threshold);
+    if (range != ThresholdRange::Normal) {
+        return range == ThresholdRange::All ? size : 0;
+    }
+    const __m256i limit = _mm256_set1_epi8(static_cast<char>(threshold - 1));
+    size_t end = size;
+    for (; end >= 32; end -= 32) {
+        const __m256i chunk =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + end - 32));
+        const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(chunk, limit)));
+        if (mask != 0) {
+            return end - 32 + static_cast<size_t>(32 - __builtin_clz(mask));
+        }
+    }
+    return findLastAtLeastSse42(data, end, threshold);
+}
+
+__attribute__((target("avx2"))) auto sumAvx2(const char* data, size_t size) -> int64_t {
+    const __m256i bias = _mm256_set1_epi8(static_cast<char>(0x80));
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc = zero;
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_xor_si256(chunk, bias), zero));
+    }
+    alignas(32) std::array<uint64_t, 4> lanes{};
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes.data()), acc);
+    const auto biased = static_cast<int64_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    return biased - 128 * static_cast<int64_t>(i) + sumSse42(data + i, size - i);
+}
+
+__attribute__((target("avx2,popcnt"))) auto countLetterAvx2(const char* data, size_t size,
+                                                            char lowerLetter) -> size_t {
+    const __m256i lower = _mm256_set1_epi8(0x20);
+    const __m256i letter = _mm256_set1_epi8(lowerLetter);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const auto mask = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_or_si256(chunk, lower), letter)));
+        count += static_cast<size_t>(__builtin_popcount(mask));
+    }
+    return count + countLetterSse42(data + i, size - i, lowerLetter);
+}
+
+__attribute__((target("avx2,popcnt"))) auto countGcAvx2(const char* data, size_t size)
+    -> size_t {
+    const __m256i lower = _mm256_set1_epi8(0x20);
+    const __m256i g = _mm256_set1_epi8('g');
+    const __m256i c = _mm256_set1_epi8('c');
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i chunk = _mm256_or_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), lower);
+        const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, g), _mm256_cmpeq_epi8(chunk, c))));
+        count += static_cast<size_t>(__builtin_popcount(mask));
+    }
+    return count + countGcSse42(data + i, size - i);
+}
+
+__attribute__((target("avx2"))) void structuralMasksAvx2(const char* data,
+                                                         size_t blocks,
+                                                         uint64_t* newlines,
+                                                         uint64_t* separators) {
+    const __m256i nl = _mm256_set1_epi8('\n');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    for (size_t k = 0; k < blocks; ++k) {
+        const char* block = data + k * 64;
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+        const auto nlLo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, nl)));
+        const auto nlHi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, nl)));
+        const auto sepLo = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(lo, space), _mm256_cmpeq_epi8(lo, tab))));
+        const auto sepHi = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(hi, space), _mm256_cmpeq_epi8(hi, tab))));
+        newlines[k] = static_cast<uint64_t>(nlLo) | (static_cast<uint64_t>(nlHi) << 32);
+        separators[k] = static_cast<uint64_t>(sepLo) | (static_cast<uint64_t>(sepHi) << 32);
+    }
+}
+
+__attribute__((target("avx512f,avx512bw"))) auto findFirstAtLeastAvx512(const char* data,
+                                                                        size_t size,
+                                                                        int threshold) -> size_t {
+    const auto range = classifyThreshold(threshold);
+    if (range != ThresholdRange::Normal) {
+        return range == ThresholdRange::All ? 0 : size;
+    }
+    const __m512i limit = _mm512_set1_epi8(static_cast<char>(threshold - 1));
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        const __m512i chunk = _mm512_loadu_si512(data + i);
+        const __mmask64 mask = _mm512_cmpgt_epi8_mask(chunk, limit);
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctzll(mask));
+        }
+    }
+    return i + findFirstAtLeastAvx2(data + i, size - i, threshold);
+}
+
+__attribute__((target("avx512f,avx512bw"))) auto findLastAtLeastAvx512(const char* data,
+                                                                       size_t size,
+                                                                       int threshold) -> size_t {
+    const auto range = classifyThreshold(threshold);
+    if (range != ThresholdRange::Normal) {
+        return range == ThresholdRange::All ? size : 0;
+    }
+    const __m512i limit = _mm512_set1_epi8(static_cast<char>(threshold - 1));
+    size_t end = size;
+    for (; end >= 64; end -= 64) {
+        const __m512i chunk = _mm512_loadu_si512(data + end - 64);
+        const __mmask64 mask = _mm512_cmpgt_epi8_mask(chunk, limit);
+        if (mask != 0) {
+            return end - 64 + static_cast<size_t>(64 - __builtin_clzll(mask));
+        }
+    }
+    return findLastAtLeastAvx2(data, end, threshold);
+}
+
+__attribute__((target("avx512f,avx512bw"))) auto sumAvx512(const char* data, size_t size)
+    -> int64_t {
+    const __m512i bias = _mm512_set1_epi8(static_cast<char>(0x80));
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i acc = zero;
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        const __m512i chunk = _mm512_loadu_si512(data + i);
+        acc = _mm512_add_epi64(acc, _mm512_sad_epu8(_mm512_xor_si512(chunk, bias), zero));
+    }
+    alignas(64) std::array<uint64_t, 8> lanes{};
+    _mm512_store_si512(lanes.data(), acc);
+    uint64_t lanesTotal = 0;
+    for (const uint64_t lane : lanes) {
+        lanesTotal += lane;
+    }
+    const auto biased = static_cast<int64_t>(lanesTotal);
+    return biased - 128 * static_cast<int64_t>(i) + sumAvx2(data + i, size - i);
+}
+
+__attribute__((target("avx512f,avx512bw,popcnt"))) auto countLetterAvx512(const char* data,
+                                                                          size_t size,
+                                                                          char lowerLetter)
+    -> size_t {
+    const __m512i lower = _mm512_set1_epi8(0x20);
+    const __m512i letter = _mm512_set1_epi8(lowerLetter);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        const __m512i chunk = _mm512_loadu_si512(data + i);
+        const __mmask64 mask = _mm512_cmpeq_epi8_mask(_mm512_or_si512(chunk, lower), letter);
+        count += static_cast<size_t>(__builtin_popcountll(mask));
+    }
+    return count + countLetterAvx2(data + i, size - i, lowerLetter);
+}
+
+__attribute__((target("avx512f,avx512bw,popcnt"))) auto countGcAvx512(const char* data,
+                                                                      size_t size) -> size_t {
+    const __m512i lower = _mm512_set1_epi8(0x20);
+    const __m512i g = _mm512_set1_epi8('g');
+    const __m512i c = _mm512_set1_epi8('c');
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        const __m512i chunk = _mm512_or_si512(_mm512_loadu_si512(data + i), lower);
+        const __mmask64 mask =
+            _mm512_cmpeq_epi8_mask(chunk, g) | _mm512_cmpeq_epi8_mask(chunk, c);
+        count += static_cast<size_t>(__builtin_popcountll(mask));
+    }
+    return count + countGcAvx2(data + i, size - i);
+}
+
+__attribute__((target("avx512f,avx512bw"))) void structuralMasksAvx512(const char* data,
+                                                                      size_t blocks,
+                                                                      uint64_t* newlines,
+                                                                      uint64_t* separators) {
+    const __m512i nl = _mm512_set1_epi8('\n');
+    const __m512i space = _mm512_set1_epi8(' ');
+    const __m512i tab = _mm512_set1_epi8('\t');
+    for (size_t k = 0; k < blocks; ++k) {
+        const __m512i chunk = _mm512_loadu_si512(data + k * 64);
+        newlines[k] = _mm512_cmpeq_epi8_mask(chunk, nl);
+        separators[k] = _mm512_cmpeq_epi8_mask(chunk, space) | _mm512_cmpeq_epi8_mask(chunk, tab);
+    }
+}
+
+constexpr ByteKernels kSse42Kernels = {&findFirstAtLeastSse42,
+                                       &findLastAtLeastSse42,
+                                       &sumSse42,
+                                       &countLetterSse42,
+                                       &countGcSse42,
+                                       &structuralMasksSse42};
+constexpr ByteKernels kAvx2Kernels = {&findFirstAtLeastAvx2,
+                                      &findLastAtLeastAvx2,
+                                      &sumAvx2,
+                                      &countLetterAvx2,
+                                      &countGcAvx2,
+                                      &structuralMasksAvx2};
+constexpr ByteKernels kAvx512Kernels = {&findFirstAtLeastAvx512,
+                                        &findLastAtLeastAvx512,
+                                        &sumAvx512,
+                                        &countLetterAvx512,
+                                        &countGcAvx512,
+                                        &structuralMasksAvx512};
+
+#endif  // FQ_SIMD_X86
+
+}  // namespace
+
+auto detectSimdLevel() -> SimdLevel {
+    static const SimdLevel detected = [] {
+#ifdef FQ_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+            return SimdLevel::Avx512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::Avx2;
+        }
+        if (__builtin_cpu_supports("sse4.2")) {
+            return SimdLevel::Sse42;
+        }
+#endif
+        return SimdLevel::Scalar;
+    }();
+    return detected;
+}
+
+auto activeSimdLevel() -> SimdLevel {
+    return std::min(detectSimdLevel(), gLevelCap.load(std::memory_order_relaxed));
+}
+
+void setSimdLevel(SimdLevel level) {
+    gLevelCap.store(level, std::memory_order_relaxed);
+}
+
+auto parseSimdLevel(std::string_view name) -> SimdLevel {
+    if (name == "auto") {
+        return detectSimdLevel();
+    }
+    for (size_t i = 0; i < kLevelNames.size(); ++i) {
+        if (name == kLevelNames[i]) {
+            return static_cast<SimdLevel>(i);
+        }
+    }
+    throw std::runtime_error("Unknown SIMD level '" + std::string(name) +
+                             "' (expected auto, scalar, sse4.2, avx2 or avx512)");
+}
+
+auto simdLevelName(SimdLevel level) -> std::string_view {
+    return kLevelNames.at(static_cast<size_t>(level));
+}
+
+auto byteKernels(SimdLevel level) -> const ByteKernels& {
+    switch (std::min(level, detectSimdLevel())) {
+#ifdef FQ_SIMD_X86
+        case SimdLevel::Avx512:
+            return kAvx512Kernels;
+        case SimdLevel::Avx2:
+            return kAvx2Kernels;
+        case SimdLevel::Sse42:
+            return kSse42Kernels;
+#endif
+        default:
+            return kScalarKernels;
+    }
+}
+
+}  // namespace fq::common
@@ -0,0 +1,336 @@
+#include "bgzf_block_reader.h"
+
+#include <libdeflate.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+namespace fq::io {
+
+namespace {
+
+constexpr size_t kGzipHeaderSize = 12;  // ID1 ID2 CM FLG MTIME(4) XFL OS XLEN(2)
+constexpr size_t kGzipFooterSize = 8;   // CRC32 ISIZE
+constexpr size_t kBgzfMaxBlockSize = 0x10000;
+constexpr size_t kBlocksPerThread = 8;
+
+auto readLe16(const unsigned char* p) -> uint32_t {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8);
+}
+
+auto readLe32(const unsigned char* p) -> uint32_t {
+    return readLe16(p) | (readLe16(p + 2) << 16);
+}
+
+/**
+ * @brief 从 BGZF 块头中取出 BSIZE（块总长度减一）
+ * @return 块总长度；不是 BGZF 块头时返回 0
+ */
+auto bgzfBlockSize(const unsigned char* p, size_t available) -> size_t {
+    if (available < kGzipHeaderSize || p[0] != 0x1f || p[1] != 0x8b || p[2] != 0x08 ||
+        (p[3] & 0x04) == 0) {
+        return 0;
+    }
+    const size_t xlen = readLe16(p + 10);
+    if (available < kGzipHeaderSize + xlen) {
+        return 0;
+    }
+    const unsigned char* extra = p + kGzipHeaderSize;
+    size_t pos = 0;
+    while (pos + 4 <= xlen) {
+        const size_t slen = readLe16(extra + pos + 2);
+        if (extra[pos] == 'B' && extra[pos + 1] == 'C' && slen == 2 && pos + 6 <= xlen) {
+            return static_cast<size_t>(readLe16(extra + pos + 4)) + 1;
+        }
+        pos += 4 + slen;
+    }
+    return 0;
+}
+
+class DecompressorHandle {
+public:
+    DecompressorHandle() : decompressor_(libdeflate_alloc_decompressor()) {
+        if (decompressor_ == nullptr) {
+            throw std::runtime_error("Failed to allocate libdeflate decompressor");
+        }
+    }
+    ~DecompressorHandle() {
+        if (decompressor_ != nullptr) {
+            libdeflate_free_decompressor(decompressor_);
+        }
+    }
+
+    DecompressorHandle(const DecompressorHandle&) = delete;
+    DecompressorHandle& operator=(const DecompressorHandle&) = delete;
+    DecompressorHandle(DecompressorHandle&& other) noexcept
+        : decompressor_(std::exchange(other.decompressor_, nullptr)) {}
+    DecompressorHandle& operator=(DecompressorHandle&&) = delete;
+
+    [[nodiscard]] auto get() const -> libdeflate_decompressor* {
+        return decompressor_;
+    }
+
+private:
+    libdeflate_decompressor* decompressor_;
+};
+
+struct BlockSpan {
+    size_t inputOffset = 0;  // 压缩数据中 deflate 负载的起始位置
+    size_t inputSize = 0;    // deflate 负载长度
+    size_t outputOffset = 0;
+    size_t outputSize = 0;
+    uint32_t crc = 0;
+};
+
+}  // namespace
+
+struct BgzfBlockReader::Impl {
+    int fd = -1;
+    size_t readChunkBytes = 0;
+    bool isInputEof = false;
+
+    std::vector<unsigned char> input;  // 尚未解压的压缩数据
+    size_t inputSize = 0;
+    std::vector<char> output;          // 已解压、尚未交给调用方的数据
+    size_t outputPos = 0;
+    std::vector<BlockSpan> blocks;
+
+    std::unique_ptr<tbb::task_arena> arena;
+    tbb::enumerable_thread_specific<DecompressorHandle> decompressors;
+
+    Impl(int f, size_t threads, size_t chunk) : fd(f) {
+        size_t concurrency = 1;
+        if (threads != 1) {
+            arena = threads == 0 ? std::make_unique<tbb::task_arena>()
+                                 : std::make_unique<tbb::task_arena>(static_cast<int>(threads));
+            arena->initialize();
+            concurrency = static_cast<size_t>(arena->max_concurrency());
+        }
+        // 每轮至少为每个线程准备若干个块
+        readChunkBytes = std::max(chunk, concurrency * kBlocksPerThread * kBgzfMaxBlockSize);
+    }
+
+    ~Impl() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    void readInput() {
+        if (input.size() < inputSize + readChunkBytes) {
+            input.resize(inputSize + readChunkBytes);
+        }
+        while (!isInputEof && inputSize < input.size()) {
+            const auto n = ::read(fd, input.data() + inputSize, input.size() - inputSize);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("BGZF read error");
+            }
+            if (n == 0) {
+                isInputEof = true;
+                break;
+            }
+            inputSize += static_cast<size_t>(n);
+        }
+    }
+
+    // 在已读入的压缩数据中切分出所有完整的块，返回这些块占用的字节数
+    auto collectBlocks() -> size_t {
+        blocks.clear();
+        size_t offset = 0;
+        size_t outputTotal = 0;
+        while (offset < inputSize) {
+            const unsigned char* p = input.data() + offset;
+            const size_t available = inputSize - offset;
+            // 块头（含 XLEN 字节的扩展字段）尚未读全时等待更多数据
+            if (!isInputEof && (available < kGzipHeaderSize ||
+                                available < kGzipHeaderSize + readLe16(p + 10))) {
+                break;
+            }
+            const size_t blockSize = bgzfBlockSize(p, available);
+            if (blockSize == 0) {
+                throw std::runtime_error(
+                    fmt::format("Invalid BGZF block header at compressed offset {}", offset));
+            }
+            if (blockSize > available) {
+                if (isInputEof) {
+                    throw std::runtime_error("Truncated BGZF input");
+                }
+                break;
+            }
+
+            const size_t headerSize = kGzipHeaderSize + readLe16(p + 10);
+            if (blockSize < headerSize + kGzipFooterSize) {
+                throw std::runtime_error("Invalid BGZF block size");
+            }
+            const unsigned char* footer = p + blockSize - kGzipFooterSize;
+            BlockSpan span;
+            span.inputOffset = offset + headerSize;
+            span.inputSize = blockSize - headerSize - kGzipFooterSize;
+            span.outputOffset = outputTotal;
+            span.outputSize = readLe32(footer + 4);
+            span.crc = readLe32(footer);
+            if (span.outputSize > kBgzfMaxBlockSize) {
+                throw std::runtime_error("Invalid BGZF block size");
+            }
+            outputTotal += span.outputSize;
+            blocks.push_back(span);
+            offset += blockSize;
+        }
+        output.resize(outputTotal);
+        outputPos = 0;
+        return offset;
+    }
+
+    void inflateRange(size_t begin, size_t end) {
+        auto* decompressor = decompressors.local().get();
+        for (size_t i = begin; i < end; ++i) {
+            const BlockSpan& span = blocks[i];
+            char* out = output.data() + span.outputOffset;
+            const auto result =
+                libdeflate_deflate_decompress(decompressor, input.data() + span.inputOffset,
+                                              span.inputSize, out, span.outputSize, nullptr);
+            if (result != LIBDEFLATE_SUCCESS) {
+                throw std::runtime_error("BGZF block decompression failed");
+            }
+            if (libdeflate_crc32(0, out, span.outputSize) != span.crc) {
+                throw std::runtime_error("BGZF block CRC mismatch");
+            }
+        }
+    }
+
+    // 读入下一段压缩数据并解压其中所有完整的块；返回 false 表示已无数据
+    auto refill() -> bool {
+        while (true) {
+            readInput();
+            const size_t consumed = collectBlocks();
+
+            if (!blocks.empty()) {
+                if (arena && blocks.size() > 1) {
+                    arena->execute([&] {
+                        tbb::parallel_for(tbb::blocked_range<size_t>(0, blocks.size(), 1),
+                                          [&](const tbb::blocked_range<size_t>& range) {
+                                              inflateRange(range.begin(), range.end());
+                                          });
+                    });
+                } else {
+                    inflateRange(0, blocks.size());
+                }
+            }
+
+            const size_t rest = inputSize - consumed;
+            if (rest > 0) {
+                std::memmove(input.data(), input.data() + consumed, rest);
+            }
+            inputSize = rest;
+
+            if (!output.empty()) {
+                return true;
+            }
+            if (isInputEof && inputSize == 0) {
+                return false;
+            }
+            // 只有空块（如 EOF 块）时继续读取
+        }
+    }
+};
+
+BgzfBlockReader::BgzfBlockReader(int fd, size_t threads, size_t readChunkBytes)
+    : impl_(std::make_unique<Impl>(fd, threads, readChunkBytes)) {}
+
+BgzfBlockReader::~BgzfBlockReader() = default;
+
+auto BgzfBlockReader::scanBlocks(int fd) -> std::vector<BgzfBlockInfo> {
+    std::vector<BgzfBlockInfo> blocks;
+    // 扩展字段长度可变（XLEN 最大 65535）：先读固定的 12 字节，再按 XLEN 读扩展字段
+    std::vector<unsigned char> header(kGzipHeaderSize);
+    uint64_t compressed = 0;
+    uint64_t uncompressed = 0;
+    while (true) {
+        const auto n = ::pread(fd, header.data(), kGzipHeaderSize, static_cast<off_t>(compressed));
+        if (n < 0) {
+            throw std::runtime_error("BGZF read error");
+        }
+        if (n == 0) {
+            break;
+        }
+        if (static_cast<size_t>(n) < kGzipHeaderSize) {
+            throw std::runtime_error("Truncated BGZF input");
+        }
+        if (header[0] != 0x1f || header[1] != 0x8b || header[2] != 0x08 || (header[3] & 0x04) == 0) {
+            throw std::runtime_error(
+                fmt::format("Invalid BGZF block header at compressed offset {}", compressed));
+        }
+        const size_t xlen = readLe16(header.data() + 10);
+        header.resize(kGzipHeaderSize + xlen);
+        if (xlen > 0 &&
+            ::pread(fd, header.data() + kGzipHeaderSize, xlen,
+                    static_cast<off_t>(compressed + kGzipHeaderSize)) != static_cast<ssize_t>(xlen)) {
+            throw std::runtime_error("Truncated BGZF input");
+        }
+        const size_t blockSize = bgzfBlockSize(header.data(), header.size());
+        if (blockSize == 0) {
+            throw std::runtime_error(
+                fmt::format("Invalid BGZF block header at compressed offset {}", compressed));
+        }
+        std::array<unsigned char, 4> isize{};
+        const auto footerOffset = static_cast<off_t>(compressed + blockSize - isize.size());
+        if (::pread(fd, isize.data(), isize.size(), footerOffset) !=
+            static_cast<ssize_t>(isize.size())) {
+            throw std::runtime_error("Truncated BGZF input");
+        }
+        blocks.push_back({compressed, uncompressed});
+        compressed += blockSize;
+        uncompressed += readLe32(isize.data());
+    }
+    return blocks;
+}
+
+void BgzfBlockReader::seek(uint64_t virtualOffset) {
+    auto& impl = *impl_;
+    const auto blockOffset = static_cast<off_t>(virtualOffset >> 16);
+    const size_t withinBlock = virtualOffset & 0xffff;
+    if (::lseek(impl.fd, blockOffset, SEEK_SET) != blockOffset) {
+        throw std::runtime_error("BGZF seek failed");
+    }
+    impl.isInputEof = false;
+    impl.inputSize = 0;
+    impl.output.clear();
+    impl.outputPos = 0;
+    if (withinBlock > 0) {
+        if (!impl.refill() || impl.blocks.front().outputSize < withinBlock) {
+            throw std::runtime_error("BGZF virtual offset is out of range");
+        }
+        impl.outputPos = withinBlock;
+    }
+}
+
+auto BgzfBlockReader::isBgzfHeader(const unsigned char* header, size_t size) -> bool {
+    return bgzfBlockSize(header, size) != 0;
+}
+
+auto BgzfBlockReader::read(char* dst, size_t size) -> ssize_t {
+    auto& impl = *impl_;
+    if (impl.outputPos == impl.output.size() && !impl.refill()) {
+        return 0;
+    }
+    const size_t n = std::min(size, impl.output.size() - impl.outputPos);
+    std::memcpy(dst, impl.output.data() + impl.outputPos, n);
+    impl.outputPos += n;
+    return static_cast<ssize_t>(n);
+}
+
+}  // namespace fq::io
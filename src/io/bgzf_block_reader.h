@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace fq::io {
+
+/**
+ * @brief BGZF 文件末尾的空块（EOF 标记）
+ */
+inline constexpr std::array<unsigned char, 28> kBgzfEofBlock = {
+    0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x06, 0x00, 0x42, 0x43,
+    0x02, 0x00, 0x1b, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+/**
+ * @brief BGZF 块在压缩文件与解压数据中的起始位置
+ */
+struct BgzfBlockInfo {
+    uint64_t compressedOffset = 0;
+    uint64_t uncompressedOffset = 0;
+};
+
+/**
+ * @brief BGZF 输入的并行解压器（内部实现）
+ * @details BGZF 的每个 gzip 成员在 FEXTRA 的 BC 子字段中记录了块大小，footer 中记录了
+ *          解压后大小，因此无需顺序解压即可切分出所有块，并用 libdeflate 并行解压。
+ *          解压结果按原顺序输出，read() 的语义与 gzread 相同。
+ */
+class BgzfBlockReader {
+public:
+    /**
+     * @param fd 已打开的文件描述符，所有权转移给本对象
+     * @param threads 解压线程数：1 为串行，0 为使用全部可用核心
+     * @param readChunkBytes 每轮至少读取的压缩数据量
+     */
+    BgzfBlockReader(int fd, size_t threads, size_t readChunkBytes);
+    ~BgzfBlockReader();
+
+    BgzfBlockReader(const BgzfBlockReader&) = delete;
+    BgzfBlockReader& operator=(const BgzfBlockReader&) = delete;
+
+    /**
+     * @brief 判断 gzip 头是否为 BGZF 块头
+     * @param header 文件开头的字节
+     * @param size header 的有效长度
+     */
+    [[nodiscard]] static auto isBgzfHeader(const unsigned char* header, size_t size) -> bool;
+
+    /**
+     * @brief 只读取块头与块尾，列出文件中所有 BGZF 块的位置
+     * @throw std::runtime_error 块格式错误或数据截断
+     */
+    [[nodiscard]] static auto scanBlocks(int fd) -> std::vector<BgzfBlockInfo>;
+
+    /**
+     * @brief 跳到虚拟偏移 (块压缩偏移 << 16) | 块内偏移
+     * @throw std::runtime_error 偏移超出块范围
+     */
+    void seek(uint64_t virtualOffset);
+
+    /**
+     * @brief 读取至多 size 字节的解压数据
+     * @return 实际读取的字节数，0 表示 EOF
+     * @throw std::runtime_error 块格式错误、数据截断或 CRC 校验失败
+     */
+    auto read(char* dst, size_t size) -> ssize_t;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace fq::io
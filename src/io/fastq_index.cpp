@@ -0,0 +1,238 @@
+#include "fqtools/io/fastq_index.h"
+
+#include "bgzf_block_reader.h"
+#include "fqtools/io/fastq_reader.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace fq::io {
+
+namespace {
+
+constexpr std::array<char, 4> kMagic = {'F', 'Q', 'I', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 48;
+constexpr size_t kEntrySize = 24;
+
+void putLe32(char* dst, uint32_t value) {
+    for (size_t i = 0; i < 4; ++i) {
+        dst[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+void putLe64(char* dst, uint64_t value) {
+    for (size_t i = 0; i < 8; ++i) {
+        dst[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+auto getLe32(const char* src) -> uint32_t {
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(src[i])) << (8 * i);
+    }
+    return value;
+}
+
+auto getLe64(const char* src) -> uint64_t {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(src[i])) << (8 * i);
+    }
+    return value;
+}
+
+// 把解压后文本中的偏移换算为 BGZF 虚拟偏移
+auto toVirtualOffset(const std::vector<BgzfBlockInfo>& blocks, uint64_t offset) -> uint64_t {
+    auto it = std::upper_bound(
+        blocks.begin(), blocks.end(), offset,
+        [](uint64_t value, const BgzfBlockInfo& block) { return value < block.uncompressedOffset; });
+    if (it == blocks.begin()) {
+        throw std::runtime_error("BGZF block table does not cover offset");
+    }
+    --it;
+    return (it->compressedOffset << 16) | (offset - it->uncompressedOffset);
+}
+
+// 从当前位置到文件末尾的字节数
+auto remainingBytes(std::istream& in) -> uint64_t {
+    const auto here = in.tellg();
+    in.seekg(0, std::ios::end);
+    const auto end = in.tellg();
+    in.seekg(here);
+    if (here < 0 || end < here) {
+        return 0;
+    }
+    return static_cast<uint64_t>(end - here);
+}
+
+}  // namespace
+
+auto FastqIndex::build(const std::string& fastqPath, uint64_t interval) -> FastqIndex {
+    if (interval == 0) {
+        throw std::runtime_error("FASTQ index interval must be positive");
+    }
+
+    FastqReader reader(fastqPath);
+    if (!reader.isOpen()) {
+        throw std::runtime_error("Failed to open input file: " + fastqPath);
+    }
+
+    FastqIndex index;
+    index.interval_ = interval;
+
+    std::vector<BgzfBlockInfo> blocks;
+    {
+        const int fd = ::open(fastqPath.c_str(), O_RDONLY);
+        struct stat st {};
+        if (fd < 0 || ::fstat(fd, &st) != 0) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            throw std::runtime_error("Failed to stat input file: " + fastqPath);
+        }
+        index.sourceSize_ = static_cast<uint64_t>(st.st_size);
+        if (reader.isBgzf()) {
+            index.format_ = FastqIndexFormat::Bgzf;
+            try {
+                blocks = BgzfBlockReader::scanBlocks(fd);
+            } catch (...) {
+                ::close(fd);
+                throw;
+            }
+        }
+        ::close(fd);
+    }
+
+    std::array<unsigned char, 2> magic{};
+    {
+        std::ifstream probe(fastqPath, std::ios::binary);
+        probe.read(reinterpret_cast<char*>(magic.data()), magic.size());
+    }
+    if (index.format_ == FastqIndexFormat::Plain && magic[0] == 0x1f && magic[1] == 0x8b) {
+        throw std::runtime_error("Plain gzip input cannot be indexed (use BGZF): " + fastqPath);
+    }
+
+    // 批次数据首尾相接，批次起点的累计偏移加上记录在批次内的位置即为记录偏移
+    uint64_t batchOffset = 0;
+    uint64_t recordNumber = 0;
+    FastqBatch batch;
+    while (reader.nextBatch(batch)) {
+        const auto data = batch.data();
+        for (const auto& rec : batch) {
+            if (recordNumber % interval == 0) {
+                FastqIndexEntry entry;
+                entry.recordNumber = recordNumber;
+                // rec.id 紧跟在行首的 '@' 之后
+                entry.offset = batchOffset + static_cast<uint64_t>(rec.id.data() - 1 - data.data());
+                if (index.format_ == FastqIndexFormat::Bgzf) {
+                    entry.virtualOffset = toVirtualOffset(blocks, entry.offset);
+                }
+                index.entries_.push_back(entry);
+            }
+            ++recordNumber;
+        }
+        batchOffset += data.size();
+    }
+    index.totalRecords_ = recordNumber;
+    return index;
+}
+
+auto FastqIndex::load(const std::string& indexPath) -> FastqIndex {
+    std::ifstream in(indexPath, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Failed to open FASTQ index: " + indexPath);
+    }
+    std::array<char, kHeaderSize> header{};
+    if (!in.read(header.data(), header.size()) ||
+        !std::equal(kMagic.begin(), kMagic.end(), header.begin())) {
+        throw std::runtime_error("Not a FASTQ index file: " + indexPath);
+    }
+    const uint32_t version = getLe32(header.data() + 4);
+    if (version != kVersion) {
+        throw std::runtime_error(
+            fmt::format("Unsupported FASTQ index version {}: {}", version, indexPath));
+    }
+    const uint32_t format = getLe32(header.data() + 8);
+    if (format > static_cast<uint32_t>(FastqIndexFormat::Bgzf)) {
+        throw std::runtime_error("Unknown FASTQ index format: " + indexPath);
+    }
+
+    FastqIndex index;
+    index.format_ = static_cast<FastqIndexFormat>(format);
+    index.sourceSize_ = getLe64(header.data() + 16);
+    index.interval_ = getLe64(header.data() + 24);
+    index.totalRecords_ = getLe64(header.data() + 32);
+    const uint64_t entryCount = getLe64(header.data() + 40);
+    if (index.interval_ == 0 ||
+        entryCount != (index.totalRecords_ + index.interval_ - 1) / index.interval_) {
+        throw std::runtime_error("Corrupted FASTQ index header: " + indexPath);
+    }
+    // 条目数与 totalRecords/interval 同样来自文件，分配前与剩余字节数核对（除法避免溢出）
+    if (entryCount > remainingBytes(in) / kEntrySize) {
+        throw std::runtime_error("Corrupted FASTQ index header: " + indexPath);
+    }
+
+    std::vector<char> body(static_cast<size_t>(entryCount) * kEntrySize);
+    if (!in.read(body.data(), static_cast<std::streamsize>(body.size()))) {
+        throw std::runtime_error("Truncated FASTQ index: " + indexPath);
+    }
+    index.entries_.resize(static_cast<size_t>(entryCount));
+    for (size_t i = 0; i < index.entries_.size(); ++i) {
+        const char* p = body.data() + i * kEntrySize;
+        index.entries_[i] = {getLe64(p), getLe64(p + 8), getLe64(p + 16)};
+    }
+    return index;
+}
+
+void FastqIndex::save(const std::string& indexPath) const {
+    std::ofstream out(indexPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Failed to create FASTQ index: " + indexPath);
+    }
+    std::array<char, kHeaderSize> header{};
+    std::copy(kMagic.begin(), kMagic.end(), header.begin());
+    putLe32(header.data() + 4, kVersion);
+    putLe32(header.data() + 8, static_cast<uint32_t>(format_));
+    putLe64(header.data() + 16, sourceSize_);
+    putLe64(header.data() + 24, interval_);
+    putLe64(header.data() + 32, totalRecords_);
+    putLe64(header.data() + 40, entries_.size());
+    out.write(header.data(), header.size());
+
+    std::vector<char> body(entries_.size() * kEntrySize);
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        char* p = body.data() + i * kEntrySize;
+        putLe64(p, entries_[i].recordNumber);
+        putLe64(p + 8, entries_[i].offset);
+        putLe64(p + 16, entries_[i].virtualOffset);
+    }
+    out.write(body.data(), static_cast<std::streamsize>(body.size()));
+    if (!out) {
+        throw std::runtime_error("Failed to write FASTQ index: " + indexPath);
+    }
+}
+
+auto FastqIndex::defaultPath(const std::string& fastqPath) -> std::string {
+    return fastqPath + ".fqi";
+}
+
+auto FastqIndex::checkpointFor(uint64_t recordNumber) const -> const FastqIndexEntry& {
+    if (entries_.empty() || recordNumber >= totalRecords_) {
+        throw std::out_of_range(
+            fmt::format("Record {} is beyond the indexed {} records", recordNumber, totalRecords_));
+    }
+    return entries_[static_cast<size_t>(recordNumber / interval_)];
+}
+
+}  // namespace fq::io
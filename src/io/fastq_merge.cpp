@@ -0,0 +1,133 @@
+#include "fqtools/io/fastq_merge.h"
+
+#include "bgzf_block_reader.h"
+#include "fqtools/io/fastq_reader.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+
+namespace fq::io {
+
+namespace {
+
+enum class InputKind : std::uint8_t {
+    Plain,
+    Bgzf,
+    Gzip,
+};
+
+auto sniffInput(const std::string& path) -> InputKind {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Failed to open input file: " + path);
+    }
+    std::array<unsigned char, 18> header{};
+    in.read(reinterpret_cast<char*>(header.data()), header.size());
+    const auto size = static_cast<size_t>(in.gcount());
+    if (size < 2 || header[0] != 0x1f || header[1] != 0x8b) {
+        return InputKind::Plain;
+    }
+    return BgzfBlockReader::isBgzfHeader(header.data(), size) ? InputKind::Bgzf
+                                                              : InputKind::Gzip;
+}
+
+auto outputIsGzip(const std::string& path, const FastqWriterOptions& options) -> bool {
+    if (options.compression != FastqWriterCompressionMode::Auto) {
+        return options.compression == FastqWriterCompressionMode::Gzip;
+    }
+    return path.size() >= 3 && path.compare(path.size() - 3, 3, ".gz") == 0;
+}
+
+/**
+ * @brief 直接拼接文件内容
+ * @details BGZF 输入若以 EOF 块结尾则去掉，最后统一补一个；未压缩输入缺少末尾换行时补上。
+ */
+void concatenateFiles(const std::vector<std::string>& inputs,
+                      const std::string& outputPath,
+                      bool bgzf) {
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Failed to open output file: " + outputPath);
+    }
+
+    std::vector<char> buffer(1024 * 1024);
+    for (const auto& path : inputs) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            throw std::runtime_error("Failed to open input file: " + path);
+        }
+        auto remaining = static_cast<uint64_t>(in.tellg());
+
+        char lastByte = '\n';
+        if (bgzf && remaining >= kBgzfEofBlock.size()) {
+            std::array<unsigned char, kBgzfEofBlock.size()> tail{};
+            in.seekg(static_cast<std::streamoff>(remaining - tail.size()));
+            in.read(reinterpret_cast<char*>(tail.data()), static_cast<std::streamsize>(tail.size()));
+            if (tail == kBgzfEofBlock) {
+                remaining -= tail.size();
+            }
+        }
+        in.seekg(0);
+
+        while (remaining > 0) {
+            const auto n = static_cast<size_t>(std::min<uint64_t>(remaining, buffer.size()));
+            if (!in.read(buffer.data(), static_cast<std::streamsize>(n))) {
+                throw std::runtime_error("Failed to read input file: " + path);
+            }
+            out.write(buffer.data(), static_cast<std::streamsize>(n));
+            lastByte = buffer[n - 1];
+            remaining -= n;
+        }
+        if (!bgzf && lastByte != '\n') {
+            out.put('\n');
+        }
+    }
+    if (bgzf) {
+        out.write(reinterpret_cast<const char*>(kBgzfEofBlock.data()),
+                  static_cast<std::streamsize>(kBgzfEofBlock.size()));
+    }
+    if (!out.flush()) {
+        throw std::runtime_error("Failed to write output file: " + outputPath);
+    }
+}
+
+}  // namespace
+
+auto mergeFastqFiles(const std::vector<std::string>& inputs,
+                     const std::string& outputPath,
+                     const FastqWriterOptions& options,
+                     const FastqReaderOptions& readerOptions) -> bool {
+    if (inputs.empty()) {
+        throw std::runtime_error("No input files to merge");
+    }
+
+    const InputKind target = outputIsGzip(outputPath, options) ? InputKind::Bgzf : InputKind::Plain;
+    const bool sameFormat = std::all_of(inputs.begin(), inputs.end(), [&](const auto& path) {
+        return sniffInput(path) == target;
+    });
+    if (sameFormat) {
+        concatenateFiles(inputs, outputPath, target == InputKind::Bgzf);
+        return true;
+    }
+
+    FastqWriter writer(outputPath, options);
+    if (!writer.isOpen()) {
+        throw std::runtime_error("Failed to open output file: " + outputPath);
+    }
+    FastqBatch batch;
+    for (const auto& path : inputs) {
+        FastqReader reader(path, readerOptions);
+        if (!reader.isOpen()) {
+            throw std::runtime_error("Failed to open input file: " + path);
+        }
+        while (reader.nextBatch(batch)) {
+            writer.write(batch);
+        }
+    }
+    return false;
+}
+
+}  // namespace fq::io
@@ -1,12 +1,22 @@
 #include "fqtools/io/fastq_reader.h"
 
+#include "bgzf_block_reader.h"
+#include "read_ahead_reader.h"
+#include "speculative_inflate_reader.h"
+#include "structural_scanner.h"
+#include "uring_file.h"
+
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstring>
 #include <cerrno>
 #include <fcntl.h>
 #include <limits>
 #include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <fmt/format.h>
 
@@ -14,6 +24,58 @@
 
 namespace fq::io {
 
+namespace {
+
+/**
+ * @brief 只读文件映射，由 Reader 与引用它的批次共享所有权
+ */
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    MappedFile(const char* d, size_t n) : data(d), size(n) {}
+    ~MappedFile() {
+        if (data != nullptr) {
+            ::munmap(const_cast<char*>(data), size);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+// 一个数据块约容纳的批次数：尾部只在换块时拷贝，约每这么多批一次
+constexpr size_t kBatchesPerBlock = 4;
+// 未限制 maxBufferBytes 时单个数据块的默认上限
+constexpr size_t kMaxDefaultBlockBytes = 64 * 1024 * 1024;
+// 保留的空闲数据块数，批次释放后可复用
+constexpr size_t kSpareBlocks = 4;
+
+// 流式读取按顺序访问文件，提示内核加大预读窗口
+void adviseSequential(int fd) {
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#else
+    (void)fd;
+#endif
+}
+
+auto mapRegularFile(int fd) -> std::shared_ptr<MappedFile> {
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+        return nullptr;
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+    ::madvise(addr, size, MADV_SEQUENTIAL);
+    return std::make_shared<MappedFile>(static_cast<const char*>(addr), size);
+}
+
+}  // namespace
+
 struct FastqReader::Impl {
     gzFile gzfile = nullptr;
     int fd = -1;
@@ -21,33 +83,117 @@ struct FastqReader::Impl {
     std::string path;
     bool isEofReached = false;
     FastqReaderOptions options{};
-    std::vector<char> remainder;
+    // 流式读取：[blockBegin, blockEnd) 是已读入但尚未交给批次的数据
+    std::shared_ptr<StreamBlock> block;
+    size_t blockBegin = 0;
+    size_t blockEnd = 0;
+    std::vector<std::shared_ptr<StreamBlock>> spareBlocks;
+    std::shared_ptr<MappedFile> mapping;
+    size_t mapOffset = 0;
+    std::unique_ptr<BgzfBlockReader> bgzf;
+    std::shared_ptr<MappedFile> compressedMapping;
+    std::unique_ptr<SpeculativeInflateReader> inflater;
+    size_t mapEnd = 0;
+    bool hasRecordLimit = false;
+    uint64_t remainingRecords = 0;
+    bool hasByteLimit = false;
+    uint64_t remainingBytes = 0;
+    // 已解析批次的字节数与记录数，用于按记录数估算批次字节数
+    uint64_t parsedBytes = 0;
+    uint64_t parsedRecords = 0;
+    // 后台预读：首次读取时创建，存在期间底层数据源只由其 I/O 线程访问
+    std::unique_ptr<ReadAheadReader> readAhead;
+    // io_uring 读取：首次读取时创建，seek 后重建；不可用时回退到 ::read
+    std::unique_ptr<UringFileReader> uring;
+    bool uringUnavailable = false;
 
     explicit Impl(const std::string& p, const FastqReaderOptions& opt) : path(p), options(opt) {
-        unsigned char header[2] = {0, 0};
+        // gzip 固定头 12 字节（ID1 ID2 CM FLG MTIME XFL OS XLEN）
+        constexpr size_t kGzipFixedHeader = 12;
+        std::vector<unsigned char> header(kGzipFixedHeader);
+        ssize_t headerBytes = 0;
         {
             const int sniffFd = ::open(path.c_str(), O_RDONLY);
             if (sniffFd >= 0) {
-                const auto n = ::read(sniffFd, header, sizeof(header));
-                ::close(sniffFd);
-                if (n == static_cast<ssize_t>(sizeof(header)) && header[0] == 0x1f &&
-                    header[1] == 0x8b) {
+                headerBytes = ::read(sniffFd, header.data(), header.size());
+                if (headerBytes >= 2 && header[0] == 0x1f && header[1] == 0x8b) {
                     isGzip = true;
                 }
+                // BGZF 的 BC 子字段可能排在其他扩展子字段之后：按 XLEN 读入完整的扩展字段
+                if (isGzip && headerBytes == static_cast<ssize_t>(kGzipFixedHeader) &&
+                    (header[3] & 0x04) != 0) {
+                    const size_t xlen = header[10] | (static_cast<size_t>(header[11]) << 8);
+                    header.resize(kGzipFixedHeader + xlen);
+                    const ssize_t extra = ::read(sniffFd, header.data() + kGzipFixedHeader, xlen);
+                    if (extra > 0) {
+                        headerBytes += extra;
+                    }
+                }
+                ::close(sniffFd);
+            }
+        }
+
+        if (isGzip && BgzfBlockReader::isBgzfHeader(header.data(),
+                                                    static_cast<size_t>(headerBytes))) {
+            // BGZF：块边界已知，按块并行解压
+            const int bgzfFd = ::open(path.c_str(), O_RDONLY);
+            if (bgzfFd >= 0) {
+                adviseSequential(bgzfFd);
+                bgzf = std::make_unique<BgzfBlockReader>(bgzfFd, options.decompressionThreads,
+                                                         options.readChunkBytes);
+            }
+        } else if (isGzip && options.speculativeInflate) {
+            const int gzFd = ::open(path.c_str(), O_RDONLY);
+            if (gzFd >= 0) {
+                compressedMapping = mapRegularFile(gzFd);
+                ::close(gzFd);
+            }
+            if (compressedMapping) {
+                inflater = std::make_unique<SpeculativeInflateReader>(
+                    reinterpret_cast<const unsigned char*>(compressedMapping->data),
+                    compressedMapping->size,
+                    options.decompressionThreads,
+                    options.readChunkBytes);
             }
         }
 
         if (isGzip) {
-            gzfile = gzopen(path.c_str(), "r");
-            if (gzfile) {
-                gzbuffer(gzfile, static_cast<unsigned>(options.zlibBufferBytes));
+            if (!bgzf && !inflater) {
+                const int gzFd = ::open(path.c_str(), O_RDONLY);
+                if (gzFd >= 0) {
+                    adviseSequential(gzFd);
+                    gzfile = gzdopen(gzFd, "r");
+                    if (!gzfile) {
+                        ::close(gzFd);
+                    }
+                }
+                if (gzfile) {
+                    gzbuffer(gzfile, static_cast<unsigned>(options.zlibBufferBytes));
+                }
             }
         } else {
             fd = ::open(path.c_str(), O_RDONLY);
+            // 显式要求 io_uring 时，Auto 模式改用流式读取，让多个读请求在途
+            const bool preferUring = options.inputMode == FastqReaderInputMode::Auto &&
+                                     options.ioUring && ioUringSupported();
+            if (fd >= 0 && options.inputMode != FastqReaderInputMode::Stream && !preferUring) {
+                mapping = mapRegularFile(fd);
+                if (mapping) {
+                    mapEnd = mapping->size;
+                    ::close(fd);
+                    fd = -1;
+                }
+            }
+            if (fd >= 0) {
+                adviseSequential(fd);
+            }
         }
     }
 
     ~Impl() {
+        // 先停止 I/O 线程与在途的 io_uring 请求，再关闭它们正在读取的数据源
+        readAhead.reset();
+        uring.reset();
         if (isGzip) {
             if (gzfile) {
                 gzclose(gzfile);
@@ -61,137 +207,147 @@ struct FastqReader::Impl {
 
     [[nodiscard]] auto isOpen() const -> bool {
         if (isGzip) {
-            return gzfile != nullptr;
+            return gzfile != nullptr || bgzf != nullptr || inflater != nullptr;
+        }
+        return fd >= 0 || mapping != nullptr;
+    }
+
+    // 每条记录的平均字节数：按已解析的批次或 nextChunk() 的采样实测，尚无样本时取 512
+    [[nodiscard]] auto bytesPerRecord() const -> size_t {
+        constexpr size_t kDefaultBytesPerRecord = 512;
+        if (parsedRecords == 0) {
+            return kDefaultBytesPerRecord;
+        }
+        return static_cast<size_t>(std::max<uint64_t>(1, parsedBytes / parsedRecords));
+    }
+
+    [[nodiscard]] auto capBatchBytes(size_t bytes) const -> size_t {
+        return options.maxBufferBytes > 0 ? std::min(bytes, options.maxBufferBytes) : bytes;
+    }
+
+    // 单次 nextBatch 期望处理的字节数：优先使用 targetBatchBytes，否则按 maxRecords 估算
+    [[nodiscard]] auto targetBatchBytes(size_t currentSize, size_t maxRecords) const -> size_t {
+        if (options.targetBatchBytes > 0) {
+            return capBatchBytes(std::max(currentSize, options.targetBatchBytes));
+        }
+        if (maxRecords == std::numeric_limits<size_t>::max()) {
+            return grownBatchBytes(currentSize);
+        }
+        const size_t perRecord = bytesPerRecord();
+        const size_t estimate = maxRecords > std::numeric_limits<size_t>::max() / perRecord
+            ? std::numeric_limits<size_t>::max()
+            : maxRecords * perRecord;
+        return capBatchBytes(std::max(currentSize, estimate));
+    }
+
+    // 当前数据中没有完整记录时，再多读一个 readChunkBytes
+    [[nodiscard]] auto grownBatchBytes(size_t currentSize) const -> size_t {
+        return capBatchBytes(currentSize + std::max<size_t>(1, options.readChunkBytes));
+    }
+
+    void recordParsed(size_t bytes, size_t records) {
+        parsedBytes += bytes;
+        parsedRecords += records;
+    }
+
+    /**
+     * @brief nextChunk() 不解析记录，按换行数（每条记录 4 行）计入块内的记录数
+     * @details 只采样前 kChunkSampleBytes 字节，估算稳定后串行读取阶段不再额外扫描数据
+     */
+    void sampleChunk(std::string_view chunk) {
+        constexpr uint64_t kChunkSampleBytes = 64ULL * 1024 * 1024;
+        if (parsedBytes >= kChunkSampleBytes) {
+            return;
         }
-        return fd >= 0;
+        const auto lines = static_cast<size_t>(std::count(chunk.begin(), chunk.end(), '\n'));
+        recordParsed(chunk.size(), (lines + 3) / 4);
     }
 
     auto readSome(char* dst, size_t toRead) -> ssize_t {
         if (toRead == 0) {
             return 0;
         }
+        return readSource(dst, toRead);
+    }
+
+    // 直接从底层数据源读取（启用预读时在 I/O 线程上调用）
+    auto readSource(char* dst, size_t toRead) -> ssize_t {
+        if (bgzf) {
+            return bgzf->read(dst, toRead);
+        }
+        if (inflater) {
+            return inflater->read(dst, toRead);
+        }
         if (isGzip) {
             const int n = gzread(gzfile, dst, static_cast<unsigned>(toRead));
             return static_cast<ssize_t>(n);
         }
 
+        if (options.ioUring && !uringUnavailable) {
+            if (!uring) {
+                startUring();
+            }
+            if (uring) {
+                return uring->read(dst, toRead);
+            }
+        }
+
+        if (hasByteLimit) {
+            toRead = static_cast<size_t>(std::min<uint64_t>(toRead, remainingBytes));
+            if (toRead == 0) {
+                return 0;
+            }
+        }
         while (true) {
             const auto n = ::read(fd, dst, toRead);
             if (n < 0 && errno == EINTR) {
                 continue;
             }
+            if (n > 0 && hasByteLimit) {
+                remainingBytes -= static_cast<uint64_t>(n);
+            }
             return n;
         }
     }
 
-    static auto findEol(const char* ptr, const char* end) -> const char* {
-        return static_cast<const char*>(std::memchr(ptr, '\n', static_cast<size_t>(end - ptr)));
-    }
-};
-
-FastqReader::FastqReader(const std::string& path) : FastqReader(path, FastqReaderOptions{}) {}
-
-FastqReader::FastqReader(const std::string& path, const FastqReaderOptions& options)
-    : impl_(std::make_unique<Impl>(path, options)) {}
-
-FastqReader::~FastqReader() = default;
-
-FastqReader::FastqReader(FastqReader&&) noexcept = default;
-FastqReader& FastqReader::operator=(FastqReader&&) noexcept = default;
-
-auto FastqReader::isOpen() const -> bool {
-    return impl_ && impl_->isOpen();
-}
-
-auto FastqReader::nextBatch(FastqBatch& batch) -> bool {
-    return nextBatch(batch, std::numeric_limits<size_t>::max());
-}
-
-auto FastqReader::nextBatch(FastqBatch& batch, size_t maxRecords) -> bool {
-    if (!impl_ || !impl_->isOpen()) {
-        return false;
-    }
-
-    batch.records().clear();
-    batch.buffer().clear();
-
-    if (!impl_->remainder.empty()) {
-        batch.buffer().swap(impl_->remainder);
-        impl_->remainder.clear();
+    // 从文件描述符的当前位置起改用 io_uring 读取，只支持常规文件
+    void startUring() {
+        struct stat st {};
+        const off_t position = ::lseek(fd, 0, SEEK_CUR);
+        if (position < 0 || ::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            uringUnavailable = true;
+            return;
+        }
+        const auto begin = static_cast<uint64_t>(position);
+        uint64_t end = std::max(begin, static_cast<uint64_t>(st.st_size));
+        if (hasByteLimit) {
+            end = std::min(end, begin + remainingBytes);
+        }
+        uring = UringFileReader::create(fd, begin, end, std::max<size_t>(1, options.readChunkBytes),
+                                        kUringQueueDepth);
+        uringUnavailable = uring == nullptr;
     }
 
-    if (batch.buffer().empty() && impl_->isEofReached) {
-        return false;
+    static auto findEol(const char* ptr, const char* end) -> const char* {
+        return static_cast<const char*>(std::memchr(ptr, '\n', static_cast<size_t>(end - ptr)));
     }
 
-    while (true) {
-        if (!impl_->isEofReached) {
-            const size_t chunk = std::max<size_t>(1, impl_->options.readChunkBytes);
-            const bool unlimited = (maxRecords == std::numeric_limits<size_t>::max());
-            constexpr size_t bytesPerRecordEst = 512;
-            const size_t maxBuf = impl_->options.maxBufferBytes;
-
-            size_t targetBytes = 0;
-            if (unlimited) {
-                targetBytes = batch.buffer().size() + chunk;
-            } else {
-                const size_t want = maxRecords * bytesPerRecordEst;
-                targetBytes = std::max(batch.buffer().size(), want);
-            }
-
-            if (maxBuf > 0) {
-                targetBytes = std::min(targetBytes, maxBuf);
-            }
-
-            while (!impl_->isEofReached && batch.buffer().size() < targetBytes) {
-                const auto kCurrentSize = batch.buffer().size();
-                if (maxBuf > 0 && kCurrentSize >= maxBuf) {
-                    break;
-                }
-
-                size_t toRead = chunk;
-                if (maxBuf > 0) {
-                    const auto kRemaining = maxBuf - kCurrentSize;
-                    if (kRemaining == 0) {
-                        break;
-                    }
-                    toRead = std::min(toRead, kRemaining);
-                }
-
-                if (batch.buffer().capacity() < kCurrentSize + chunk) {
-                    const auto kNewCap =
-                        std::max(batch.buffer().capacity() * 2, kCurrentSize + chunk);
-                    batch.buffer().reserve(kNewCap);
-                }
-
-                batch.buffer().resize(kCurrentSize + toRead);
-                const auto kBytesRead = impl_->readSome(batch.buffer().data() + kCurrentSize, toRead);
-                if (kBytesRead < 0) {
-                    if (impl_->isGzip) {
-                        int err = 0;
-                        const char* msg = gzerror(impl_->gzfile, &err);
-                        throw std::runtime_error(std::string("Gzip read error: ") +
-                                                 (msg != nullptr ? msg : "unknown"));
-                    }
-                    throw std::runtime_error("FastqReader read error");
-                }
-                batch.buffer().resize(kCurrentSize + static_cast<size_t>(kBytesRead));
-                if (kBytesRead == 0) {
-                    impl_->isEofReached = true;
-                }
-            }
-        }
-
-        if (batch.buffer().empty()) {
-            return false;
-        }
-
-        const char* data = batch.buffer().data();
-        const char* end = data + batch.buffer().size();
+    /**
+     * @brief 从 [data, end) 解析至多 maxRecords 条完整记录
+     * @details 换行符与 ID/注释分隔符的位置来自 StructuralScanner 的位图，不逐行调用 memchr。
+     * @param atEof end 是否为输入末尾（允许最后一行没有换行符）
+     * @return 最后一条完整记录之后的位置
+     */
+    static auto parseRecords(const char* data,
+                             const char* end,
+                             bool atEof,
+                             size_t maxRecords,
+                             std::vector<FastqRecord>& records) -> const char* {
         const char* ptr = data;
         const char* lastValidPtr = ptr;
+        StructuralScanner scanner(data, end);
 
-        while (ptr < end && batch.records().size() < maxRecords) {
+        while (ptr < end && records.size() < maxRecords) {
             while (ptr < end && (*ptr == '\n' || *ptr == '\r')) {
                 ++ptr;
             }
@@ -207,13 +363,13 @@ auto FastqReader::nextBatch(FastqBatch& batch, size_t maxRecords) -> bool {
                 throw std::runtime_error(fmt::format("Format Error: Expected '@' at record start. Found '{}'", *ptr));
             }
 
-            const char* line1End = Impl::findEol(ptr, end);
+            const char* line1End = scanner.nextNewline(ptr);
             if (line1End == nullptr) {
                 break;
             }
 
             const char* line2Start = line1End + 1;
-            const char* line2End = Impl::findEol(line2Start, end);
+            const char* line2End = scanner.nextNewline(line2Start);
             if (line2End == nullptr) {
                 break;
             }
@@ -225,15 +381,15 @@ auto FastqReader::nextBatch(FastqBatch& batch, size_t maxRecords) -> bool {
                  }
                  break;
             }
-            const char* line3End = Impl::findEol(line3Start, end);
+            const char* line3End = scanner.nextNewline(line3Start);
             if (line3End == nullptr) {
                 break;
             }
 
             const char* line4Start = line3End + 1;
-            const char* line4End = Impl::findEol(line4Start, end);
+            const char* line4End = scanner.nextNewline(line4Start);
             if (line4End == nullptr) {
-                if (impl_->isEofReached) {
+                if (atEof) {
                     line4End = end;
                 } else {
                     break;
@@ -242,18 +398,17 @@ auto FastqReader::nextBatch(FastqBatch& batch, size_t maxRecords) -> bool {
 
             FastqRecord rec;
 
-            const auto kIdLen = static_cast<size_t>(line1End - ptr);
-            size_t idLen = kIdLen;
-            if (idLen > 0 && ptr[idLen - 1] == '\r') {
-                --idLen;
+            // ID 行去掉 '@' 与行尾的 '\r'，在第一个空格或制表符处分为 ID 与注释
+            const char* idStart = ptr + 1;
+            const char* idEnd = line1End;
+            if (idEnd > idStart && idEnd[-1] == '\r') {
+                --idEnd;
             }
-            const std::string_view kFullIdLine(ptr + 1, idLen > 0 ? (idLen - 1) : 0);
-            const size_t kSpacePos = kFullIdLine.find_first_of(" \t");
-            if (kSpacePos != std::string_view::npos) {
-                rec.id = kFullIdLine.substr(0, kSpacePos);
-                rec.comment = kFullIdLine.substr(kSpacePos + 1);
-            } else {
-                rec.id = kFullIdLine;
+            const char* separator = scanner.findSeparator(idStart, idEnd);
+            rec.id = std::string_view(idStart, static_cast<size_t>(separator - idStart));
+            if (separator < idEnd) {
+                rec.comment =
+                    std::string_view(separator + 1, static_cast<size_t>(idEnd - separator - 1));
             }
 
             const auto kSeqLen = static_cast<size_t>(line2End - line2Start);
@@ -263,6 +418,14 @@ auto FastqReader::nextBatch(FastqBatch& batch, size_t maxRecords) -> bool {
             }
             rec.seq = std::string_view(line2Start, seqLen);
 
+            // '+' 之后的内容（通常为空或重复 ID），写出时原样保留
+            const char* plusStart = line3Start + 1;
+            const char* plusEnd = line3End;
+            if (plusEnd > plusStart && plusEnd[-1] == '\r') {
+                --plusEnd;
+            }
+            rec.plus = std::string_view(plusStart, static_cast<size_t>(plusEnd - plusStart));
+
             const auto kQualLen = static_cast<size_t>(line4End - line4Start);
             size_t qualLen = kQualLen;
             if (qualLen > 0 && line4Start[qualLen - 1] == '\r') {
@@ -270,7 +433,7 @@ auto FastqReader::nextBatch(FastqBatch& batch, size_t maxRecords) -> bool {
             }
             rec.qual = std::string_view(line4Start, qualLen);
 
-            batch.records().push_back(rec);
+            records.push_back(rec);
 
             ptr = line4End;
             if (ptr < end && *ptr == '\n') {
@@ -279,29 +442,693 @@ auto FastqReader::nextBatch(FastqBatch& batch, size_t maxRecords) -> bool {
             lastValidPtr = ptr;
         }
 
-        if (!batch.records().empty()) {
-            const auto kConsumed = static_cast<size_t>(lastValidPtr - data);
-            if (kConsumed < static_cast<size_t>(end - data)) {
-                impl_->remainder.assign(batch.buffer().begin() +
-                                             static_cast<std::ptrdiff_t>(kConsumed),
-                                         batch.buffer().end());
-                batch.buffer().resize(kConsumed);
+        return lastValidPtr;
+    }
+
+    /**
+     * @brief 在 [data, end) 中寻找安全的截断位置，使 [data, cut) 只包含完整记录
+     * @details 从末尾向前收集行首：第 j 行以 '@' 开头且第 j+2 行以 '+' 开头即为记录起始
+     *          （质量行可能以 '@' 开头，但其后第二行是序列行，不会以 '+' 开头）。
+     *          记录的四行均已完整时截断在其后，否则截断在其行首。
+     *          返回 data 表示没有完整记录，需要更多数据。
+     */
+    static auto findChunkEnd(const char* data, const char* end) -> const char* {
+        constexpr size_t kMaxLines = 64;
+        std::array<const char*, kMaxLines> lineStarts{};
+        size_t count = 0;
+
+        const char* scanEnd = end;
+        while (count < kMaxLines) {
+            const void* nl = ::memrchr(data, '\n', static_cast<size_t>(scanEnd - data));
+            if (nl == nullptr) {
+                lineStarts[count++] = data;
+                break;
+            }
+            const char* start = static_cast<const char*>(nl) + 1;
+            if (start < end) {
+                lineStarts[count++] = start;
+            }
+            scanEnd = static_cast<const char*>(nl);
+        }
+
+        for (size_t k = 2; k < count; ++k) {
+            if (*lineStarts[k] == '@' && *lineStarts[k - 2] == '+') {
+                return k >= 4 ? lineStarts[k - 4] : lineStarts[k];
             }
-            return true;
         }
 
-        if (impl_->isEofReached) {
-            batch.buffer().clear();
+        // 大量空行等罕见情况：退回逐条解析
+        std::vector<FastqRecord> scratch;
+        return parseRecords(data, end, false, std::numeric_limits<size_t>::max(), scratch);
+    }
+
+    [[nodiscard]] auto pendingBytes() const -> size_t {
+        return blockEnd - blockBegin;
+    }
+
+    [[nodiscard]] auto pendingData() const -> const char* {
+        return block ? block->data.get() + blockBegin : nullptr;
+    }
+
+    // 新数据块的字节数：约容纳 kBatchesPerBlock 批
+    [[nodiscard]] auto blockBytesFor(size_t targetBytes) const -> size_t {
+        const size_t chunk = std::max<size_t>(1, options.readChunkBytes);
+        return std::min(kBatchesPerBlock * std::max(targetBytes, chunk),
+                        options.maxBufferBytes > 0
+                            ? kBatchesPerBlock * std::max(options.maxBufferBytes, chunk)
+                            : kMaxDefaultBlockBytes);
+    }
+
+    /**
+     * @brief 保证当前数据块从 blockBegin 起至少能容纳 needed 字节
+     * @details 空间不足时换用新块（优先复用已无批次引用的空闲块），把尚未交出的数据拷贝过去。
+     */
+    void reserveBlock(size_t targetBytes, size_t needed) {
+        if (block && blockBegin + needed <= block->capacity) {
+            return;
+        }
+        size_t blockBytes = blockBytesFor(targetBytes);
+        if (blockBytes < needed) {
+            // 超长记录：按倍数增长，避免反复换块
+            blockBytes = std::max(blockBytes, needed * 2);
+        }
+
+        std::shared_ptr<StreamBlock> next;
+        for (auto& spare : spareBlocks) {
+            if (spare && spare.use_count() == 1 && spare->capacity >= blockBytes) {
+                // 与批次线程释放引用时的递减配对，之后才能覆盖块中的数据
+                std::atomic_thread_fence(std::memory_order_acquire);
+                next = std::move(spare);
+                break;
+            }
+        }
+        std::erase(spareBlocks, nullptr);
+        if (!next) {
+            next = std::make_shared<StreamBlock>(blockBytes);
+        }
+
+        const size_t pending = pendingBytes();
+        if (pending > 0) {
+            std::memcpy(next->data.get(), pendingData(), pending);
+        }
+        retireBlock();
+        block = std::move(next);
+        blockBegin = 0;
+        blockEnd = pending;
+    }
+
+    // 换块前把当前块放入空闲列表，等引用它的批次释放后复用
+    void retireBlock() {
+        if (block) {
+            if (spareBlocks.size() >= kSpareBlocks) {
+                spareBlocks.erase(spareBlocks.begin());
+            }
+            spareBlocks.push_back(std::move(block));
+        }
+    }
+
+    /**
+     * @brief 启用预读时取出 I/O 线程读入的下一段数据，接在尚未交出的数据之后
+     * @details 预读的数据已在 I/O 线程的数据块中：与当前块相邻时原地延伸；I/O 线程换块后，
+     *          把尾部拷贝到新块开头预留的空间并改用新块，与不预读时换块的拷贝相同。
+     *          只有尾部超过预留空间（超长记录）时才退回把新数据拷贝到自己的块中。
+     * @return 与 readSome() 相同
+     */
+    auto takeReadAhead(size_t targetBytes, size_t toRead) -> ssize_t {
+        // 需要更多数据时尚未交出的尾部不足 targetBytes，预留这么多即可
+        const size_t blockBytes = blockBytesFor(targetBytes);
+        const size_t headroom = std::min(targetBytes, blockBytes / 2);
+        if (!readAhead) {
+            readAhead = std::make_unique<ReadAheadReader>(
+                [this](char* buffer, size_t size) { return readSource(buffer, size); },
+                options.readChunkBytes, options.readAheadBuffers, blockBytes, headroom);
+        } else {
+            readAhead->setBlockBytes(blockBytes, headroom);
+        }
+
+        ReadAheadReader::Span span;
+        const ssize_t bytesRead = readAhead->read(toRead, span);
+        if (bytesRead <= 0) {
+            return bytesRead;
+        }
+        const size_t pending = pendingBytes();
+        if (span.block == block && span.begin == blockEnd) {
+            blockEnd = span.end;
+        } else if (pending <= span.begin) {
+            if (pending > 0) {
+                std::memcpy(span.block->data.get() + span.begin - pending, pendingData(), pending);
+            }
+            retireBlock();
+            block = std::move(span.block);
+            blockBegin = span.begin - pending;
+            blockEnd = span.end;
+            // 批次已释放的空闲块交还 I/O 线程复用
+            for (auto& spare : spareBlocks) {
+                if (spare.use_count() == 1) {
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    readAhead->recycle(std::move(spare));
+                }
+            }
+            std::erase(spareBlocks, nullptr);
+        } else {
+            reserveBlock(targetBytes, pending + static_cast<size_t>(bytesRead));
+            std::memcpy(block->data.get() + blockEnd, span.block->data.get() + span.begin,
+                        static_cast<size_t>(bytesRead));
+            blockEnd += static_cast<size_t>(bytesRead);
+        }
+        return bytesRead;
+    }
+
+    /**
+     * @brief 流式模式：向当前数据块追加数据，直至尚未交出的数据达到 targetBytes 或 EOF
+     */
+    void fillBlock(size_t targetBytes) {
+        if (isEofReached) {
+            return;
+        }
+        const size_t chunk = std::max<size_t>(1, options.readChunkBytes);
+        const size_t maxBuf = options.maxBufferBytes;
+
+        while (!isEofReached && pendingBytes() < targetBytes) {
+            const size_t pending = pendingBytes();
+            if (maxBuf > 0 && pending >= maxBuf) {
+                break;
+            }
+            size_t toRead = chunk;
+            if (maxBuf > 0) {
+                toRead = std::min(toRead, maxBuf - pending);
+            }
+
+            ssize_t bytesRead = 0;
+            if (options.readAheadBuffers > 0) {
+                bytesRead = takeReadAhead(targetBytes, toRead);
+            } else {
+                reserveBlock(targetBytes, pending + toRead);
+                bytesRead = readSome(block->data.get() + blockEnd, toRead);
+                if (bytesRead > 0) {
+                    blockEnd += static_cast<size_t>(bytesRead);
+                }
+            }
+            if (bytesRead < 0) {
+                if (gzfile != nullptr) {
+                    int err = 0;
+                    const char* msg = gzerror(gzfile, &err);
+                    throw std::runtime_error(std::string("Gzip read error: ") +
+                                             (msg != nullptr ? msg : "unknown"));
+                }
+                throw std::runtime_error("FastqReader read error");
+            }
+            if (bytesRead == 0) {
+                isEofReached = true;
+            }
+        }
+    }
+
+    // 把尚未交出数据的前 size 字节交给批次，批次共享数据块的所有权
+    void takePending(FastqBatch& batch, size_t size) {
+        batch.setExternalData(std::string_view(pendingData(), size), block);
+        blockBegin += size;
+    }
+
+    void throwBufferExhausted() const {
+        throw std::runtime_error(
+            "FastqReader reached maxBufferBytes without parsing a complete record; increase "
+            "batchCapacityBytes/maxBufferBytes");
+    }
+
+    /**
+     * @brief mmap 模式：批次只是映射内存中的一段记录边界区间，不拷贝数据
+     */
+    auto nextMappedBatch(FastqBatch& batch, size_t maxRecords, size_t recordCap) -> bool {
+        const char* base = mapping->data;
+        const size_t fileSize = mapEnd;
+
+        size_t window = targetBatchBytes(0, maxRecords);
+        while (mapOffset < fileSize) {
+            const size_t windowEnd = std::min(fileSize, mapOffset + std::max<size_t>(1, window));
+            const bool atEof = (windowEnd == fileSize);
+            const char* begin = base + mapOffset;
+            const char* consumedEnd =
+                parseRecords(begin, base + windowEnd, atEof, recordCap, batch.records());
+
+            if (!batch.records().empty()) {
+                const auto consumed = static_cast<size_t>(consumedEnd - begin);
+                batch.setExternalData(std::string_view(begin, consumed), mapping);
+                mapOffset = static_cast<size_t>(consumedEnd - base);
+                recordParsed(consumed, batch.records().size());
+                return true;
+            }
+
+            if (atEof) {
+                break;
+            }
+
+            if (options.maxBufferBytes > 0 && window >= options.maxBufferBytes) {
+                throwBufferExhausted();
+            }
+            window = grownBatchBytes(window);
+        }
+
+        mapOffset = fileSize;
+        isEofReached = true;
+        return false;
+    }
+
+    // mmap 模式下的 nextChunk：只确定记录边界，不解析
+    auto nextMappedChunk(FastqBatch& batch, size_t maxRecords) -> bool {
+        const char* base = mapping->data;
+        const size_t fileSize = mapEnd;
+        if (mapOffset >= fileSize) {
+            isEofReached = true;
             return false;
         }
 
-        if (impl_->options.maxBufferBytes > 0 &&
-            batch.buffer().size() >= impl_->options.maxBufferBytes) {
+        const char* begin = base + mapOffset;
+        size_t window = targetBatchBytes(0, maxRecords);
+        while (true) {
+            const size_t windowEnd = std::min(fileSize, mapOffset + std::max<size_t>(1, window));
+            const char* cut = base + windowEnd;
+            if (windowEnd < fileSize) {
+                cut = findChunkEnd(begin, base + windowEnd);
+            }
+            if (cut > begin) {
+                batch.setExternalData(std::string_view(begin, static_cast<size_t>(cut - begin)),
+                                      mapping);
+                mapOffset = static_cast<size_t>(cut - base);
+                sampleChunk(batch.data());
+                return true;
+            }
+            if (options.maxBufferBytes > 0 && window >= options.maxBufferBytes) {
+                throwBufferExhausted();
+            }
+            window = grownBatchBytes(window);
+        }
+    }
+
+    // 流式或 mmap 读取下一批记录：读取量见 targetBatchBytes()，最多解析 recordCap 条
+    auto readBatch(FastqBatch& batch, size_t maxRecords, size_t recordCap) -> bool {
+        batch.clear();
+
+        if (mapping) {
+            return nextMappedBatch(batch, maxRecords, recordCap);
+        }
+
+        size_t targetBytes = targetBatchBytes(pendingBytes(), maxRecords);
+        while (true) {
+            fillBlock(targetBytes);
+
+            const size_t pending = pendingBytes();
+            if (pending == 0) {
+                return false;
+            }
+
+            const char* data = pendingData();
+            const char* lastValidPtr =
+                parseRecords(data, data + pending, isEofReached, recordCap, batch.records());
+
+            if (!batch.records().empty()) {
+                const auto consumed = static_cast<size_t>(lastValidPtr - data);
+                takePending(batch, consumed);
+                recordParsed(consumed, batch.records().size());
+                return true;
+            }
+
+            if (isEofReached) {
+                blockBegin = blockEnd;
+                return false;
+            }
+
+            if (options.maxBufferBytes > 0 && pending >= options.maxBufferBytes) {
+                throwBufferExhausted();
+            }
+            targetBytes = grownBatchBytes(pending);
+        }
+    }
+
+    auto nextBatch(FastqBatch& batch, size_t maxRecords) -> bool {
+        if (hasRecordLimit && remainingRecords == 0) {
+            batch.clear();
+            return false;
+        }
+        const size_t recordCap = hasRecordLimit
+            ? static_cast<size_t>(std::min<uint64_t>(maxRecords, remainingRecords))
+            : maxRecords;
+        if (!readBatch(batch, maxRecords, recordCap)) {
+            return false;
+        }
+        if (hasRecordLimit) {
+            remainingRecords -= batch.size();
+        }
+        return true;
+    }
+
+    // 定位到检查点：丢弃已缓冲的数据，从检查点处重新读取
+    void seekTo(const FastqIndexEntry& entry, FastqIndexFormat format) {
+        // 预读与 io_uring 在途读取的数据属于旧位置，一并丢弃
+        readAhead.reset();
+        uring.reset();
+        blockBegin = blockEnd;
+        isEofReached = false;
+        if (format == FastqIndexFormat::Bgzf) {
+            bgzf->seek(entry.virtualOffset);
+        } else if (mapping) {
+            mapOffset = static_cast<size_t>(std::min<uint64_t>(entry.offset, mapEnd));
+        } else if (::lseek(fd, static_cast<off_t>(entry.offset), SEEK_SET) < 0) {
+            throw std::runtime_error("FastqReader seek failed: " + path);
+        }
+    }
+
+    void seekToRecord(const FastqIndex& index, uint64_t firstRecord, uint64_t recordCount) {
+        const bool formatMatches =
+            index.format() == FastqIndexFormat::Bgzf ? bgzf != nullptr : !isGzip;
+        if (!formatMatches) {
+            throw std::runtime_error("FASTQ index format does not match input: " + path);
+        }
+        struct stat st {};
+        if (::stat(path.c_str(), &st) != 0 ||
+            static_cast<uint64_t>(st.st_size) != index.sourceSize()) {
+            throw std::runtime_error("FASTQ index is stale (input size changed): " + path);
+        }
+
+        hasRecordLimit = false;
+        if (firstRecord >= index.totalRecords()) {
+            hasRecordLimit = true;
+            remainingRecords = 0;
+            return;
+        }
+
+        const FastqIndexEntry& checkpoint = index.checkpointFor(firstRecord);
+        seekTo(checkpoint, index.format());
+        uint64_t toSkip = firstRecord - checkpoint.recordNumber;
+        FastqBatch scratch;
+        while (toSkip > 0) {
+            if (!nextBatch(scratch, static_cast<size_t>(toSkip))) {
+                throw std::runtime_error("FASTQ index points past the end of input: " + path);
+            }
+            toSkip -= scratch.size();
+        }
+
+        hasRecordLimit = recordCount != std::numeric_limits<uint64_t>::max();
+        remainingRecords = recordCount;
+    }
+
+    /**
+     * @brief 在 [data, data + size) 中寻找第一个真正的记录起点
+     * @details 以 '@' 开头的行可能是记录头，也可能是质量行。候选行需满足：其后第二行以 '+' 开头、
+     *          序列与质量等长，且紧随其后的是另一条同样以 '@' 开头的行或输入末尾。
+     *          质量行作为候选时，其后第二行是序列行，不会以 '+' 开头，因此不会被误判。
+     * @param skipFirstLine data[0] 是起点之前的一个字节，只有其后的行首才是候选
+     * @param atEof data + size 是否为输入末尾
+     * @return 记录起点相对 data 的偏移；窗口内行数不足以判定时返回 size + 1
+     */
+    static auto findRecordStart(const char* data, size_t size, bool skipFirstLine, bool atEof)
+        -> size_t {
+        const char* end = data + size;
+        // 窗口内从候选位置起的完整行；最后一行在 atEof 时可以没有换行符
+        auto lineAfter = [&](const char* start) -> const char* {
+            if (start >= end) {
+                return nullptr;
+            }
+            const char* eol = findEol(start, end);
+            return eol != nullptr ? eol : (atEof ? end : nullptr);
+        };
+        auto trimmedLength = [](const char* start, const char* eol) -> size_t {
+            auto len = static_cast<size_t>(eol - start);
+            return (len > 0 && start[len - 1] == '\r') ? len - 1 : len;
+        };
+
+        const char* candidate = data;
+        if (skipFirstLine) {
+            const char* eol = findEol(data, end);
+            if (eol == nullptr) {
+                return atEof ? size : size + 1;
+            }
+            candidate = eol + 1;
+        }
+
+        while (candidate < end) {
+            if (*candidate != '@') {
+                const char* eol = findEol(candidate, end);
+                if (eol == nullptr) {
+                    return atEof ? size : size + 1;
+                }
+                candidate = eol + 1;
+                continue;
+            }
+
+            std::array<const char*, 4> starts{};
+            std::array<const char*, 4> eols{};
+            const char* cursor = candidate;
+            size_t lines = 0;
+            for (; lines < starts.size(); ++lines) {
+                const char* eol = lineAfter(cursor);
+                if (eol == nullptr) {
+                    break;
+                }
+                starts[lines] = cursor;
+                eols[lines] = eol;
+                cursor = eol + 1;
+            }
+            if (lines < starts.size()) {
+                if (!atEof) {
+                    return size + 1;
+                }
+                // 末尾不足一条记录，之后不再有记录起点
+                return size;
+            }
+
+            const bool looksLikeRecord = starts[2] < eols[2] &&
+                                         *starts[2] == '+' &&
+                                         trimmedLength(starts[1], eols[1]) ==
+                                             trimmedLength(starts[3], eols[3]);
+            if (looksLikeRecord) {
+                const char* next = cursor;
+                while (next < end && (*next == '\n' || *next == '\r')) {
+                    ++next;
+                }
+                if (next >= end && !atEof) {
+                    return size + 1;
+                }
+                if (next >= end || *next == '@') {
+                    return static_cast<size_t>(candidate - data);
+                }
+            }
+
+            const char* eol = findEol(candidate, end);
+            if (eol == nullptr) {
+                return atEof ? size : size + 1;
+            }
+            candidate = eol + 1;
+        }
+        return atEof ? size : size + 1;
+    }
+
+    // 未压缩输入：把名义字节偏移推进到其后第一个记录起点
+    auto resyncOffset(uint64_t nominal, uint64_t fileSize) -> uint64_t {
+        if (nominal == 0 || nominal >= fileSize) {
+            return std::min(nominal, fileSize);
+        }
+        std::vector<char> buffer;
+        uint64_t window = 64 * 1024;
+        while (true) {
+            // 多取起点前的一个字节，以判断起点本身是否为行首
+            const uint64_t begin = nominal - 1;
+            const auto length = static_cast<size_t>(std::min(window, fileSize - begin));
+            const bool atEof = begin + length == fileSize;
+            const char* data = nullptr;
+            if (mapping) {
+                data = mapping->data + begin;
+            } else {
+                buffer.resize(length);
+                size_t filled = 0;
+                while (filled < length) {
+                    const auto n = ::pread(fd, buffer.data() + filled, length - filled,
+                                           static_cast<off_t>(begin + filled));
+                    if (n < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (n <= 0) {
+                        throw std::runtime_error("FastqReader read error: " + path);
+                    }
+                    filled += static_cast<size_t>(n);
+                }
+                data = buffer.data();
+            }
+
+            const size_t found = findRecordStart(data, length, true, atEof);
+            if (found <= length) {
+                return begin + found;
+            }
+            window *= 2;
+        }
+    }
+
+    // 按 shardIndex/shardCount 限定读取范围
+    void applyShard() {
+        const size_t shardIndex = options.shardIndex;
+        const size_t shardCount = options.shardCount;
+        if (shardCount == 0 || shardIndex >= shardCount) {
             throw std::runtime_error(
-                "FastqReader reached maxBufferBytes without parsing a complete record; increase "
-                "batchCapacityBytes/maxBufferBytes");
+                fmt::format("Invalid shard {}/{}: index must be below count", shardIndex, shardCount));
+        }
+        if (shardCount == 1) {
+            return;
+        }
+
+        if (bgzf) {
+            // 解压后的偏移只能借助索引定位，按记录数均分
+            const std::string indexPath = FastqIndex::defaultPath(path);
+            struct stat st {};
+            if (::stat(indexPath.c_str(), &st) != 0) {
+                throw std::runtime_error("Sharding BGZF input requires an index; run 'index' first: " +
+                                         indexPath);
+            }
+            const FastqIndex index = FastqIndex::load(indexPath);
+            const uint64_t total = index.totalRecords();
+            const uint64_t first = total * shardIndex / shardCount;
+            const uint64_t last = total * (shardIndex + 1) / shardCount;
+            seekToRecord(index, first, last - first);
+            return;
+        }
+        if (isGzip) {
+            throw std::runtime_error("Sharding requires uncompressed or BGZF input: " + path);
+        }
+
+        uint64_t fileSize = 0;
+        if (mapping) {
+            fileSize = mapping->size;
+        } else {
+            struct stat st {};
+            if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+                throw std::runtime_error("Sharding requires a regular input file: " + path);
+            }
+            fileSize = static_cast<uint64_t>(st.st_size);
+        }
+
+        const uint64_t begin = resyncOffset(fileSize * shardIndex / shardCount, fileSize);
+        const uint64_t end =
+            std::max(begin, resyncOffset(fileSize * (shardIndex + 1) / shardCount, fileSize));
+        if (mapping) {
+            mapOffset = static_cast<size_t>(begin);
+            mapEnd = static_cast<size_t>(end);
+        } else {
+            if (::lseek(fd, static_cast<off_t>(begin), SEEK_SET) < 0) {
+                throw std::runtime_error("FastqReader seek failed: " + path);
+            }
+            hasByteLimit = true;
+            remainingBytes = end - begin;
         }
     }
+};
+
+FastqReader::FastqReader(const std::string& path) : FastqReader(path, FastqReaderOptions{}) {}
+
+FastqReader::FastqReader(const std::string& path, const FastqReaderOptions& options)
+    : impl_(std::make_unique<Impl>(path, options)) {
+    if (impl_->isOpen()) {
+        impl_->applyShard();
+    }
+}
+
+FastqReader::~FastqReader() = default;
+
+FastqReader::FastqReader(FastqReader&&) noexcept = default;
+FastqReader& FastqReader::operator=(FastqReader&&) noexcept = default;
+
+auto FastqReader::isOpen() const -> bool {
+    return impl_ && impl_->isOpen();
+}
+
+auto FastqReader::isMemoryMapped() const -> bool {
+    return impl_ && impl_->mapping != nullptr;
+}
+
+auto FastqReader::isBgzf() const -> bool {
+    return impl_ && impl_->bgzf != nullptr;
+}
+
+void FastqReader::seekToRecord(const FastqIndex& index, uint64_t firstRecord,
+                               uint64_t recordCount) {
+    if (!impl_ || !impl_->isOpen()) {
+        throw std::runtime_error("FastqReader is not open");
+    }
+    impl_->seekToRecord(index, firstRecord, recordCount);
+}
+
+auto FastqReader::nextBatch(FastqBatch& batch) -> bool {
+    return nextBatch(batch, std::numeric_limits<size_t>::max());
+}
+
+auto FastqReader::nextBatch(FastqBatch& batch, size_t maxRecords) -> bool {
+    if (!impl_ || !impl_->isOpen()) {
+        return false;
+    }
+    return impl_->nextBatch(batch, maxRecords);
+}
+
+auto FastqReader::nextChunk(FastqBatch& batch, size_t maxRecords) -> bool {
+    if (!impl_ || !impl_->isOpen()) {
+        return false;
+    }
+    if (impl_->hasRecordLimit) {
+        // 需要按记录数截断，只能在此处解析
+        return impl_->nextBatch(batch, maxRecords);
+    }
+
+    batch.clear();
+
+    if (impl_->mapping) {
+        return impl_->nextMappedChunk(batch, maxRecords);
+    }
+
+    // 不以已缓冲的字节数为下限：上一块留下的数据可能远多于目标，按目标继续切分
+    size_t targetBytes = impl_->targetBatchBytes(0, maxRecords);
+    while (true) {
+        impl_->fillBlock(targetBytes);
+
+        const size_t pending = impl_->pendingBytes();
+        if (pending == 0) {
+            return false;
+        }
+        // 数据按 readChunkBytes 读入，可能多于目标字节数：优先只截取目标范围内的完整记录，
+        // 其余留在数据块中给下一块
+        const char* data = impl_->pendingData();
+        const size_t window = std::min(pending, targetBytes);
+        const char* cut = window < pending ? Impl::findChunkEnd(data, data + window) : data;
+        if (cut == data) {
+            if (impl_->isEofReached) {
+                impl_->takePending(batch, pending);
+                impl_->sampleChunk(batch.data());
+                return true;
+            }
+            cut = Impl::findChunkEnd(data, data + pending);
+        }
+        if (cut > data) {
+            impl_->takePending(batch, static_cast<size_t>(cut - data));
+            impl_->sampleChunk(batch.data());
+            return true;
+        }
+
+        if (impl_->options.maxBufferBytes > 0 && pending >= impl_->options.maxBufferBytes) {
+            impl_->throwBufferExhausted();
+        }
+        targetBytes = impl_->grownBatchBytes(pending);
+    }
+}
+
+void FastqReader::setTargetBatchBytes(size_t bytes) {
+    if (impl_) {
+        impl_->options.targetBatchBytes = bytes;
+    }
+}
+
+void FastqReader::parseChunk(FastqBatch& batch) {
+    if (!batch.records().empty()) {
+        return;
+    }
+    const auto data = batch.data();
+    Impl::parseRecords(data.data(), data.data() + data.size(), true,
+                       std::numeric_limits<size_t>::max(), batch.records());
 }
 
 }  // namespace fq::io
@@ -1,15 +1,28 @@
 #include "fqtools/io/fastq_writer.h"
 
+#include "bgzf_block_reader.h"
+#include "uring_file.h"
+
 #include <libdeflate.h>
 #include <fcntl.h>
+#include <sys/uio.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <array>
 #include <cerrno>
 #include <cstring>
+#include <memory>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 namespace fq::io {
 
 static auto endsWithGzSuffix(const std::string& path) -> bool {
@@ -20,18 +33,104 @@ static auto endsWithGzSuffix(const std::string& path) -> bool {
     return path.compare(path.size() - 3, 3, kGz) == 0;
 }
 
+namespace {
+
+// BGZF 块布局：18 字节头（含 BC 子字段）+ deflate 数据 + CRC32 + ISIZE，整块不超过 64 KiB
+constexpr size_t kBgzfBlockDataSize = 0xff00;
+constexpr size_t kBgzfMaxBlockSize = 0x10000;
+constexpr size_t kBgzfHeaderSize = 18;
+constexpr size_t kBgzfFooterSize = 8;
+
+void putLe16(char* dst, uint32_t value) {
+    dst[0] = static_cast<char>(value & 0xff);
+    dst[1] = static_cast<char>((value >> 8) & 0xff);
+}
+
+void putLe32(char* dst, uint32_t value) {
+    putLe16(dst, value & 0xffff);
+    putLe16(dst + 2, value >> 16);
+}
+
+/**
+ * @brief 每个线程独占的 libdeflate 压缩器（libdeflate_compressor 不是线程安全的）
+ */
+class CompressorHandle {
+public:
+    explicit CompressorHandle(int level) : compressor_(libdeflate_alloc_compressor(level)) {
+        if (compressor_ == nullptr) {
+            throw std::runtime_error("Failed to allocate libdeflate compressor");
+        }
+    }
+    ~CompressorHandle() {
+        if (compressor_ != nullptr) {
+            libdeflate_free_compressor(compressor_);
+        }
+    }
+
+    CompressorHandle(const CompressorHandle&) = delete;
+    CompressorHandle& operator=(const CompressorHandle&) = delete;
+    CompressorHandle(CompressorHandle&& other) noexcept
+        : compressor_(std::exchange(other.compressor_, nullptr)) {}
+    CompressorHandle& operator=(CompressorHandle&&) = delete;
+
+    [[nodiscard]] auto get() const -> libdeflate_compressor* {
+        return compressor_;
+    }
+
+private:
+    libdeflate_compressor* compressor_;
+};
+
+/**
+ * @brief 将 n 字节（n <= kBgzfBlockDataSize）压缩为一个完整的 BGZF 块
+ * @return 块的总字节数
+ */
+auto compressBgzfBlock(libdeflate_compressor* compressor, const char* in, size_t n, char* out)
+    -> size_t {
+    constexpr size_t kMaxPayload = kBgzfMaxBlockSize - kBgzfHeaderSize - kBgzfFooterSize;
+    char* payload = out + kBgzfHeaderSize;
+
+    size_t payloadSize = libdeflate_deflate_compress(compressor, in, n, payload, kMaxPayload);
+    if (payloadSize == 0) {
+        // 不可压缩的数据：写入单个 stored block
+        payload[0] = 0x01;
+        putLe16(payload + 1, static_cast<uint32_t>(n));
+        putLe16(payload + 3, static_cast<uint32_t>(~n & 0xffff));
+        std::memcpy(payload + 5, in, n);
+        payloadSize = n + 5;
+    }
+
+    const size_t blockSize = kBgzfHeaderSize + payloadSize + kBgzfFooterSize;
+    std::memcpy(out, kBgzfEofBlock.data(), 16);  // ID1 ID2 CM FLG MTIME XFL OS XLEN 'B' 'C' SLEN
+    putLe16(out + 16, static_cast<uint32_t>(blockSize - 1));
+    putLe32(payload + payloadSize, libdeflate_crc32(0, in, n));
+    putLe32(payload + payloadSize + 4, static_cast<uint32_t>(n));
+    return blockSize;
+}
+
+}  // namespace
+
 struct FastqWriter::Impl {
+    using CompressorPool = tbb::enumerable_thread_specific<CompressorHandle>;
+
     int fd = -1;
     std::string path;
     FastqWriterOptions options{};
     FastqWriterCompressionMode compression = FastqWriterCompressionMode::Auto;
     std::vector<char> buffer;
-    
-    struct libdeflate_compressor* compressor = nullptr;
-    std::vector<char> compressedBuffer;
-    
+    // io_uring 写出，不可用或输出不是常规文件时为空，使用 ::write
+    std::unique_ptr<UringFileWriter> uring;
+
+    std::unique_ptr<CompressorPool> compressors;
+    std::unique_ptr<tbb::task_arena> arena;
+    std::vector<std::vector<char>> blockOutputs;
+    std::vector<size_t> blockSizes;
+
     std::uint64_t totalUncompressedBytes = 0;
     static constexpr size_t kBufferThreshold = 64 * 1024;
+    static constexpr size_t kBlocksPerThread = 4;
+    // io_uring 每个在途写请求的上限，注册的缓冲区计入 RLIMIT_MEMLOCK
+    static constexpr size_t kUringBufferBytes = 1024 * 1024;
 
     explicit Impl(const std::string& p, const FastqWriterOptions& opt) : path(p), options(opt) {
         if (options.compression == FastqWriterCompressionMode::Auto) {
@@ -41,79 +140,274 @@ struct FastqWriter::Impl {
             compression = options.compression;
         }
 
+        size_t bufferBytes = options.outputBufferBytes;
+        if (compression == FastqWriterCompressionMode::Gzip) {
+            // 预先分配当前线程的压缩器，压缩级别无效时在打开文件前报错
+            const int level = options.compressionLevel;
+            compressors = std::make_unique<CompressorPool>([level] { return CompressorHandle(level); });
+            compressors->local();
+
+            if (options.compressionThreads != 1) {
+                arena = options.compressionThreads == 0
+                    ? std::make_unique<tbb::task_arena>()
+                    : std::make_unique<tbb::task_arena>(static_cast<int>(options.compressionThreads));
+                arena->initialize();
+                // 每次 flush 至少为每个压缩线程准备若干个完整块
+                const auto concurrency = static_cast<size_t>(arena->max_concurrency());
+                bufferBytes = std::max(bufferBytes, concurrency * kBlocksPerThread * kBgzfBlockDataSize);
+            }
+            bufferBytes = std::max(bufferBytes, kBgzfBlockDataSize);
+        }
+
         // Open file with standard POSIX IO
         fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
         if (fd < 0) {
              throw std::runtime_error("Failed to open output file: " + path);
         }
-        
-        buffer.reserve(options.outputBufferBytes);
 
-        if (compression == FastqWriterCompressionMode::Gzip) {
-            // Level 6 is default zlib level
-            compressor = libdeflate_alloc_compressor(6);
-            if (!compressor) {
-                ::close(fd);
-                throw std::runtime_error("Failed to allocate libdeflate compressor");
-            }
+        buffer.reserve(bufferBytes);
 
-            // Ensure compressed buffer is large enough for worst case
-            // libdeflate_gzip_compress_bound provides the upper bound
-            compressedBuffer.resize(
-                libdeflate_gzip_compress_bound(compressor, options.outputBufferBytes));
+        struct stat st {};
+        if (options.ioUring && ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+            uring = UringFileWriter::create(fd, 0, std::min(bufferBytes, kUringBufferBytes),
+                                            kUringQueueDepth);
         }
     }
 
     ~Impl() {
         if (fd >= 0) {
             try {
-                flush();
+                flush(true);
+                if (compression == FastqWriterCompressionMode::Gzip) {
+                    writeAll(reinterpret_cast<const char*>(kBgzfEofBlock.data()),
+                             kBgzfEofBlock.size());
+                }
+                if (uring) {
+                    uring->finish();
+                }
             } catch (...) {
                 // Destructors must not throw.
             }
+            uring.reset();
             ::close(fd);
-            if (compressor) {
-                libdeflate_free_compressor(compressor);
-            }
         }
     }
 
-    void flush() {
-        if (fd >= 0 && !buffer.empty()) {
-            const char* outPtr = nullptr;
-            size_t outSize = 0;
-
-            if (compression == FastqWriterCompressionMode::Gzip) {
-                const size_t compressedSize = libdeflate_gzip_compress(
-                    compressor, buffer.data(), buffer.size(), compressedBuffer.data(),
-                    compressedBuffer.size());
-                if (compressedSize == 0) {
-                    throw std::runtime_error("Failed to compress output buffer");
-                }
-                outPtr = compressedBuffer.data();
-                outSize = compressedSize;
-            } else {
-                outPtr = buffer.data();
-                outSize = buffer.size();
-            }
-
-            size_t totalWritten = 0;
-            while (totalWritten < outSize) {
-                const ssize_t written = ::write(
-                    fd, outPtr + totalWritten, outSize - totalWritten);
-                if (written < 0) {
-                    if (errno == EINTR) {
-                        continue;
-                    }
-                    throw std::runtime_error("Failed to write output file: " + path);
-                }
-                if (written == 0) {
-                    throw std::runtime_error("Failed to write output file: " + path);
+    void writeAll(const char* data, size_t size) {
+        if (uring) {
+            if (const int err = uring->write(data, size); err != 0) {
+                throw std::runtime_error("Failed to write output file: " + path + ": " +
+                                         std::strerror(err));
+            }
+            return;
+        }
+        size_t totalWritten = 0;
+        while (totalWritten < size) {
+            const ssize_t written = ::write(fd, data + totalWritten, size - totalWritten);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
                 }
-                totalWritten += static_cast<size_t>(written);
+                throw std::runtime_error("Failed to write output file: " + path);
+            }
+            if (written == 0) {
+                throw std::runtime_error("Failed to write output file: " + path);
+            }
+            totalWritten += static_cast<size_t>(written);
+        }
+    }
+
+    /**
+     * @brief 输出缓冲区中的数据
+     * @param final 为 false 时 gzip 模式只压缩完整的块，不足一块的尾部留到下一次，
+     *              保证除最后一块外每个 BGZF 块都是满的
+     */
+    void flush(bool final) {
+        if (fd < 0 || buffer.empty()) {
+            return;
+        }
+        if (compression != FastqWriterCompressionMode::Gzip) {
+            writeAll(buffer.data(), buffer.size());
+            buffer.clear();
+            return;
+        }
+
+        const size_t blockCount = final
+            ? (buffer.size() + kBgzfBlockDataSize - 1) / kBgzfBlockDataSize
+            : buffer.size() / kBgzfBlockDataSize;
+        if (blockCount == 0) {
+            return;
+        }
+        compressBlocks(blockCount);
+        for (size_t i = 0; i < blockCount; ++i) {
+            writeAll(blockOutputs[i].data(), blockSizes[i]);
+        }
+
+        const size_t consumed = std::min(buffer.size(), blockCount * kBgzfBlockDataSize);
+        const size_t tail = buffer.size() - consumed;
+        if (tail > 0) {
+            std::memmove(buffer.data(), buffer.data() + consumed, tail);
+        }
+        buffer.resize(tail);
+    }
+
+    // 并行压缩 buffer 中前 blockCount 个块，结果按顺序存放在 blockOutputs 中
+    void compressBlocks(size_t blockCount) {
+        if (blockOutputs.size() < blockCount) {
+            blockOutputs.resize(blockCount);
+        }
+        blockSizes.resize(blockCount);
+
+        auto compressRange = [this](size_t begin, size_t end) {
+            auto* compressor = compressors->local().get();
+            for (size_t i = begin; i < end; ++i) {
+                const size_t offset = i * kBgzfBlockDataSize;
+                const size_t n = std::min(kBgzfBlockDataSize, buffer.size() - offset);
+                blockOutputs[i].resize(kBgzfMaxBlockSize);
+                blockSizes[i] =
+                    compressBgzfBlock(compressor, buffer.data() + offset, n, blockOutputs[i].data());
+            }
+        };
+
+        if (arena && blockCount > 1) {
+            arena->execute([&] {
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, blockCount, 1),
+                                  [&](const tbb::blocked_range<size_t>& range) {
+                                      compressRange(range.begin(), range.end());
+                                  });
+            });
+        } else {
+            compressRange(0, blockCount);
+        }
+    }
+
+    /**
+     * @brief 写出一批记录
+     * @details 未被修改的记录在批次原文中的文本与重新拼装的结果逐字节相同，相邻的这类记录
+     *          连成一段直接整段写出；只有被修改（或原文为 CRLF、分隔符为制表符等）的记录逐条拼装。
+     */
+    void appendBatch(const FastqBatch& batch) {
+        const std::string_view text = batch.data();
+        size_t runBegin = 0;
+        size_t runEnd = 0;
+        for (const auto& rec : batch) {
+            const auto [begin, end] = originalSpan(rec, text);
+            if (begin < end && begin == runEnd && runEnd > runBegin) {
+                runEnd = end;
+                continue;
+            }
+            appendRaw(text.data() + runBegin, runEnd - runBegin);
+            runBegin = begin;
+            runEnd = end;
+            if (begin == end) {
+                appendRecord(rec);
+            }
+        }
+        appendRaw(text.data() + runBegin, runEnd - runBegin);
+    }
+
+    /**
+     * @brief 记录在 text 中的完整文本 [begin, end)（从 '@' 到质量行的换行符）
+     * @return 原文与 appendRecord() 拼装的结果不完全相同时返回空区间
+     */
+    static auto originalSpan(const FastqRecord& rec, std::string_view text)
+        -> std::pair<size_t, size_t> {
+        const auto base = reinterpret_cast<uintptr_t>(text.data());
+        const size_t size = text.size();
+        // 不在 text 中的指针（如改写后指向 arena）得到越界的偏移
+        auto offsetOf = [base](std::string_view field) {
+            return static_cast<size_t>(reinterpret_cast<uintptr_t>(field.data()) - base);
+        };
+        auto byteAt = [&](size_t offset, char expected) {
+            return offset < size && text[offset] == expected;
+        };
+
+        const size_t idOffset = offsetOf(rec.id);
+        if (idOffset == 0 || idOffset > size || !byteAt(idOffset - 1, '@')) {
+            return {};
+        }
+        size_t cursor = idOffset + rec.id.size();
+        if (!rec.comment.empty()) {
+            if (!byteAt(cursor, ' ') || offsetOf(rec.comment) != cursor + 1) {
+                return {};
+            }
+            cursor += 1 + rec.comment.size();
+        }
+        if (!byteAt(cursor, '\n') || offsetOf(rec.seq) != cursor + 1) {
+            return {};
+        }
+        cursor += 1 + rec.seq.size();
+        if (!byteAt(cursor, '\n') || !byteAt(cursor + 1, '+')) {
+            return {};
+        }
+        cursor += 2;
+        if (!rec.plus.empty()) {
+            if (offsetOf(rec.plus) != cursor) {
+                return {};
             }
+            cursor += rec.plus.size();
+        }
+        if (!byteAt(cursor, '\n') || offsetOf(rec.qual) != cursor + 1) {
+            return {};
+        }
+        cursor += 1 + rec.qual.size();
+        if (!byteAt(cursor, '\n')) {
+            return {};
+        }
+        return {idOffset - 1, cursor + 1};
+    }
 
-             buffer.clear();
+    // 原样追加一段已是 FASTQ 格式的文本
+    void appendRaw(const char* data, size_t size) {
+        if (size == 0) {
+            return;
+        }
+        totalUncompressedBytes += size;
+
+        if (compression != FastqWriterCompressionMode::Gzip && size >= buffer.capacity()) {
+            // 大段直接从批次内存写出，与缓冲区中已有的数据合并为一次 writev
+            writeGather(buffer.data(), buffer.size(), data, size);
+            buffer.clear();
+            return;
+        }
+        while (size > 0) {
+            if (buffer.size() == buffer.capacity()) {
+                flush(false);
+            }
+            const size_t n = std::min(size, buffer.capacity() - buffer.size());
+            buffer.insert(buffer.end(), data, data + n);
+            data += n;
+            size -= n;
+        }
+    }
+
+    void writeGather(const char* first, size_t firstSize, const char* second, size_t secondSize) {
+        if (uring) {
+            writeAll(first, firstSize);
+            writeAll(second, secondSize);
+            return;
+        }
+        std::array<iovec, 2> parts{iovec{const_cast<char*>(first), firstSize},
+                                   iovec{const_cast<char*>(second), secondSize}};
+        size_t index = firstSize > 0 ? 0 : 1;
+        while (index < parts.size()) {
+            const ssize_t written =
+                ::writev(fd, parts.data() + index, static_cast<int>(parts.size() - index));
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                throw std::runtime_error("Failed to write output file: " + path);
+            }
+            auto remaining = static_cast<size_t>(written);
+            while (index < parts.size() && remaining >= parts[index].iov_len) {
+                remaining -= parts[index].iov_len;
+                ++index;
+            }
+            if (index < parts.size()) {
+                parts[index].iov_base = static_cast<char*>(parts[index].iov_base) + remaining;
+                parts[index].iov_len -= remaining;
+            }
         }
     }
 
@@ -121,7 +415,7 @@ struct FastqWriter::Impl {
         // Calculate size needed
         size_t needed = 1 + rec.id.size() + 1 +  // @ + ID + \n
             rec.seq.size() + 1 +                 // Seq + \n
-            2 +                                  // +\n
+            1 + rec.plus.size() + 1 +            // + + 原 '+' 行内容 + \n
             rec.qual.size() + 1;                 // Qual + \n
 
         if (!rec.comment.empty()) {
@@ -132,16 +426,12 @@ struct FastqWriter::Impl {
 
         // Flush if buffer full
         if (buffer.size() + needed > buffer.capacity()) {
-            flush();
-            
-            // If single record is huge, resize buffer and compressed buffer
-            if (needed > buffer.capacity()) {
-                size_t newCap = std::max(buffer.capacity() * 2, needed + 4096);
-                buffer.reserve(newCap);
+            flush(false);
 
-                if (compression == FastqWriterCompressionMode::Gzip) {
-                    compressedBuffer.resize(libdeflate_gzip_compress_bound(compressor, newCap));
-                }
+            // If single record is huge, grow the buffer
+            if (buffer.size() + needed > buffer.capacity()) {
+                size_t newCap = std::max(buffer.capacity() * 2, buffer.size() + needed + 4096);
+                buffer.reserve(newCap);
             }
         }
 
@@ -159,6 +449,7 @@ struct FastqWriter::Impl {
         buffer.push_back('\n');
 
         buffer.push_back('+');
+        buffer.insert(buffer.end(), rec.plus.begin(), rec.plus.end());
         buffer.push_back('\n');
 
         buffer.insert(buffer.end(), rec.qual.begin(), rec.qual.end());
@@ -183,9 +474,7 @@ bool FastqWriter::isOpen() const {
 }
 
 void FastqWriter::write(const FastqBatch& batch) {
-    for (const auto& rec : batch) {
-        impl_->appendRecord(rec);
-    }
+    impl_->appendBatch(batch);
 }
 
 void FastqWriter::write(const FastqRecord& record) {
@@ -0,0 +1,146 @@
+#include "read_ahead_reader.h"
+
+#include <algorithm>
+#include <cerrno>
+
+namespace fq::io {
+
+ReadAheadReader::ReadAheadReader(Source source, size_t chunkBytes, size_t chunkCount,
+                                 size_t blockBytes, size_t headroom)
+    : source_(std::move(source)),
+      chunkBytes_(std::max<size_t>(1, chunkBytes)),
+      chunkCount_(std::max<size_t>(2, chunkCount)) {
+    setBlockBytes(blockBytes, headroom);
+    thread_ = std::thread([this] { run(); });
+}
+
+ReadAheadReader::~ReadAheadReader() {
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    freeCv_.notify_all();
+    thread_.join();
+}
+
+void ReadAheadReader::setBlockBytes(size_t blockBytes, size_t headroom) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    // 开头预留 headroom 之后至少还能放下一个区间
+    blockBytes_ = std::max(blockBytes, headroom + chunkBytes_);
+    headroom_ = headroom;
+}
+
+void ReadAheadReader::recycle(std::shared_ptr<StreamBlock> block) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.size() < chunkCount_) {
+        free_.push_back(std::move(block));
+    }
+}
+
+// 在锁内调用：优先复用归还的块，容量不足的直接丢弃
+auto ReadAheadReader::nextBlock() -> std::shared_ptr<StreamBlock> {
+    while (!free_.empty()) {
+        auto block = std::move(free_.back());
+        free_.pop_back();
+        if (block->capacity >= blockBytes_) {
+            return block;
+        }
+    }
+    return nullptr;
+}
+
+void ReadAheadReader::run() {
+    std::shared_ptr<StreamBlock> block;
+    size_t end = 0;
+    while (true) {
+        size_t blockBytes = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            freeCv_.wait(lock, [this] { return stopping_ || filled_.size() < chunkCount_; });
+            if (stopping_) {
+                return;
+            }
+            // 当前块放不下一个完整区间时换块，新块从预留的 headroom 之后开始填充
+            if (!block || end + chunkBytes_ > block->capacity) {
+                block = nextBlock();
+                blockBytes = blockBytes_;
+                end = headroom_;
+            }
+        }
+        if (!block) {
+            block = std::make_shared<StreamBlock>(blockBytes);
+        }
+
+        // source 在锁外调用；同一块中 end 之前的数据可能正被读取方与批次使用，这里只写 end 之后
+        Span span{block, end, end};
+        bool atEnd = false;
+        int error = 0;
+        std::exception_ptr exception;
+        try {
+            const ssize_t n = source_(block->data.get() + end, chunkBytes_);
+            if (n < 0) {
+                error = errno != 0 ? errno : EIO;
+                atEnd = true;
+            } else if (n == 0) {
+                atEnd = true;
+            } else {
+                span.end += static_cast<size_t>(n);
+                end = span.end;
+            }
+        } catch (...) {
+            exception = std::current_exception();
+            atEnd = true;
+        }
+
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (span.end > span.begin) {
+                filled_.push_back(std::move(span));
+            }
+            if (atEnd) {
+                finished_ = true;
+                error_ = error;
+                exception_ = exception;
+            }
+        }
+        filledCv_.notify_one();
+        if (atEnd) {
+            return;
+        }
+    }
+}
+
+auto ReadAheadReader::read(size_t size, Span& span) -> ssize_t {
+    if (size == 0) {
+        return 0;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        filledCv_.wait(lock, [this] { return finished_ || !filled_.empty(); });
+
+        // 先交出出错之前已读到的数据，错误在下一次读取时报告
+        if (filled_.empty()) {
+            if (exception_) {
+                std::rethrow_exception(exception_);
+            }
+            if (error_ != 0) {
+                errno = error_;
+                return -1;
+            }
+            return 0;
+        }
+
+        Span& front = filled_.front();
+        span.block = front.block;
+        span.begin = front.begin;
+        span.end = std::min(front.end, front.begin + size);
+        front.begin = span.end;
+        if (front.begin == front.end) {
+            filled_.pop_front();
+        }
+    }
+    freeCv_.notify_one();
+    return static_cast<ssize_t>(span.end - span.begin);
+}
+
+}  // namespace fq::io
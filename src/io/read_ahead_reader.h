@@ -0,0 +1,109 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace fq::io {
+
+/**
+ * @brief 流式读取的数据块，由 Reader 与引用它的批次共享所有权
+ * @details 批次以视图引用块中的一段；末尾不完整的记录留在原处，作为下一批的开头。
+ *          只有块写满换新块时才把这段尾部拷贝一次。
+ */
+struct StreamBlock {
+    std::unique_ptr<char[]> data;
+    size_t capacity = 0;
+
+    explicit StreamBlock(size_t n) : data(new char[n]), capacity(n) {}
+};
+
+/**
+ * @brief 后台预读（内部实现）
+ * @details 专用 I/O 线程反复调用 source，把数据直接读入数据块，已读入的区间放入有界队列；
+ *          read() 从队列头部取出区间，数据留在原处，不再拷贝。磁盘或网络文件系统的等待因此与
+ *          解析、处理重叠，串行读取阶段只在预读跟不上时才阻塞。队列中最多有 chunkCount 个
+ *          不超过 chunkBytes 的区间。
+ *
+ *          每个数据块开头预留 headroom 字节，读取方换到新块时把上一块尚未用完的尾部拷贝到这里，
+ *          与新数据首尾相接。同一块中相继取出的区间彼此相邻。
+ *
+ *          source 的语义与 ::read 相同：返回读取的字节数，0 表示 EOF，负数表示出错（errno 有效）。
+ *          对象存在期间 source 只在 I/O 线程上调用，它访问的状态不能再被其他线程使用；
+ *          需要 seek 时先销毁本对象。
+ */
+class ReadAheadReader {
+public:
+    using Source = std::function<ssize_t(char* dst, size_t size)>;
+
+    /**
+     * @brief 已读入的一段数据，位于 block 的 [begin, end)
+     */
+    struct Span {
+        std::shared_ptr<StreamBlock> block;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    /**
+     * @param chunkBytes 单次调用 source 读取的字节数
+     * @param chunkCount 队列中最多预读的区间数，至少为 2
+     * @param blockBytes 数据块的字节数，见 setBlockBytes()
+     * @param headroom 每个数据块开头预留的字节数
+     */
+    ReadAheadReader(Source source, size_t chunkBytes, size_t chunkCount, size_t blockBytes,
+                    size_t headroom);
+    ~ReadAheadReader();
+
+    ReadAheadReader(const ReadAheadReader&) = delete;
+    ReadAheadReader& operator=(const ReadAheadReader&) = delete;
+
+    /**
+     * @brief 设置之后新开始填充的数据块的大小与开头预留的字节数
+     */
+    void setBlockBytes(size_t blockBytes, size_t headroom);
+
+    /**
+     * @brief 取出下一段至多 size 字节的数据
+     * @return 取出的字节数，0 表示 EOF；source 出错时返回 -1 并设置 errno
+     * @throw source 抛出的异常在此重新抛出
+     */
+    auto read(size_t size, Span& span) -> ssize_t;
+
+    /**
+     * @brief 归还已无其他引用的数据块，供 I/O 线程复用
+     */
+    void recycle(std::shared_ptr<StreamBlock> block);
+
+private:
+    void run();
+    auto nextBlock() -> std::shared_ptr<StreamBlock>;
+
+    Source source_;
+    size_t chunkBytes_;
+    size_t chunkCount_;
+
+    std::mutex mutex_;
+    std::condition_variable filledCv_;
+    std::condition_variable freeCv_;
+    std::deque<Span> filled_;
+    std::vector<std::shared_ptr<StreamBlock>> free_;
+    size_t blockBytes_ = 0;
+    size_t headroom_ = 0;
+    bool finished_ = false;  // I/O 线程已到达 EOF 或出错，不再产出数据
+    bool stopping_ = false;
+    int error_ = 0;
+    std::exception_ptr exception_;
+
+    std::thread thread_;
+};
+
+}  // namespace fq::io
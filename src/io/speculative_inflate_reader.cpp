@@ -0,0 +1,782 @@
+#include "speculative_inflate_reader.h"
+
+#include <libdeflate.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/format.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+namespace fq::io {
+
+namespace {
+
+static_assert(std::endian::native == std::endian::little,
+              "BitReader assumes a little-endian host");
+
+constexpr size_t kWindowSize = 32768;
+constexpr uint16_t kMarkerBase = 256;  // 占位符：kMarkerBase + 窗口内下标
+constexpr unsigned kMaxCodeBits = 15;
+constexpr unsigned kFastBits = 10;
+constexpr size_t kMaxMatch = 258;
+constexpr size_t kMinChunkBytes = 4096;
+
+constexpr std::array<uint16_t, 29> kLengthBase = {3,  4,  5,  6,  7,  8,  9,  10,  11,  13,
+                                                  15, 17, 19, 23, 27, 31, 35, 43,  51,  59,
+                                                  67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<uint8_t, 29> kLengthExtra = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                  2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr std::array<uint16_t, 30> kDistBase = {
+    1,    2,    3,    4,    5,    7,     9,     13,    17,  25,   33,   49,   65,   97,   129,
+    193,  257,  385,  513,  769,  1025,  1537,  2049,  3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr std::array<uint8_t, 30> kDistExtra = {0, 0, 0, 0, 1, 1, 2,  2,  3,  3,  4,  4,  5,  5,  6,
+                                                6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr std::array<uint8_t, 19> kCodeLengthOrder = {16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
+                                                      11, 4,  12, 3, 13, 2, 14, 1, 15};
+
+auto readLe32(const unsigned char* p) -> uint32_t {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+        (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/**
+ * @brief 按 deflate 的 LSB 优先顺序读取比特，越界部分视为 0
+ */
+class BitReader {
+public:
+    BitReader(const unsigned char* data, size_t size, uint64_t bitPos)
+        : data_(data), size_(size), bitPos_(bitPos) {}
+
+    // 返回当前位置起至少 56 个有效比特
+    [[nodiscard]] auto peek() const -> uint64_t {
+        const size_t byte = bitPos_ >> 3;
+        uint64_t value = 0;
+        if (byte + sizeof(value) <= size_) {
+            std::memcpy(&value, data_ + byte, sizeof(value));
+        } else if (byte < size_) {
+            std::memcpy(&value, data_ + byte, size_ - byte);
+        }
+        return value >> (bitPos_ & 7);
+    }
+
+    void skip(unsigned n) {
+        bitPos_ += n;
+    }
+
+    auto bits(unsigned n) -> uint32_t {
+        const auto value = static_cast<uint32_t>(peek() & ((uint64_t{1} << n) - 1));
+        bitPos_ += n;
+        return value;
+    }
+
+    void alignToByte() {
+        bitPos_ = (bitPos_ + 7) & ~uint64_t{7};
+    }
+
+    [[nodiscard]] auto position() const -> uint64_t {
+        return bitPos_;
+    }
+
+    [[nodiscard]] auto overrun() const -> bool {
+        return bitPos_ > static_cast<uint64_t>(size_) * 8;
+    }
+
+    [[nodiscard]] auto data() const -> const unsigned char* {
+        return data_;
+    }
+
+    [[nodiscard]] auto size() const -> size_t {
+        return size_;
+    }
+
+private:
+    const unsigned char* data_;
+    size_t size_;
+    uint64_t bitPos_;
+};
+
+/**
+ * @brief 规范 Huffman 解码表：短码查表，长码按码长逐位匹配
+ */
+class HuffmanTable {
+public:
+    /**
+     * @brief 由码长构造解码表
+     * @return 码长集合超额或不完整时返回 false（只有一个码字的集合除外）
+     */
+    auto build(const uint8_t* lengths, size_t n) -> bool {
+        count_.fill(0);
+        for (size_t i = 0; i < n; ++i) {
+            ++count_[lengths[i]];
+        }
+        const size_t codes = n - count_[0];
+        count_[0] = 0;
+
+        int left = 1;
+        for (unsigned len = 1; len <= kMaxCodeBits; ++len) {
+            left <<= 1;
+            left -= count_[len];
+            if (left < 0) {
+                return false;
+            }
+        }
+        if (left > 0 && codes > 1) {
+            return false;
+        }
+
+        std::array<uint16_t, kMaxCodeBits + 1> offsets{};
+        for (unsigned len = 1; len < kMaxCodeBits; ++len) {
+            offsets[len + 1] = static_cast<uint16_t>(offsets[len] + count_[len]);
+        }
+        for (size_t sym = 0; sym < n; ++sym) {
+            if (lengths[sym] != 0) {
+                symbols_[offsets[lengths[sym]]++] = static_cast<uint16_t>(sym);
+            }
+        }
+
+        fast_.fill(0);
+        uint32_t code = 0;
+        size_t index = 0;
+        for (unsigned len = 1; len <= kFastBits; ++len) {
+            for (unsigned k = 0; k < count_[len]; ++k, ++code) {
+                // deflate 的 Huffman 码按 MSB 优先写入 LSB 优先的比特流，需要反转
+                uint32_t reversed = 0;
+                for (unsigned b = 0; b < len; ++b) {
+                    reversed |= ((code >> b) & 1U) << (len - 1 - b);
+                }
+                const uint32_t entry = (len << 16) | symbols_[index++];
+                for (uint32_t slot = reversed; slot < fast_.size(); slot += (1U << len)) {
+                    fast_[slot] = entry;
+                }
+            }
+            code <<= 1;
+        }
+        return true;
+    }
+
+    /**
+     * @return 解码出的符号；无效码字返回 -1
+     */
+    auto decode(BitReader& in) const -> int {
+        const uint64_t bits = in.peek();
+        const uint32_t entry = fast_[bits & (fast_.size() - 1)];
+        if (entry != 0) {
+            in.skip(entry >> 16);
+            return static_cast<int>(entry & 0xffff);
+        }
+
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (unsigned len = 1; len <= kMaxCodeBits; ++len) {
+            code |= static_cast<int>((bits >> (len - 1)) & 1U);
+            const int count = count_[len];
+            if (code - count < first) {
+                in.skip(len);
+                return symbols_[static_cast<size_t>(index + (code - first))];
+            }
+            index += count;
+            first += count;
+            first <<= 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+
+private:
+    std::array<uint16_t, kMaxCodeBits + 1> count_{};
+    std::array<uint16_t, 288> symbols_{};
+    std::array<uint32_t, size_t{1} << kFastBits> fast_{};
+};
+
+struct FixedTables {
+    HuffmanTable literal;
+    HuffmanTable distance;
+
+    FixedTables() {
+        std::array<uint8_t, 288> lengths{};
+        std::fill(lengths.begin(), lengths.begin() + 144, 8);
+        std::fill(lengths.begin() + 144, lengths.begin() + 256, 9);
+        std::fill(lengths.begin() + 256, lengths.begin() + 280, 7);
+        std::fill(lengths.begin() + 280, lengths.end(), 8);
+        literal.build(lengths.data(), lengths.size());
+        // 距离码 30、31 不会出现在合法数据中，解码时单独拒绝
+        lengths.fill(5);
+        distance.build(lengths.data(), 32);
+    }
+};
+
+auto fixedTables() -> const FixedTables& {
+    static const FixedTables tables;
+    return tables;
+}
+
+auto isTextByte(unsigned c) -> bool {
+    return (c >= 0x20 && c < 0x7f) || c == '\n' || c == '\r' || c == '\t';
+}
+
+enum class BlockStatus : uint8_t {
+    Ok,     ///< 块已解码，后面还有块
+    Final,  ///< 解码了成员的最后一个块
+    Error,  ///< 数据不是合法的 deflate 流
+};
+
+/**
+ * @brief deflate 块解码器
+ * @tparam Sym uint8_t：窗口已知，out 前部即为历史数据；
+ *             uint16_t：窗口未知，超出已解码范围的引用记为占位符
+ */
+template <typename Sym>
+class BlockDecoder {
+public:
+    BlockDecoder(const unsigned char* data, size_t size, uint64_t bitPos, std::vector<Sym>& out,
+                 size_t outSize)
+        : in_(data, size, bitPos), out_(out), outSize_(outSize) {}
+
+    [[nodiscard]] auto position() const -> uint64_t {
+        return in_.position();
+    }
+
+    [[nodiscard]] auto outSize() const -> size_t {
+        return outSize_;
+    }
+
+    // 下一个块是否为非最终的动态 Huffman 块（推测起点只会落在这类块上）
+    [[nodiscard]] auto atDynamicBlock() const -> bool {
+        return (in_.peek() & 0x7) == 0x4;
+    }
+
+    auto decodeBlock(bool textOnly) -> BlockStatus {
+        const bool isFinal = in_.bits(1) != 0;
+        const uint32_t type = in_.bits(2);
+        bool ok = false;
+        switch (type) {
+            case 0:
+                ok = copyStored(textOnly);
+                break;
+            case 1:
+                ok = decodeBody(fixedTables().literal, fixedTables().distance, textOnly);
+                break;
+            case 2: {
+                HuffmanTable literal;
+                HuffmanTable distance;
+                ok = readDynamicTables(literal, distance) &&
+                    decodeBody(literal, distance, textOnly);
+                break;
+            }
+            default:
+                break;
+        }
+        if (!ok || in_.overrun()) {
+            return BlockStatus::Error;
+        }
+        return isFinal ? BlockStatus::Final : BlockStatus::Ok;
+    }
+
+    /**
+     * @brief 连续解码，直到位置不小于 stopBit 的动态块起点或成员结束
+     */
+    auto decodeUntil(uint64_t stopBit) -> BlockStatus {
+        while (true) {
+            const BlockStatus status = decodeBlock(false);
+            if (status != BlockStatus::Ok) {
+                return status;
+            }
+            if (in_.position() >= stopBit && atDynamicBlock()) {
+                return BlockStatus::Ok;
+            }
+        }
+    }
+
+private:
+    void reserve(size_t extra) {
+        if (outSize_ + extra > out_.size()) {
+            out_.resize(std::max(out_.size() * 2, outSize_ + extra + 65536));
+        }
+    }
+
+    auto copyStored(bool textOnly) -> bool {
+        in_.alignToByte();
+        const uint32_t len = in_.bits(16);
+        const uint32_t nlen = in_.bits(16);
+        if (len != (~nlen & 0xffffU)) {
+            return false;
+        }
+        const size_t byte = in_.position() >> 3;
+        if (byte + len > in_.size()) {
+            return false;
+        }
+        reserve(len);
+        const unsigned char* src = in_.data() + byte;
+        for (size_t i = 0; i < len; ++i) {
+            if (textOnly && !isTextByte(src[i])) {
+                return false;
+            }
+            out_[outSize_++] = static_cast<Sym>(src[i]);
+        }
+        in_.skip(len * 8);
+        return true;
+    }
+
+    auto readDynamicTables(HuffmanTable& literal, HuffmanTable& distance) -> bool {
+        const uint32_t hlit = in_.bits(5) + 257;
+        const uint32_t hdist = in_.bits(5) + 1;
+        const uint32_t hclen = in_.bits(4) + 4;
+        if (hlit > 286 || hdist > 30) {
+            return false;
+        }
+
+        std::array<uint8_t, 19> codeLengthLengths{};
+        for (uint32_t i = 0; i < hclen; ++i) {
+            codeLengthLengths[kCodeLengthOrder[i]] = static_cast<uint8_t>(in_.bits(3));
+        }
+        HuffmanTable codeLengths;
+        if (!codeLengths.build(codeLengthLengths.data(), codeLengthLengths.size())) {
+            return false;
+        }
+
+        std::array<uint8_t, 286 + 30> lengths{};
+        uint32_t index = 0;
+        while (index < hlit + hdist) {
+            const int sym = codeLengths.decode(in_);
+            if (sym < 0) {
+                return false;
+            }
+            if (sym < 16) {
+                lengths[index++] = static_cast<uint8_t>(sym);
+                continue;
+            }
+            uint8_t value = 0;
+            uint32_t repeat = 0;
+            if (sym == 16) {
+                if (index == 0) {
+                    return false;
+                }
+                value = lengths[index - 1];
+                repeat = 3 + in_.bits(2);
+            } else if (sym == 17) {
+                repeat = 3 + in_.bits(3);
+            } else {
+                repeat = 11 + in_.bits(7);
+            }
+            if (index + repeat > hlit + hdist) {
+                return false;
+            }
+            std::fill_n(lengths.begin() + index, repeat, value);
+            index += repeat;
+        }
+        if (lengths[256] == 0) {
+            return false;
+        }
+        return literal.build(lengths.data(), hlit) &&
+            distance.build(lengths.data() + hlit, hdist);
+    }
+
+    auto decodeBody(const HuffmanTable& literal, const HuffmanTable& distance, bool textOnly)
+        -> bool {
+        while (true) {
+            if (in_.overrun()) {
+                return false;
+            }
+            reserve(kMaxMatch);
+            int sym = literal.decode(in_);
+            if (sym < 0) {
+                return false;
+            }
+            if (sym < 256) {
+                if (textOnly && !isTextByte(static_cast<unsigned>(sym))) {
+                    return false;
+                }
+                out_[outSize_++] = static_cast<Sym>(sym);
+                continue;
+            }
+            if (sym == 256) {
+                return true;
+            }
+            sym -= 257;
+            if (sym >= static_cast<int>(kLengthBase.size())) {
+                return false;
+            }
+            const size_t length = kLengthBase[sym] + in_.bits(kLengthExtra[sym]);
+            const int distSym = distance.decode(in_);
+            if (distSym < 0 || distSym >= static_cast<int>(kDistBase.size())) {
+                return false;
+            }
+            const size_t dist = kDistBase[distSym] + in_.bits(kDistExtra[distSym]);
+            if (!copyMatch(length, dist)) {
+                return false;
+            }
+        }
+    }
+
+    auto copyMatch(size_t length, size_t dist) -> bool {
+        if constexpr (sizeof(Sym) == 1) {
+            if (dist > outSize_) {
+                return false;
+            }
+            for (size_t i = 0; i < length; ++i, ++outSize_) {
+                out_[outSize_] = out_[outSize_ - dist];
+            }
+        } else {
+            if (dist > outSize_ + kWindowSize) {
+                return false;
+            }
+            for (size_t i = 0; i < length; ++i, ++outSize_) {
+                out_[outSize_] = outSize_ >= dist
+                    ? out_[outSize_ - dist]
+                    : static_cast<Sym>(kMarkerBase + kWindowSize - (dist - outSize_));
+            }
+        }
+        return true;
+    }
+
+    BitReader in_;
+    std::vector<Sym>& out_;
+    size_t outSize_;
+};
+
+/**
+ * @brief 在 [fromBit, toBit) 中寻找第一个可信的动态块起点
+ * @details 块头必须能构造出合法的 Huffman 表，且整块能解码为文本
+ * @return 找到的比特位置；找不到时返回 toBit
+ */
+auto findBlockStart(const unsigned char* data, size_t size, uint64_t fromBit, uint64_t toBit,
+                    std::vector<uint16_t>& scratch) -> uint64_t {
+    for (uint64_t pos = fromBit; pos < toBit; ++pos) {
+        const uint64_t bits = BitReader(data, size, pos).peek();
+        // BFINAL=0, BTYPE=2, HLIT<=29, HDIST<=29
+        if ((bits & 0x7) != 0x4 || ((bits >> 3) & 0x1f) > 29 || ((bits >> 8) & 0x1f) > 29) {
+            continue;
+        }
+        BlockDecoder<uint16_t> trial(data, size, pos, scratch, 0);
+        if (trial.decodeBlock(true) != BlockStatus::Ok) {
+            continue;
+        }
+        // 后续块的类型也必须合法
+        if ((BitReader(data, size, trial.position()).peek() & 0x6) == 0x6) {
+            continue;
+        }
+        return pos;
+    }
+    return toBit;
+}
+
+/**
+ * @brief 解析 gzip 成员头
+ * @return deflate 数据的起始字节偏移
+ */
+auto parseGzipHeader(const unsigned char* data, size_t size, size_t offset) -> size_t {
+    constexpr uint8_t kFlagHcrc = 0x02;
+    constexpr uint8_t kFlagExtra = 0x04;
+    constexpr uint8_t kFlagName = 0x08;
+    constexpr uint8_t kFlagComment = 0x10;
+
+    auto truncated = [] { return std::runtime_error("Truncated gzip header"); };
+    if (offset + 10 > size) {
+        throw truncated();
+    }
+    const unsigned char* p = data + offset;
+    if (p[0] != 0x1f || p[1] != 0x8b || p[2] != 0x08) {
+        throw std::runtime_error(fmt::format("Invalid gzip header at offset {}", offset));
+    }
+    const uint8_t flags = p[3];
+    size_t pos = offset + 10;
+    if ((flags & kFlagExtra) != 0) {
+        if (pos + 2 > size) {
+            throw truncated();
+        }
+        pos += 2 + (static_cast<size_t>(data[pos]) | (static_cast<size_t>(data[pos + 1]) << 8));
+    }
+    for (const uint8_t flag : {kFlagName, kFlagComment}) {
+        if ((flags & flag) != 0) {
+            const void* nul = pos < size ? std::memchr(data + pos, 0, size - pos) : nullptr;
+            if (nul == nullptr) {
+                throw truncated();
+            }
+            pos = static_cast<size_t>(static_cast<const unsigned char*>(nul) - data) + 1;
+        }
+    }
+    if ((flags & kFlagHcrc) != 0) {
+        pos += 2;
+    }
+    if (pos > size) {
+        throw truncated();
+    }
+    return pos;
+}
+
+struct Chunk {
+    uint64_t searchBit = 0;  // 名义起点
+    uint64_t startBit = 0;   // 实际找到的块起点
+    uint64_t endBit = 0;
+    BlockStatus status = BlockStatus::Error;
+    std::vector<uint16_t> symbols;
+    std::vector<uint16_t> scratch;
+    size_t size = 0;
+    std::array<uint8_t, kWindowSize> window{};  // 该段之前的 32 KiB，右对齐
+};
+
+}  // namespace
+
+struct SpeculativeInflateReader::Impl {
+    const unsigned char* data;
+    size_t size;
+    uint64_t chunkBits;
+    std::unique_ptr<tbb::task_arena> arena;
+    size_t concurrency = 1;
+
+    bool inMember = false;
+    bool isDone = false;
+    size_t memberCount = 0;
+    uint64_t bitPos = 0;
+    uint32_t memberCrc = 0;
+    uint32_t memberSize = 0;
+
+    std::vector<uint8_t> history;  // 最近至多 32 KiB 的输出
+    std::vector<uint8_t> exact;    // 第一段：history + 精确解码的输出
+    std::vector<Chunk> chunks;
+    std::vector<char> output;
+    size_t outputPos = 0;
+
+    uint64_t acceptedSegments = 0;
+    uint64_t discardedSegments = 0;
+
+    Impl(const unsigned char* d, size_t n, size_t threads, size_t chunkBytes)
+        : data(d), size(n), chunkBits(static_cast<uint64_t>(std::max(chunkBytes, kMinChunkBytes)) * 8) {
+        if (threads != 1) {
+            arena = threads == 0 ? std::make_unique<tbb::task_arena>()
+                                 : std::make_unique<tbb::task_arena>(static_cast<int>(threads));
+            arena->initialize();
+            concurrency = static_cast<size_t>(arena->max_concurrency());
+        }
+        chunks.resize(concurrency);
+    }
+
+    auto beginMember() -> bool {
+        const size_t offset = static_cast<size_t>(bitPos >> 3);
+        // 与 gzip 一致：第一个成员之后的非 gzip 数据被忽略
+        if (memberCount > 0 &&
+            (offset + 2 > size || data[offset] != 0x1f || data[offset + 1] != 0x8b)) {
+            return false;
+        }
+        bitPos = static_cast<uint64_t>(parseGzipHeader(data, size, offset)) * 8;
+        history.clear();
+        memberCrc = 0;
+        memberSize = 0;
+        inMember = true;
+        ++memberCount;
+        return true;
+    }
+
+    void endMember(uint64_t endBit) {
+        const size_t footer = static_cast<size_t>((endBit + 7) >> 3);
+        if (footer + 8 > size) {
+            throw std::runtime_error("Truncated gzip input");
+        }
+        if (readLe32(data + footer) != memberCrc || readLe32(data + footer + 4) != memberSize) {
+            throw std::runtime_error("gzip CRC/size mismatch");
+        }
+        bitPos = static_cast<uint64_t>(footer + 8) * 8;
+        inMember = false;
+    }
+
+    // 第 0 段：窗口已知，精确解码
+    void decodeExact(Chunk& chunk, uint64_t stopBit) {
+        exact.resize(std::max(exact.size(), history.size() + kMaxMatch));
+        std::copy(history.begin(), history.end(), exact.begin());
+        BlockDecoder<uint8_t> decoder(data, size, chunk.startBit, exact, history.size());
+        chunk.status = decoder.decodeUntil(stopBit);
+        chunk.endBit = decoder.position();
+        chunk.size = decoder.outSize() - history.size();
+    }
+
+    // 第 k 段：先寻找块起点，再在窗口未知的情况下解码
+    void decodeSpeculative(Chunk& chunk, uint64_t stopBit) {
+        chunk.status = BlockStatus::Error;
+        chunk.size = 0;
+        chunk.startBit = findBlockStart(data, size, chunk.searchBit, stopBit, chunk.scratch);
+        if (chunk.startBit >= stopBit) {
+            return;
+        }
+        BlockDecoder<uint16_t> decoder(data, size, chunk.startBit, chunk.symbols, 0);
+        chunk.status = decoder.decodeUntil(stopBit);
+        chunk.endBit = decoder.position();
+        chunk.size = decoder.outSize();
+    }
+
+    static auto resolve(uint16_t sym, const std::array<uint8_t, kWindowSize>& window) -> uint8_t {
+        return sym < kMarkerBase ? static_cast<uint8_t>(sym) : window[sym - kMarkerBase];
+    }
+
+    static void fillWindow(std::array<uint8_t, kWindowSize>& window, const uint8_t* tail, size_t n) {
+        std::fill(window.begin(), window.end() - static_cast<std::ptrdiff_t>(n), 0);
+        std::copy(tail, tail + n, window.end() - static_cast<std::ptrdiff_t>(n));
+    }
+
+    void decodeRound() {
+        const uint64_t dataBits = static_cast<uint64_t>(size) * 8;
+        size_t count = 1;
+        while (count < concurrency && bitPos + count * chunkBits + 64 < dataBits) {
+            ++count;
+        }
+        for (size_t k = 0; k < count; ++k) {
+            chunks[k].searchBit = bitPos + k * chunkBits;
+        }
+        chunks[0].startBit = bitPos;
+
+        auto decodeRange = [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const uint64_t stopBit = bitPos + (k + 1) * chunkBits;
+                if (k == 0) {
+                    decodeExact(chunks[0], stopBit);
+                } else {
+                    decodeSpeculative(chunks[k], std::min(stopBit, dataBits));
+                }
+            }
+        };
+        if (arena && count > 1) {
+            arena->execute([&] {
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, count, 1),
+                                  [&](const tbb::blocked_range<size_t>& range) {
+                                      decodeRange(range.begin(), range.end());
+                                  });
+            });
+        } else {
+            decodeRange(0, count);
+        }
+
+        if (chunks[0].status == BlockStatus::Error) {
+            throw std::runtime_error(
+                fmt::format("Invalid deflate stream near compressed offset {}", bitPos >> 3));
+        }
+
+        // 只接受与前一个已接受段首尾相接的推测段，并把它们依次移到前部。
+        // 没找到起点（段内没有块边界）或起点不衔接（伪造的块头）的段被跳过，不影响其后的段
+        size_t accepted = 1;
+        for (size_t k = 1; k < count && chunks[accepted - 1].status == BlockStatus::Ok; ++k) {
+            if (chunks[k].status == BlockStatus::Error ||
+                chunks[k].startBit != chunks[accepted - 1].endBit) {
+                continue;
+            }
+            if (k != accepted) {
+                std::swap(chunks[accepted], chunks[k]);
+            }
+            ++accepted;
+        }
+        acceptedSegments += accepted - 1;
+        discardedSegments += count - accepted;
+
+        // 顺序计算每段的窗口：只需解析每段末尾的 32 KiB
+        const size_t exactEnd = history.size() + chunks[0].size;
+        size_t tailSize = std::min(kWindowSize, exactEnd);
+        std::vector<uint8_t> tail(exact.begin() + static_cast<std::ptrdiff_t>(exactEnd - tailSize),
+                                  exact.begin() + static_cast<std::ptrdiff_t>(exactEnd));
+        size_t total = chunks[0].size;
+        for (size_t k = 1; k < accepted; ++k) {
+            Chunk& chunk = chunks[k];
+            fillWindow(chunk.window, tail.data(), tail.size());
+            const size_t take = std::min(kWindowSize, chunk.size);
+            if (take == kWindowSize) {
+                tail.clear();
+            } else if (tail.size() + take > kWindowSize) {
+                tail.erase(tail.begin(),
+                           tail.begin() + static_cast<std::ptrdiff_t>(tail.size() + take - kWindowSize));
+            }
+            for (size_t i = chunk.size - take; i < chunk.size; ++i) {
+                tail.push_back(resolve(chunk.symbols[i], chunk.window));
+            }
+            total += chunk.size;
+        }
+
+        output.resize(total);
+        outputPos = 0;
+        std::copy(exact.begin() + static_cast<std::ptrdiff_t>(history.size()),
+                  exact.begin() + static_cast<std::ptrdiff_t>(exactEnd), output.begin());
+        std::vector<size_t> offsets(accepted, chunks[0].size);
+        for (size_t k = 2; k < accepted; ++k) {
+            offsets[k] = offsets[k - 1] + chunks[k - 1].size;
+        }
+        auto resolveRange = [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const Chunk& chunk = chunks[k];
+                char* dst = output.data() + offsets[k];
+                for (size_t i = 0; i < chunk.size; ++i) {
+                    dst[i] = static_cast<char>(resolve(chunk.symbols[i], chunk.window));
+                }
+            }
+        };
+        if (arena && accepted > 2) {
+            arena->execute([&] {
+                tbb::parallel_for(tbb::blocked_range<size_t>(1, accepted, 1),
+                                  [&](const tbb::blocked_range<size_t>& range) {
+                                      resolveRange(range.begin(), range.end());
+                                  });
+            });
+        } else {
+            resolveRange(1, accepted);
+        }
+
+        memberCrc = libdeflate_crc32(memberCrc, output.data(), output.size());
+        memberSize += static_cast<uint32_t>(output.size());
+        history = std::move(tail);
+
+        const Chunk& last = chunks[accepted - 1];
+        bitPos = last.endBit;
+        if (last.status == BlockStatus::Final) {
+            endMember(last.endBit);
+        }
+    }
+
+    auto refill() -> bool {
+        output.clear();
+        outputPos = 0;
+        while (!isDone) {
+            if (!inMember && !beginMember()) {
+                isDone = true;
+                break;
+            }
+            decodeRound();
+            if (!inMember && bitPos >= static_cast<uint64_t>(size) * 8) {
+                isDone = true;
+            }
+            if (!output.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+SpeculativeInflateReader::SpeculativeInflateReader(const unsigned char* data, size_t size,
+                                                   size_t threads, size_t chunkBytes)
+    : impl_(std::make_unique<Impl>(data, size, threads, chunkBytes)) {}
+
+SpeculativeInflateReader::~SpeculativeInflateReader() = default;
+
+auto SpeculativeInflateReader::read(char* dst, size_t size) -> ssize_t {
+    auto& impl = *impl_;
+    if (impl.outputPos == impl.output.size() && !impl.refill()) {
+        return 0;
+    }
+    const size_t n = std::min(size, impl.output.size() - impl.outputPos);
+    std::memcpy(dst, impl.output.data() + impl.outputPos, n);
+    impl.outputPos += n;
+    return static_cast<ssize_t>(n);
+}
+
+auto SpeculativeInflateReader::acceptedSegments() const -> uint64_t {
+    return impl_->acceptedSegments;
+}
+
+auto SpeculativeInflateReader::discardedSegments() const -> uint64_t {
+    return impl_->discardedSegments;
+}
+
+}  // namespace fq::io
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <sys/types.h>
+
+namespace fq::io {
+
+/**
+ * @brief 普通 gzip 输入的推测式并行解压器（内部实现）
+ * @details 单成员 gzip 没有块索引，无法按成员并行。本类把压缩流按字节位置切成若干段：
+ *          - 第一段从已知的 deflate 块边界开始，使用已知的 32 KiB 窗口精确解码；
+ *          - 其余各段从猜测的位置向后逐位搜索形如动态 Huffman 块头、且能完整解码出文本的位置，
+ *            在窗口未知的情况下解码，引用窗口的字节以占位符记录；
+ *          - 前一段必须恰好结束在后一段的起点（同步），否则丢弃后一段，下一轮从前一段的终点继续；
+ *          - 同步的段用前一段末尾的 32 KiB 替换占位符，得到与顺序解压完全相同的输出。
+ *          每个 gzip 成员结束时校验 CRC32 与 ISIZE。输入必须完整驻留内存（通常为 mmap）。
+ */
+class SpeculativeInflateReader {
+public:
+    /**
+     * @param data 整个 gzip 文件的内容，生命周期由调用方保证
+     * @param size 文件字节数
+     * @param threads 解压线程数：1 为串行，0 为使用全部可用核心
+     * @param chunkBytes 每个线程每轮处理的压缩数据量
+     */
+    SpeculativeInflateReader(const unsigned char* data, size_t size, size_t threads,
+                             size_t chunkBytes);
+    ~SpeculativeInflateReader();
+
+    SpeculativeInflateReader(const SpeculativeInflateReader&) = delete;
+    SpeculativeInflateReader& operator=(const SpeculativeInflateReader&) = delete;
+
+    /**
+     * @brief 读取至多 size 字节的解压数据
+     * @return 实际读取的字节数，0 表示 EOF
+     * @throw std::runtime_error gzip 头或 deflate 流无效、数据截断或 CRC 校验失败
+     */
+    auto read(char* dst, size_t size) -> ssize_t;
+
+    /// 已接受的推测段数（不含每轮精确解码的第一段）
+    [[nodiscard]] auto acceptedSegments() const -> uint64_t;
+
+    /// 被丢弃的推测段数：起点与前一段终点不一致（如落在伪造的块头上）或前面已有段被丢弃
+    [[nodiscard]] auto discardedSegments() const -> uint64_t;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace fq::io
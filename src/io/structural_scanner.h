@@ -0,0 +1,134 @@
+#pragma once
+
+#include "fqtools/common/simd.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace fq::io {
+
+/**
+ * @brief FASTQ 文本的结构字符扫描器（内部实现）
+ * @details 每次用 ByteKernels::structuralMasks 对 1 KiB 数据一次算出换行符与空格/制表符的位图，
+ *          之后按位图逐个取出位置，不再对每一行调用 memchr。末尾不足 64 字节的部分先拷贝到
+ *          补零的临时块再计算，位图中不会出现越界的位置。
+ *          换行符只能按地址递增的顺序取出，与解析器从前往后处理记录的顺序一致。
+ *          标量级别下逐字节生成位图反而比 libc 的 memchr 慢，此时直接用 memchr 查找。
+ */
+class StructuralScanner {
+public:
+    StructuralScanner(const char* data,
+                      const char* end,
+                      const fq::common::ByteKernels& kernels = fq::common::byteKernels())
+        : end_(end),
+          kernels_(&kernels),
+          useBitmaps_(kernels.structuralMasks !=
+                      fq::common::byteKernels(fq::common::SimdLevel::Scalar).structuralMasks) {
+        if (useBitmaps_) {
+            refill(data);
+        }
+    }
+
+    /**
+     * @brief 不早于 from 的第一个换行符
+     * @return 换行符的位置；其后没有换行符时返回 nullptr
+     */
+    auto nextNewline(const char* from) -> const char* {
+        if (!useBitmaps_) {
+            return from < end_ ? static_cast<const char*>(
+                                     std::memchr(from, '\n', static_cast<size_t>(end_ - from)))
+                               : nullptr;
+        }
+        while (true) {
+            while (bits_ == 0) {
+                if (++block_ >= blockCount_) {
+                    if (groupEnd_ >= end_) {
+                        return nullptr;
+                    }
+                    refill(groupEnd_);
+                } else {
+                    bits_ = newlines_[block_];
+                }
+            }
+            const char* pos = groupBase_ + block_ * kBlockBytes +
+                              static_cast<size_t>(std::countr_zero(bits_));
+            bits_ &= bits_ - 1;
+            if (pos >= from) {
+                return pos;
+            }
+        }
+    }
+
+    /**
+     * @brief [from, limit) 中第一个空格或制表符，没有时返回 limit
+     * @details 区间在当前位图范围内时直接查位图，否则（区间跨越 1 KiB 分组，较少见）逐字节查找。
+     */
+    [[nodiscard]] auto findSeparator(const char* from, const char* limit) const -> const char* {
+        if (!useBitmaps_ || from < groupBase_ || limit > groupEnd_) {
+            for (const char* p = from; p < limit; ++p) {
+                if (*p == ' ' || *p == '\t') {
+                    return p;
+                }
+            }
+            return limit;
+        }
+        auto offset = static_cast<size_t>(from - groupBase_);
+        for (size_t k = offset / kBlockBytes; k < blockCount_; ++k) {
+            uint64_t bits = separators_[k];
+            if (k == offset / kBlockBytes) {
+                bits &= ~uint64_t{0} << (offset % kBlockBytes);
+            }
+            if (bits != 0) {
+                const char* pos =
+                    groupBase_ + k * kBlockBytes + static_cast<size_t>(std::countr_zero(bits));
+                return pos < limit ? pos : limit;
+            }
+            if (groupBase_ + (k + 1) * kBlockBytes >= limit) {
+                break;
+            }
+        }
+        return limit;
+    }
+
+private:
+    static constexpr size_t kBlockBytes = 64;
+    static constexpr size_t kGroupBlocks = 16;
+
+    // 计算从 base 开始的一组位图
+    void refill(const char* base) {
+        const auto remaining = static_cast<size_t>(end_ - base);
+        const size_t fullBlocks = std::min(kGroupBlocks, remaining / kBlockBytes);
+        kernels_->structuralMasks(base, fullBlocks, newlines_.data(), separators_.data());
+        blockCount_ = fullBlocks;
+        if (fullBlocks < kGroupBlocks && remaining % kBlockBytes != 0) {
+            std::array<char, kBlockBytes> tail{};
+            const size_t tailBytes = remaining % kBlockBytes;
+            std::memcpy(tail.data(), base + fullBlocks * kBlockBytes, tailBytes);
+            kernels_->structuralMasks(tail.data(), 1, &newlines_[fullBlocks],
+                                      &separators_[fullBlocks]);
+            ++blockCount_;
+        }
+        groupBase_ = base;
+        groupEnd_ = base + std::min(remaining, blockCount_ * kBlockBytes);
+        block_ = 0;
+        bits_ = blockCount_ > 0 ? newlines_[0] : 0;
+    }
+
+    const char* end_;
+    const fq::common::ByteKernels* kernels_;
+    bool useBitmaps_;
+
+    std::array<uint64_t, kGroupBlocks> newlines_{};
+    std::array<uint64_t, kGroupBlocks> separators_{};
+    const char* groupBase_ = nullptr;
+    const char* groupEnd_ = nullptr;
+    size_t blockCount_ = 0;
+    size_t block_ = 0;
+    uint64_t bits_ = 0;
+};
+
+}  // namespace fq::io
@@ -0,0 +1,525 @@
+#include "uring_file.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define FQ_HAVE_IO_URING 1
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#ifdef FQ_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace fq::io {
+
+#ifdef FQ_HAVE_IO_URING
+
+namespace {
+
+/**
+ * @brief 最小的 io_uring 封装：一对提交/完成队列与一组注册的固定缓冲区
+ * @details 直接使用内核 UAPI（io_uring_setup/enter/register），不依赖 liburing。
+ *          只由一个线程使用；调用方保证在途请求数不超过创建时的 entries。
+ */
+class Ring {
+public:
+    explicit Ring(int fd) : fd_(fd) {}
+
+    ~Ring() {
+        if (sqes_ != nullptr) {
+            ::munmap(sqes_, sqesBytes_);
+        }
+        if (cqRing_ != nullptr && cqRing_ != sqRing_) {
+            ::munmap(cqRing_, cqRingBytes_);
+        }
+        if (sqRing_ != nullptr) {
+            ::munmap(sqRing_, sqRingBytes_);
+        }
+        ::close(fd_);
+    }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    static auto create(unsigned entries, const std::vector<iovec>& buffers) -> std::unique_ptr<Ring> {
+        io_uring_params params{};
+        const auto fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return nullptr;
+        }
+        auto ring = std::make_unique<Ring>(fd);
+        if (!ring->map(params)) {
+            return nullptr;
+        }
+        if (!buffers.empty() &&
+            ::syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, buffers.data(),
+                      static_cast<unsigned>(buffers.size())) < 0) {
+            return nullptr;
+        }
+        return ring;
+    }
+
+    // 准备一个针对固定缓冲区 bufIndex 的读写请求，由下一次 submit()/wait() 提交
+    void prepare(uint8_t opcode, int fd, unsigned bufIndex, char* addr, size_t len,
+                 uint64_t offset, uint64_t userData) {
+        const unsigned tail = *sqTail_;
+        const unsigned index = tail & *sqMask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = opcode;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(addr);
+        sqe.len = static_cast<uint32_t>(len);
+        sqe.off = offset;
+        sqe.buf_index = static_cast<uint16_t>(bufIndex);
+        sqe.user_data = userData;
+        sqArray_[index] = index;
+        std::atomic_ref<unsigned>(*sqTail_).store(tail + 1, std::memory_order_release);
+        ++unsubmitted_;
+    }
+
+    [[nodiscard]] auto hasUnsubmitted() const -> bool { return unsubmitted_ > 0; }
+
+    /**
+     * @brief 提交已准备的请求，并等待至少 minComplete 个完成
+     * @return 0 或 errno
+     */
+    auto submit(unsigned minComplete) -> int {
+        while (true) {
+            const auto submitted = ::syscall(__NR_io_uring_enter, fd_, unsubmitted_, minComplete,
+                                             minComplete > 0 ? IORING_ENTER_GETEVENTS : 0U,
+                                             nullptr, 0);
+            if (submitted < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return errno;
+            }
+            unsubmitted_ -= std::min(unsubmitted_, static_cast<unsigned>(submitted));
+            return 0;
+        }
+    }
+
+    // 取出一个完成事件，没有时返回 false
+    auto pop(io_uring_cqe& out) -> bool {
+        const unsigned head = *cqHead_;
+        if (head == std::atomic_ref<unsigned>(*cqTail_).load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = cqes_[head & *cqMask_];
+        std::atomic_ref<unsigned>(*cqHead_).store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 提交已准备的请求并等待一个完成事件
+     * @return 0 或 errno
+     */
+    auto wait(io_uring_cqe& out) -> int {
+        while (!pop(out)) {
+            if (const int err = submit(1); err != 0) {
+                return err;
+            }
+        }
+        return 0;
+    }
+
+private:
+    auto map(const io_uring_params& params) -> bool {
+        sqRingBytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingBytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) {
+            sqRingBytes_ = cqRingBytes_ = std::max(sqRingBytes_, cqRingBytes_);
+        }
+
+        sqRing_ = mapRegion(sqRingBytes_, IORING_OFF_SQ_RING);
+        if (sqRing_ == nullptr) {
+            return false;
+        }
+        cqRing_ = singleMap ? sqRing_ : mapRegion(cqRingBytes_, IORING_OFF_CQ_RING);
+        if (cqRing_ == nullptr) {
+            return false;
+        }
+        sqesBytes_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(mapRegion(sqesBytes_, IORING_OFF_SQES));
+        if (sqes_ == nullptr) {
+            return false;
+        }
+
+        auto* sq = static_cast<char*>(sqRing_);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        auto* cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    auto mapRegion(size_t bytes, off_t offset) const -> void* {
+        void* addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            fd_, offset);
+        return addr == MAP_FAILED ? nullptr : addr;
+    }
+
+    int fd_;
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqRingBytes_ = 0;
+    size_t cqRingBytes_ = 0;
+    size_t sqesBytes_ = 0;
+
+    unsigned* sqTail_ = nullptr;
+    unsigned* sqMask_ = nullptr;
+    unsigned* sqArray_ = nullptr;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned* cqMask_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned unsubmitted_ = 0;
+};
+
+// 分配 count 个 bytes 大小的缓冲区，并生成注册用的 iovec
+auto allocateBuffers(size_t count, size_t bytes, std::vector<std::unique_ptr<char[]>>& storage)
+    -> std::vector<iovec> {
+    std::vector<iovec> iovecs;
+    for (size_t i = 0; i < count; ++i) {
+        storage.emplace_back(new char[bytes]);
+        iovecs.push_back(iovec{storage.back().get(), bytes});
+    }
+    return iovecs;
+}
+
+auto isRetryable(int res) -> bool {
+    return res == -EINTR || res == -EAGAIN;
+}
+
+}  // namespace
+
+auto ioUringSupported() -> bool {
+    static const bool supported = Ring::create(1, {}) != nullptr;
+    return supported;
+}
+
+struct UringFileReader::Impl {
+    struct Slot {
+        uint64_t offset = 0;
+        size_t length = 0;    // 请求的字节数，0 表示已到达 end
+        size_t filled = 0;    // 已读入的字节数
+        size_t consumed = 0;  // 已交出的字节数
+        bool inFlight = false;
+        int error = 0;
+    };
+
+    int fd;
+    uint64_t nextOffset;
+    uint64_t end;
+    size_t bufferBytes;
+    // 缓冲区须在 ring 之后销毁
+    std::vector<std::unique_ptr<char[]>> buffers;
+    std::vector<Slot> slots;
+    std::unique_ptr<Ring> ring;
+    size_t head = 0;
+    size_t inFlight = 0;
+    int ringError = 0;
+
+    Impl(int f, uint64_t begin, uint64_t e, size_t bytes)
+        : fd(f), nextOffset(begin), end(std::max(begin, e)), bufferBytes(bytes) {}
+
+    ~Impl() {
+        // 在途请求仍会写入缓冲区，等它们完成后再释放
+        io_uring_cqe cqe{};
+        while (inFlight > 0 && ring->wait(cqe) == 0) {
+            slots[cqe.user_data].inFlight = false;
+            --inFlight;
+        }
+    }
+
+    void submitRead(size_t i) {
+        Slot& slot = slots[i];
+        ring->prepare(IORING_OP_READ_FIXED, fd, static_cast<unsigned>(i),
+                      buffers[i].get() + slot.filled, slot.length - slot.filled,
+                      slot.offset + slot.filled, i);
+        slot.inFlight = true;
+        ++inFlight;
+    }
+
+    void startSlot(size_t i) {
+        Slot& slot = slots[i];
+        slot = Slot{};
+        slot.offset = nextOffset;
+        slot.length = nextOffset < end
+            ? static_cast<size_t>(std::min<uint64_t>(bufferBytes, end - nextOffset))
+            : 0;
+        if (slot.length > 0) {
+            nextOffset += slot.length;
+            submitRead(i);
+        }
+    }
+
+    void complete(const io_uring_cqe& cqe) {
+        const auto i = static_cast<size_t>(cqe.user_data);
+        Slot& slot = slots[i];
+        slot.inFlight = false;
+        --inFlight;
+        if (isRetryable(cqe.res)) {
+            submitRead(i);
+        } else if (cqe.res < 0) {
+            slot.error = -cqe.res;
+        } else if (cqe.res == 0) {
+            // 文件比打开时短（被截断）：此后不再有数据
+            slot.length = slot.filled;
+            end = std::min(end, slot.offset + slot.filled);
+        } else {
+            slot.filled += static_cast<size_t>(cqe.res);
+            if (slot.filled < slot.length) {
+                submitRead(i);
+            }
+        }
+    }
+
+    auto read(char* dst, size_t size) -> ssize_t {
+        if (size == 0) {
+            return 0;
+        }
+        Slot& slot = slots[head];
+        while (slot.inFlight && ringError == 0) {
+            io_uring_cqe cqe{};
+            ringError = ring->wait(cqe);
+            if (ringError == 0) {
+                complete(cqe);
+            }
+        }
+        const int error = ringError != 0 ? ringError : slot.error;
+        if (error != 0) {
+            errno = error;
+            return -1;
+        }
+        if (slot.consumed == slot.length) {
+            return 0;
+        }
+
+        const size_t n = std::min(size, slot.length - slot.consumed);
+        std::memcpy(dst, buffers[head].get() + slot.consumed, n);
+        slot.consumed += n;
+        if (slot.consumed == slot.length) {
+            startSlot(head);
+            head = (head + 1) % slots.size();
+        }
+        if (ring->hasUnsubmitted()) {
+            ringError = ring->submit(0);
+        }
+        return static_cast<ssize_t>(n);
+    }
+};
+
+auto UringFileReader::create(int fd, uint64_t begin, uint64_t end, size_t bufferBytes,
+                             size_t depth) -> std::unique_ptr<UringFileReader> {
+    bufferBytes = std::max<size_t>(1, bufferBytes);
+    depth = std::max<size_t>(1, depth);
+    auto impl = std::make_unique<Impl>(fd, begin, end, bufferBytes);
+    const auto iovecs = allocateBuffers(depth, bufferBytes, impl->buffers);
+    impl->ring = Ring::create(static_cast<unsigned>(depth), iovecs);
+    if (!impl->ring) {
+        return nullptr;
+    }
+    impl->slots.resize(depth);
+    for (size_t i = 0; i < depth; ++i) {
+        impl->startSlot(i);
+    }
+    impl->ringError = impl->ring->submit(0);
+    return std::unique_ptr<UringFileReader>(new UringFileReader(std::move(impl)));
+}
+
+struct UringFileWriter::Impl {
+    struct Slot {
+        uint64_t offset = 0;
+        size_t used = 0;     // 已拷入的字节数
+        size_t written = 0;  // 已写出的字节数
+        bool inFlight = false;
+    };
+
+    int fd;
+    uint64_t nextOffset;
+    size_t bufferBytes;
+    // 缓冲区须在 ring 之后销毁
+    std::vector<std::unique_ptr<char[]>> buffers;
+    std::vector<Slot> slots;
+    std::unique_ptr<Ring> ring;
+    size_t current = 0;
+    size_t inFlight = 0;
+    int error = 0;
+
+    Impl(int f, uint64_t offset, size_t bytes) : fd(f), nextOffset(offset), bufferBytes(bytes) {}
+
+    ~Impl() {
+        io_uring_cqe cqe{};
+        while (inFlight > 0 && ring->wait(cqe) == 0) {
+            slots[cqe.user_data].inFlight = false;
+            --inFlight;
+        }
+    }
+
+    void submitWrite(size_t i) {
+        Slot& slot = slots[i];
+        ring->prepare(IORING_OP_WRITE_FIXED, fd, static_cast<unsigned>(i),
+                      buffers[i].get() + slot.written, slot.used - slot.written,
+                      slot.offset + slot.written, i);
+        slot.inFlight = true;
+        ++inFlight;
+    }
+
+    // 提交当前缓冲区，之后改为填充下一个
+    void submitCurrent() {
+        Slot& slot = slots[current];
+        slot.offset = nextOffset;
+        slot.written = 0;
+        nextOffset += slot.used;
+        submitWrite(current);
+        if (const int err = ring->submit(0); err != 0 && error == 0) {
+            error = err;
+        }
+        current = (current + 1) % slots.size();
+    }
+
+    void complete(const io_uring_cqe& cqe) {
+        const auto i = static_cast<size_t>(cqe.user_data);
+        Slot& slot = slots[i];
+        slot.inFlight = false;
+        --inFlight;
+        if (isRetryable(cqe.res)) {
+            submitWrite(i);
+            return;
+        }
+        if (cqe.res <= 0) {
+            if (error == 0) {
+                error = cqe.res < 0 ? -cqe.res : EIO;
+            }
+            return;
+        }
+        slot.written += static_cast<size_t>(cqe.res);
+        if (slot.written < slot.used) {
+            submitWrite(i);
+        } else {
+            slot.used = 0;
+            slot.written = 0;
+        }
+    }
+
+    void waitOne() {
+        io_uring_cqe cqe{};
+        if (const int err = ring->wait(cqe); err != 0) {
+            error = err;
+            return;
+        }
+        complete(cqe);
+    }
+
+    auto write(const char* data, size_t size) -> int {
+        while (size > 0 && error == 0) {
+            while (slots[current].inFlight && error == 0) {
+                waitOne();
+            }
+            if (error != 0) {
+                break;
+            }
+            Slot& slot = slots[current];
+            const size_t n = std::min(bufferBytes - slot.used, size);
+            std::memcpy(buffers[current].get() + slot.used, data, n);
+            slot.used += n;
+            data += n;
+            size -= n;
+            if (slot.used == bufferBytes) {
+                submitCurrent();
+            }
+        }
+        return error;
+    }
+
+    auto finish() -> int {
+        if (error == 0 && !slots[current].inFlight && slots[current].used > 0) {
+            submitCurrent();
+        }
+        while (inFlight > 0 && error == 0) {
+            waitOne();
+        }
+        return error;
+    }
+};
+
+auto UringFileWriter::create(int fd, uint64_t offset, size_t bufferBytes, size_t depth)
+    -> std::unique_ptr<UringFileWriter> {
+    bufferBytes = std::max<size_t>(1, bufferBytes);
+    depth = std::max<size_t>(1, depth);
+    auto impl = std::make_unique<Impl>(fd, offset, bufferBytes);
+    const auto iovecs = allocateBuffers(depth, bufferBytes, impl->buffers);
+    impl->ring = Ring::create(static_cast<unsigned>(depth), iovecs);
+    if (!impl->ring) {
+        return nullptr;
+    }
+    impl->slots.resize(depth);
+    return std::unique_ptr<UringFileWriter>(new UringFileWriter(std::move(impl)));
+}
+
+#else  // FQ_HAVE_IO_URING
+
+auto ioUringSupported() -> bool {
+    return false;
+}
+
+struct UringFileReader::Impl {
+    auto read(char* /*dst*/, size_t /*size*/) -> ssize_t {
+        errno = ENOSYS;
+        return -1;
+    }
+};
+
+auto UringFileReader::create(int /*fd*/, uint64_t /*begin*/, uint64_t /*end*/,
+                             size_t /*bufferBytes*/, size_t /*depth*/)
+    -> std::unique_ptr<UringFileReader> {
+    return nullptr;
+}
+
+struct UringFileWriter::Impl {
+    auto write(const char* /*data*/, size_t /*size*/) -> int { return ENOSYS; }
+    auto finish() -> int { return ENOSYS; }
+};
+
+auto UringFileWriter::create(int /*fd*/, uint64_t /*offset*/, size_t /*bufferBytes*/,
+                             size_t /*depth*/) -> std::unique_ptr<UringFileWriter> {
+    return nullptr;
+}
+
+#endif  // FQ_HAVE_IO_URING
+
+UringFileReader::UringFileReader(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+UringFileReader::~UringFileReader() = default;
+
+auto UringFileReader::read(char* dst, size_t size) -> ssize_t {
+    return impl_->read(dst, size);
+}
+
+UringFileWriter::UringFileWriter(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+UringFileWriter::~UringFileWriter() = default;
+
+auto UringFileWriter::write(const char* data, size_t size) -> int {
+    return impl_->write(data, size);
+}
+
+auto UringFileWriter::finish() -> int {
+    return impl_->finish();
+}
+
+}  // namespace fq::io
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <sys/types.h>
+
+namespace fq::io {
+
+/// Reader/Writer 默认保持的在途请求数
+inline constexpr size_t kUringQueueDepth = 4;
+
+/**
+ * @brief 当前内核与构建是否支持 io_uring
+ * @details 非 Linux 构建、内核过旧或被 seccomp 禁用（常见于容器）时返回 false，
+ *          此时 UringFileReader/UringFileWriter::create() 同样返回 nullptr，调用方使用同步读写。
+ */
+[[nodiscard]] auto ioUringSupported() -> bool;
+
+/**
+ * @brief 基于 io_uring 的顺序文件读取（内部实现）
+ * @details 在注册的固定缓冲区上保持 depth 个读请求在途，按文件顺序交出数据，
+ *          不需要额外线程即可让 I/O 与解析、处理重叠。只适用于常规文件：请求带显式偏移，
+ *          不使用也不改变文件描述符的当前位置。
+ */
+class UringFileReader {
+public:
+    /**
+     * @brief 读取 fd 的 [begin, end)
+     * @param bufferBytes 每个在途请求的字节数
+     * @param depth 在途请求数
+     * @return 不支持 io_uring 或无法注册缓冲区（如超出 RLIMIT_MEMLOCK）时返回 nullptr
+     */
+    [[nodiscard]] static auto create(int fd, uint64_t begin, uint64_t end, size_t bufferBytes,
+                                     size_t depth) -> std::unique_ptr<UringFileReader>;
+    ~UringFileReader();
+
+    UringFileReader(const UringFileReader&) = delete;
+    UringFileReader& operator=(const UringFileReader&) = delete;
+
+    /**
+     * @brief 读取至多 size 字节，语义与 ::read 相同
+     * @return 实际读取的字节数，0 表示到达 end；出错时返回 -1 并设置 errno
+     */
+    auto read(char* dst, size_t size) -> ssize_t;
+
+private:
+    struct Impl;
+    explicit UringFileReader(std::unique_ptr<Impl> impl);
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief 基于 io_uring 的顺序文件写出（内部实现）
+ * @details 数据先拷入注册的固定缓冲区，缓冲区写满即提交，最多 depth 个写请求在途；
+ *          只有所有缓冲区都在途时 write() 才等待。只适用于常规文件。
+ */
+class UringFileWriter {
+public:
+    /**
+     * @brief 从 offset 处开始写 fd
+     * @return 不支持 io_uring 或无法注册缓冲区时返回 nullptr
+     */
+    [[nodiscard]] static auto create(int fd, uint64_t offset, size_t bufferBytes, size_t depth)
+        -> std::unique_ptr<UringFileWriter>;
+    ~UringFileWriter();
+
+    UringFileWriter(const UringFileWriter&) = delete;
+    UringFileWriter& operator=(const UringFileWriter&) = delete;
+
+    /**
+     * @brief 追加数据
+     * @return 0 表示成功，否则为之前某个写请求失败的 errno
+     */
+    auto write(const char* data, size_t size) -> int;
+
+    /**
+     * @brief 提交剩余数据并等待所有写请求完成
+     * @return 0 表示成功，否则为 errno
+     */
+    auto finish() -> int;
+
+private:
+    struct Impl;
+    explicit UringFileWriter(std::unique_ptr<Impl> impl);
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace fq::io
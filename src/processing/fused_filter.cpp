@@ -0,0 +1,233 @@
+#include "processing/fused_filter.h"
+
+#include "fqtools/processing/mutators/quality_trimmer.h"
+
+#include <algorithm>
+#include <array>
+#include <typeinfo>
+#include <utility>
+
+namespace fq::processing {
+
+namespace {
+
+template <unsigned kStages>
+auto filterRead(const FusedFilterParams& p, fq::io::FastqRecord& read, FusedBatchCounts& counts)
+    -> bool {
+    constexpr bool kMinQuality = (kStages & kFuseMinQuality) != 0;
+    constexpr bool kMinLength = (kStages & kFuseMinLength) != 0;
+    constexpr bool kMaxLength = (kStages & kFuseMaxLength) != 0;
+    constexpr bool kMaxNRatio = (kStages & kFuseMaxNRatio) != 0;
+    constexpr bool kTrim = (kStages & kFuseQualityTrim) != 0;
+
+    const size_t seqLen = read.seq.size();
+    const size_t qualLen = read.qual.size();
+
+    // 各判定与修剪共用同一份度量，read 只被扫描一次
+    constexpr unsigned kMetrics = (kMinQuality ? kMetricQualitySum : 0U) |
+                                  (kMaxNRatio ? kMetricNCount : 0U) |
+                                  (kTrim ? kMetricHighQualityBounds : 0U);
+    ReadMetrics metrics;
+    if constexpr (kMetrics != 0) {
+        metrics = measureRead(*p.kernels, read, ReadMetricsRequest{kMetrics, p.trimQualityTarget});
+    }
+
+    // 所有谓词都求值，按未通过的位分桶，批末按添加顺序折算各阶段计数
+    unsigned rejected = 0;
+    if constexpr (kMinLength) {
+        rejected |= seqLen < p.minLength ? kFuseMinLength : 0U;
+    }
+    if constexpr (kMaxLength) {
+        rejected |= seqLen > p.maxLength ? kFuseMaxLength : 0U;
+    }
+    if constexpr (kMinQuality) {
+        rejected |= p.minQuality.passes(metrics.qualitySum, qualLen) ? 0U : kFuseMinQuality;
+    }
+    if constexpr (kMaxNRatio) {
+        const double nRatio =
+            seqLen == 0 ? 0.0 : static_cast<double>(metrics.nCount) / static_cast<double>(seqLen);
+        rejected |= nRatio <= p.maxNRatio ? 0U : kFuseMaxNRatio;
+    }
+    counts.rejected[rejected]++;
+    if (rejected != 0) {
+        return false;
+    }
+
+    if constexpr (kTrim) {
+        // 空序列到达修剪器但不修改，随后在压缩记录时丢弃
+        if (seqLen == 0) {
+            return false;
+        }
+        // 与 QualityTrimmer::applyTrim 的边界一致：3' 端只在 5' 修剪后剩余的部分中查找
+        const size_t common = std::min(seqLen, qualLen);
+        const size_t first = metrics.firstHighQuality;
+        size_t start = 0;
+        size_t end = seqLen;
+        if (p.trimFivePrime) {
+            start = first;
+        }
+        if (p.trimThreePrime && start < seqLen) {
+            end = (p.trimFivePrime && first >= common) ? start : metrics.lastHighQuality;
+        }
+        const size_t newLen = end > start ? end - start : 0;
+        if (newLen < p.trimMinLength) {
+            read.seq = {};
+            read.qual = {};
+            counts.trimModified++;
+            counts.trimBasesRemoved += seqLen;
+            return false;
+        }
+        if (newLen < seqLen) {
+            read.seq = read.seq.substr(start, newLen);
+            read.qual = read.qual.substr(start, newLen);
+            counts.trimModified++;
+            counts.trimBasesRemoved += seqLen - newLen;
+        }
+        counts.trimPassed++;
+    }
+    return seqLen != 0;
+}
+
+template <unsigned kStages>
+void filterBatch(const FusedFilterParams& params,
+                 std::span<fq::io::FastqRecord> reads,
+                 ReadPassMask& passMask,
+                 FusedBatchCounts& counts) {
+    for (size_t i = 0; i < reads.size(); ++i) {
+        if (passMask[i] != 0) {
+            passMask[i] = filterRead<kStages>(params, reads[i], counts) ? 1 : 0;
+        }
+    }
+}
+
+using BatchFn = void (*)(const FusedFilterParams&,
+                         std::span<fq::io::FastqRecord>,
+                         ReadPassMask&,
+                         FusedBatchCounts&);
+
+template <size_t... kStages>
+constexpr auto makeBatchTable(std::index_sequence<kStages...> /*unused*/)
+    -> std::array<BatchFn, sizeof...(kStages)> {
+    return {&filterBatch<static_cast<unsigned>(kStages)>...};
+}
+
+// 每种阶段组合一个实例，按 FusedFilterParams::stages 下标选择
+constexpr auto kBatchTable = makeBatchTable(std::make_index_sequence<kFuseAllStages + 1>{});
+
+// 只识别确切类型，派生类可能改变了判定语义
+template <typename T, typename Base>
+auto exactCast(const Base& stage) -> const T* {
+    return typeid(stage) == typeid(T) ? static_cast<const T*>(&stage) : nullptr;
+}
+
+}  // namespace
+
+auto FusedReadFilter::create(
+    const std::vector<std::unique_ptr<ReadPredicateInterface>>& predicates,
+    const std::vector<std::unique_ptr<ReadMutatorInterface>>& mutators)
+    -> std::optional<FusedReadFilter> {
+    FusedFilterParams params;
+    std::vector<unsigned> predicateOrder;
+    auto claim = [&params, &predicateOrder](FusedStage stage) {
+        if ((params.stages & stage) != 0) {
+            return false;
+        }
+        params.stages |= stage;
+        if (stage != kFuseQualityTrim) {
+            predicateOrder.push_back(stage);
+        }
+        return true;
+    };
+
+    for (const auto& predicate : predicates) {
+        if (const auto* p = exactCast<MinQualityPredicate>(*predicate)) {
+            if (!claim(kFuseMinQuality)) {
+                return std::nullopt;
+            }
+            params.minQuality = p->threshold();
+        } else if (const auto* p = exactCast<MinLengthPredicate>(*predicate)) {
+            if (!claim(kFuseMinLength)) {
+                return std::nullopt;
+            }
+            params.minLength = p->minLength();
+        } else if (const auto* p = exactCast<MaxLengthPredicate>(*predicate)) {
+            if (!claim(kFuseMaxLength)) {
+                return std::nullopt;
+            }
+            params.maxLength = p->maxLength();
+        } else if (const auto* p = exactCast<MaxNRatioPredicate>(*predicate)) {
+            if (!claim(kFuseMaxNRatio)) {
+                return std::nullopt;
+            }
+            params.maxNRatio = p->maxNRatio();
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    // 修改器依次作用，只有单个质量修剪器时可以融合
+    if (mutators.size() > 1) {
+        return std::nullopt;
+    }
+    if (mutators.size() == 1) {
+        const auto* trimmer = exactCast<QualityTrimmer>(*mutators.front());
+        if (trimmer == nullptr) {
+            return std::nullopt;
+        }
+        claim(kFuseQualityTrim);
+        const auto mode = trimmer->trimMode();
+        params.trimFivePrime = mode != QualityTrimmer::TrimMode::ThreePrime;
+        params.trimThreePrime = mode != QualityTrimmer::TrimMode::FivePrime;
+        params.trimQualityTarget = trimmer->qualityTarget();
+        params.trimMinLength = trimmer->minLength();
+    }
+
+    if (params.stages == 0) {
+        return std::nullopt;
+    }
+    return FusedReadFilter(params, std::move(predicateOrder));
+}
+
+FusedReadFilter::FusedReadFilter(const FusedFilterParams& params,
+                                 std::vector<unsigned> predicateOrder)
+    : params_(params),
+      predicateOrder_(std::move(predicateOrder)),
+      batchFn_(kBatchTable[params.stages & kFuseAllStages]) {}
+
+void FusedReadFilter::applyBatch(std::span<fq::io::FastqRecord> reads,
+                                 ReadPassMask& passMask,
+                                 ProcessingStatistics& stats) const {
+    FusedBatchCounts counts;
+    batchFn_(params_, reads, passMask, counts);
+
+    const bool trim = (params_.stages & kFuseQualityTrim) != 0;
+    const size_t stageCount = predicateOrder_.size() + (trim ? 1 : 0);
+    if (stats.stages.size() < stageCount) {
+        stats.stages.resize(stageCount);
+    }
+
+    // 每个桶从第一个谓词开始计入，直到遇到第一个未通过的谓词
+    for (unsigned bits = 0; bits < counts.rejected.size(); ++bits) {
+        const std::uint64_t count = counts.rejected[bits];
+        if (count == 0) {
+            continue;
+        }
+        for (size_t k = 0; k < predicateOrder_.size(); ++k) {
+            stats.stages[k].evaluated += count;
+            if ((bits & predicateOrder_[k]) != 0) {
+                break;
+            }
+            stats.stages[k].passed += count;
+        }
+    }
+    if (trim) {
+        auto& trimStage = stats.stages[predicateOrder_.size()];
+        trimStage.evaluated += counts.rejected[0];
+        trimStage.passed += counts.trimPassed;
+        trimStage.modified += counts.trimModified;
+        trimStage.basesRemoved += counts.trimBasesRemoved;
+        stats.modifiedReads += counts.trimModified;
+    }
+}
+
+}  // namespace fq::processing
@@ -0,0 +1,122 @@
+#pragma once
+
+/**
+ * @file fused_filter.h
+ * @brief 常用过滤组合的静态融合实现
+ * @details filter 命令最常见的组合（--min-quality、--min-length、--max-length、
+ *          --max-n-ratio、--trim-quality）由模板按启用的阶段实例化为一个逐 read 函数：
+ *          所有判定与质量修剪共用同一份 ReadMetrics，每条 read 只扫描一次，阶段之间没有虚调用。
+ *          实例在启动时按已注册的谓词与修改器选定；不在支持范围内的组合走通用的虚函数路径。
+ *
+ * @author LessUp
+ * @date 2026-10-17
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2026 LessUp
+ */
+
+#include "fqtools/common/simd.h"
+#include "fqtools/io/fastq_io.h"
+#include "fqtools/processing/predicates/min_quality_predicate.h"
+#include "fqtools/processing/processing_pipeline_interface.h"
+#include "fqtools/processing/read_metrics.h"
+#include "fqtools/processing/read_mutator_interface.h"
+#include "fqtools/processing/read_predicate_interface.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace fq::processing {
+
+/**
+ * @brief 可融合的阶段，按位组合
+ */
+enum FusedStage : unsigned {
+    kFuseMinQuality = 1U << 0,
+    kFuseMinLength = 1U << 1,
+    kFuseMaxLength = 1U << 2,
+    kFuseMaxNRatio = 1U << 3,
+    kFuseQualityTrim = 1U << 4,
+    kFuseAllStages = (1U << 5) - 1,
+};
+
+/**
+ * @brief 融合路径的参数，取值与对应的谓词/修改器一致
+ */
+struct FusedFilterParams {
+    unsigned stages = 0;  ///< 启用的 FusedStage 位
+    const fq::common::ByteKernels* kernels = &fq::common::byteKernels();
+
+    AverageQualityThreshold minQuality{0.0, 33};
+    size_t minLength = 0;
+    size_t maxLength = 0;
+    double maxNRatio = 0.0;
+
+    bool trimFivePrime = false;
+    bool trimThreePrime = false;
+    int trimQualityTarget = 0;  ///< 见 QualityTrimmer::qualityTarget()
+    size_t trimMinLength = 1;
+};
+
+/**
+ * @brief 一批 read 在融合路径上的计数
+ * @details 谓词阶段按“未通过的谓词位”分桶，批末再按添加顺序折算成各阶段的计数，
+ *          与通用路径逐阶段求值得到的结果一致。
+ */
+struct FusedBatchCounts {
+    std::array<std::uint64_t, kFuseQualityTrim> rejected{};  ///< 下标为未通过的谓词位
+    std::uint64_t trimPassed = 0;
+    std::uint64_t trimModified = 0;
+    std::uint64_t trimBasesRemoved = 0;
+};
+
+/**
+ * @brief 融合的过滤 + 修剪函数
+ * @details 结果与依次调用各谓词的 evaluateBatch() 再调用 QualityTrimmer::processBatch() 一致。
+ */
+class FusedReadFilter {
+public:
+    /**
+     * @brief 按已注册的阶段选择融合实例
+     * @return 谓词均为 MinQuality/MinLength/MaxLength/MaxNRatio（每种至多一个）、
+     *         修改器为空或仅有一个 QualityTrimmer 时返回融合过滤器，否则返回 std::nullopt
+     */
+    static auto create(const std::vector<std::unique_ptr<ReadPredicateInterface>>& predicates,
+                       const std::vector<std::unique_ptr<ReadMutatorInterface>>& mutators)
+        -> std::optional<FusedReadFilter>;
+
+    /**
+     * @param predicateOrder 各谓词对应的 FusedStage 位，按添加顺序
+     */
+    FusedReadFilter(const FusedFilterParams& params, std::vector<unsigned> predicateOrder);
+
+    /**
+     * @brief 过滤并修剪整批 read
+     * @details 只处理 passMask 中为 1 的 read；未通过或修剪后为空的置 0。
+     *          各阶段计数累加到 stats.stages（先谓词后修剪器，按添加顺序）与 stats.modifiedReads。
+     */
+    void applyBatch(std::span<fq::io::FastqRecord> reads,
+                    ReadPassMask& passMask,
+                    ProcessingStatistics& stats) const;
+
+    [[nodiscard]] auto params() const -> const FusedFilterParams& {
+        return params_;
+    }
+
+private:
+    using BatchFn = void (*)(const FusedFilterParams&,
+                             std::span<fq::io::FastqRecord>,
+                             ReadPassMask&,
+                             FusedBatchCounts&);
+
+    FusedFilterParams params_;
+    std::vector<unsigned> predicateOrder_;
+    BatchFn batchFn_;
+};
+
+}  // namespace fq::processing
@@ -1,15 +1,26 @@
 #include "fqtools/processing/mutators/quality_trimmer.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include <fmt/format.h>
 
-#ifdef __AVX2__
-#include <immintrin.h>
-#endif
-
 namespace fq::processing {
 
+namespace {
+
+// 质量分数为整数，q >= threshold 等价于 q >= ceil(threshold)；
+// 结果截断到有符号 char 之外一格，字节内核据此判定“全部/全不”满足
+auto qualityTargetFor(double threshold, int encoding) -> int {
+    if (std::isnan(threshold)) {
+        return 128;
+    }
+    const double target = std::ceil(threshold) + encoding;
+    return static_cast<int>(std::clamp(target, -129.0, 128.0));
+}
+
+}  // namespace
+
 // --- QualityTrimmer ---
 
 QualityTrimmer::QualityTrimmer(double qualityThreshold,
@@ -19,33 +30,70 @@ QualityTrimmer::QualityTrimmer(double qualityThreshold,
     : qualityThreshold_(qualityThreshold),
       minLength_(minLength),
       trimMode_(mode),
-      qualityEncoding_(qualityEncoding) {}
+      qualityEncoding_(qualityEncoding),
+      qualityTarget_(qualityTargetFor(qualityThreshold, qualityEncoding)),
+      kernels_(&fq::common::byteKernels()) {}
 
 void QualityTrimmer::process(fq::io::FastqRecord& read) {
-    totalProcessed_++;
-
     if (read.empty())
         return;
 
-    size_t originalLen = read.seq.size();
+    const size_t len = std::min(read.seq.size(), read.qual.size());
+    const bool trimFive = trimMode_ == TrimMode::Both || trimMode_ == TrimMode::FivePrime;
+    const bool trimThree = trimMode_ == TrimMode::Both || trimMode_ == TrimMode::ThreePrime;
+
+    const size_t first = trimFive ? trimFivePrime(read.seq, read.qual) : 0;
+    // 5' 端已找不到高质量碱基时 3' 端也不会有
+    const size_t last = (trimThree && first < len) ? trimThreePrime(read.seq, read.qual) : 0;
+    applyTrim(read, first, last);
+}
+
+void QualityTrimmer::processBatch(std::span<fq::io::FastqRecord> reads,
+                                  const ReadPassMask& passMask) {
+    // 限定名调用，避免每条 read 的虚函数分派
+    for (size_t i = 0; i < reads.size(); ++i) {
+        if (passMask[i] != 0) {
+            QualityTrimmer::process(reads[i]);
+        }
+    }
+}
+
+auto QualityTrimmer::metricsRequest() const -> ReadMetricsRequest {
+    return {kMetricHighQualityBounds, qualityTarget_};
+}
+
+void QualityTrimmer::processBatchWithMetrics(std::span<fq::io::FastqRecord> reads,
+                                             const ReadMetricsBatch& metrics,
+                                             const ReadPassMask& passMask) {
+    if (!metrics.hasHighQualityBounds(qualityTarget_)) {
+        processBatch(reads, passMask);
+        return;
+    }
+    for (size_t i = 0; i < reads.size(); ++i) {
+        if (passMask[i] != 0 && !reads[i].empty()) {
+            applyTrim(reads[i], metrics[i].firstHighQuality, metrics[i].lastHighQuality);
+        }
+    }
+}
+
+void QualityTrimmer::applyTrim(fq::io::FastqRecord& read,
+                               size_t firstHighQuality,
+                               size_t lastHighQuality) const {
+    const size_t originalLen = read.seq.size();
+    const size_t len = std::min(originalLen, read.qual.size());
+    const bool trimFive = trimMode_ == TrimMode::Both || trimMode_ == TrimMode::FivePrime;
+    const bool trimThree = trimMode_ == TrimMode::Both || trimMode_ == TrimMode::ThreePrime;
     size_t start = 0;
     size_t end = originalLen;
 
     // Trim 5'
-    if (trimMode_ == TrimMode::Both || trimMode_ == TrimMode::FivePrime) {
-        start = trimFivePrime(read.seq, read.qual);
+    if (trimFive) {
+        start = firstHighQuality;
     }
 
-    // Trim 3'
-    if (trimMode_ == TrimMode::Both || trimMode_ == TrimMode::ThreePrime) {
-        // Only trim 3' if we still have bases left
-        if (start < end) {
-            std::string_view currentSeq = read.seq.substr(start, end - start);
-            std::string_view currentQual = read.qual.substr(start, end - start);
-
-            size_t newLen = trimThreePrime(currentSeq, currentQual);
-            end = start + newLen;
-        }
+    // Trim 3'：只在 5' 修剪后剩余的部分中查找，5' 端已无高质量碱基时剩余为空
+    if (trimThree && start < end) {
+        end = (trimFive && firstHighQuality >= len) ? start : lastHighQuality;
     }
 
     size_t newLen = (end > start) ? (end - start) : 0;
@@ -55,81 +103,22 @@ void QualityTrimmer::process(fq::io::FastqRecord& read) {
         // Filter out (make empty)
         read.seq = {};
         read.qual = {};
-        totalBasesRemoved_ += originalLen;
-        trimmedCount_++;  // Considered trimmed completely
-    } else {
-        // Apply trim
-        if (newLen < originalLen) {
-            read.seq = read.seq.substr(start, newLen);
-            read.qual = read.qual.substr(start, newLen);
-            totalBasesRemoved_ += (originalLen - newLen);
-            trimmedCount_++;
-        }
+    } else if (newLen < originalLen) {
+        read.seq = read.seq.substr(start, newLen);
+        read.qual = read.qual.substr(start, newLen);
     }
 }
 
 auto QualityTrimmer::trimFivePrime(std::string_view sequence, std::string_view quality) const
     -> size_t {
     size_t len = std::min(sequence.size(), quality.size());
-    size_t i = 0;
-
-#ifdef __AVX2__
-    // Align? No usually just loadu.
-    // Quality is char, encoded.
-    // Threshold check: qual[i] - encoding >= threshold
-    // => qual[i] >= threshold + encoding
-    // Let target = threshold + encoding
-    int target = static_cast<int>(qualityThreshold_) + qualityEncoding_;
-    // If target > 127 or so, be careful with signed comparisons.
-    // char is usually signed. -128 to 127.
-    // Quality scores are usually 33..70+.
-    // _mm256_cmpgt_epi8 does signed comparison.
-    // If target > 127, we might have issues if char is signed.
-    // Standard fastq qual is printable ASCII (33-126).
-    // So all positive in signed char.
-
-    __m256i vTarget = _mm256_set1_epi8(static_cast<char>(target - 1));
-    // We want to find FIRST char where q >= target.
-    // Equivalent to q > target - 1.
-    // So we invoke cmpgt(q, target - 1).
-
-    for (; i + 32 <= len; i += 32) {
-        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(quality.data() + i));
-        __m256i result = _mm256_cmpgt_epi8(chunk, vTarget);
-        int mask = _mm256_movemask_epi8(result);
-        if (mask != 0) {
-            // Found a high quality base
-            return i + __builtin_ctz(mask);
-        }
-    }
-    // Handle remaining... falls through to scalar
-#endif
-
-    for (; i < len; ++i) {
-        if (isHighQuality(quality[i])) {
-            return i;
-        }
-    }
-    return len;  // Trim all
+    return kernels_->findFirstAtLeast(quality.data(), len, qualityTarget_);
 }
 
 auto QualityTrimmer::trimThreePrime(std::string_view sequence, std::string_view quality) const
     -> size_t {
     size_t len = std::min(sequence.size(), quality.size());
-    // Scan from end
-    size_t i = len;
-    while (i > 0) {
-        if (isHighQuality(quality[i - 1])) {
-            return i;
-        }
-        i--;
-    }
-    return 0;  // Trim all
-}
-
-auto QualityTrimmer::isHighQuality(char qualityChar) const -> bool {
-    int q = static_cast<int>(qualityChar) - qualityEncoding_;
-    return q >= qualityThreshold_;
+    return kernels_->findLastAtLeast(quality.data(), len, qualityTarget_);
 }
 
 auto QualityTrimmer::getName() const -> std::string {
@@ -138,19 +127,12 @@ auto QualityTrimmer::getName() const -> std::string {
 auto QualityTrimmer::getDescription() const -> std::string {
     return fmt::format("Trims bases with quality < {:.2f}", qualityThreshold_);
 }
-void QualityTrimmer::reset() {
-    totalProcessed_ = 0;
-    trimmedCount_ = 0;
-    totalBasesRemoved_ = 0;
-}
-
 // --- LengthTrimmer ---
 
 LengthTrimmer::LengthTrimmer(size_t targetLength, TrimStrategy strategy)
     : targetLength_(targetLength), strategy_(strategy) {}
 
 void LengthTrimmer::process(fq::io::FastqRecord& read) {
-    totalProcessed_++;
     size_t len = read.seq.size();
 
     if (len <= targetLength_ && strategy_ != TrimStrategy::FixedLength) {
@@ -186,8 +168,6 @@ void LengthTrimmer::process(fq::io::FastqRecord& read) {
     if (newLen < len) {
         read.seq = read.seq.substr(start, newLen);
         read.qual = read.qual.substr(start, newLen);
-        totalBasesRemoved_ += (len - newLen);
-        trimmedCount_++;
     }
 }
 
@@ -197,12 +177,6 @@ auto LengthTrimmer::getName() const -> std::string {
 auto LengthTrimmer::getDescription() const -> std::string {
     return fmt::format("Trims reads to length {}", targetLength_);
 }
-void LengthTrimmer::reset() {
-    totalProcessed_ = 0;
-    trimmedCount_ = 0;
-    totalBasesRemoved_ = 0;
-}
-
 // --- AdapterTrimmer ---
 
 AdapterTrimmer::AdapterTrimmer(const std::vector<std::string>& adapterSequences,
@@ -211,7 +185,6 @@ AdapterTrimmer::AdapterTrimmer(const std::vector<std::string>& adapterSequences,
     : adapters_(adapterSequences), minOverlap_(minOverlap), maxMismatches_(maxMismatches) {}
 
 void AdapterTrimmer::process(fq::io::FastqRecord& read) {
-    totalProcessed_++;
     if (read.empty())
         return;
 
@@ -230,13 +203,9 @@ void AdapterTrimmer::process(fq::io::FastqRecord& read) {
     }
 
     if (bestPos != std::string::npos) {
-        size_t originalLen = read.seq.size();
         // Trim everything from bestPos
         read.seq = read.seq.substr(0, bestPos);
         read.qual = read.qual.substr(0, bestPos);
-
-        totalBasesRemoved_ += (originalLen - bestPos);
-        adapterFound_++;
     }
 }
 
@@ -304,10 +273,4 @@ auto AdapterTrimmer::getName() const -> std::string {
 auto AdapterTrimmer::getDescription() const -> std::string {
     return "Trims adapter sequences";
 }
-void AdapterTrimmer::reset() {
-    totalProcessed_ = 0;
-    adapterFound_ = 0;
-    totalBasesRemoved_ = 0;
-}
-
 }  // namespace fq::processing
@@ -1,40 +1,89 @@
 #include "fqtools/processing/predicates/min_quality_predicate.h"
 
-#include <numeric>
+#include <cmath>
+#include <limits>
 
 #include <fmt/format.h>
 
 namespace fq::processing {
 
+// --- AverageQualityThreshold ---
+
+AverageQualityThreshold::AverageQualityThreshold(double minQuality, int qualityEncoding)
+    : minQuality_(minQuality),
+      qualityEncoding_(qualityEncoding),
+      neverPasses_(std::isnan(minQuality)) {
+    requiredSums_.resize(kTableSize);
+    for (size_t length = 0; length < kTableSize; ++length) {
+        requiredSums_[length] = computeRequiredSum(length);
+    }
+}
+
+auto AverageQualityThreshold::computeRequiredSum(size_t length) const -> std::uint64_t {
+    if (length == 0) {
+        return 0;
+    }
+    const double len = static_cast<double>(length);
+    const double estimate = std::ceil(minQuality_ * len);
+    if (!(estimate > 0.0)) {
+        return 0;
+    }
+    if (estimate >= 9007199254740992.0) {  // 2^53，超出后 double 无法逐个表示整数
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    // 乘积的舍入可能与除法不同，按 sum / length >= minQuality 修正到满足条件的最小和，
+    // 保证与原先的浮点判定逐值一致
+    auto required = static_cast<std::uint64_t>(estimate);
+    while (required > 0 && static_cast<double>(required - 1) / len >= minQuality_) {
+        required--;
+    }
+    while (static_cast<double>(required) / len < minQuality_) {
+        required++;
+    }
+    return required;
+}
+
 // --- MinQualityPredicate ---
 
 MinQualityPredicate::MinQualityPredicate(double minQuality, int qualityEncoding)
-    : minQuality_(minQuality), qualityEncoding_(qualityEncoding) {}
+    : threshold_(minQuality, qualityEncoding), kernels_(&fq::common::byteKernels()) {}
 
 auto MinQualityPredicate::evaluate(const fq::io::FastqRecord& read) const -> bool {
-    totalEvaluated_.fetch_add(1, std::memory_order_relaxed);
-    if (read.qual.empty())
-        return false;
-
-    double avgQual = calculateAverageQuality(read.qual);
+    return passesQuality(read.qual);
+}
 
-    if (avgQual >= minQuality_) {
-        passedCount_.fetch_add(1, std::memory_order_relaxed);
-        return true;
+void MinQualityPredicate::evaluateBatch(std::span<const fq::io::FastqRecord> reads,
+                                        ReadPassMask& passMask) const {
+    for (size_t i = 0; i < reads.size(); ++i) {
+        if (passMask[i] != 0) {
+            passMask[i] = passesQuality(reads[i].qual) ? 1 : 0;
+        }
     }
-    return false;
 }
 
-auto MinQualityPredicate::calculateAverageQuality(std::string_view qualityString) const
-    -> double {
-    if (qualityString.empty())
-        return 0.0;
+auto MinQualityPredicate::metricsRequest() const -> ReadMetricsRequest {
+    return {kMetricQualitySum, 0};
+}
 
-    uint64_t sumQual = 0;
-    for (char q : qualityString) {
-        sumQual += (static_cast<int>(q) - qualityEncoding_);
+void MinQualityPredicate::evaluateBatchWithMetrics(std::span<const fq::io::FastqRecord> reads,
+                                                   const ReadMetricsBatch& metrics,
+                                                   ReadPassMask& passMask) const {
+    if (!metrics.has(kMetricQualitySum)) {
+        evaluateBatch(reads, passMask);
+        return;
+    }
+    for (size_t i = 0; i < reads.size(); ++i) {
+        if (passMask[i] != 0) {
+            passMask[i] = threshold_.passes(metrics[i].qualitySum, reads[i].qual.size()) ? 1 : 0;
+        }
     }
-    return static_cast<double>(sumQual) / static_cast<double>(qualityString.size());
+}
+
+auto MinQualityPredicate::passesQuality(std::string_view qualityString) const -> bool {
+    if (qualityString.empty())
+        return false;
+    return threshold_.passes(kernels_->sum(qualityString.data(), qualityString.size()),
+                             qualityString.size());
 }
 
 auto MinQualityPredicate::getName() const -> std::string {
@@ -42,14 +91,7 @@ auto MinQualityPredicate::getName() const -> std::string {
 }
 
 auto MinQualityPredicate::getDescription() const -> std::string {
-    return fmt::format("Filters reads with average quality < {:.2f}", minQuality_);
-}
-
-auto MinQualityPredicate::getStatistics() const -> std::string {
-    size_t total = totalEvaluated_.load();
-    size_t passed = passedCount_.load();
-    double percent = total > 0 ? (100.0 * passed / total) : 0.0;
-    return fmt::format("MinQuality: Passed {}/{} ({:.2f}%)", passed, total, percent);
+    return fmt::format("Filters reads with average quality < {:.2f}", threshold_.minQuality());
 }
 
 // --- MinLengthPredicate ---
@@ -57,12 +99,15 @@ auto MinQualityPredicate::getStatistics() const -> std::string {
 MinLengthPredicate::MinLengthPredicate(size_t minLength) : minLength_(minLength) {}
 
 auto MinLengthPredicate::evaluate(const fq::io::FastqRecord& read) const -> bool {
-    totalEvaluated_.fetch_add(1, std::memory_order_relaxed);
-    if (read.seq.size() >= minLength_) {
-        passedCount_.fetch_add(1, std::memory_order_relaxed);
-        return true;
+    return read.seq.size() >= minLength_;
+}
+
+void MinLengthPredicate::evaluateBatch(std::span<const fq::io::FastqRecord> reads,
+                                       ReadPassMask& passMask) const {
+    // 无分支写法，编译器可整批向量化
+    for (size_t i = 0; i < reads.size(); ++i) {
+        passMask[i] &= static_cast<std::uint8_t>(reads[i].seq.size() >= minLength_);
     }
-    return false;
 }
 
 auto MinLengthPredicate::getName() const -> std::string {
@@ -71,21 +116,20 @@ auto MinLengthPredicate::getName() const -> std::string {
 auto MinLengthPredicate::getDescription() const -> std::string {
     return fmt::format("Filters reads shorter than {} bp", minLength_);
 }
-auto MinLengthPredicate::getStatistics() const -> std::string {
-    return fmt::format("MinLength: Passed {}/{}", passedCount_.load(), totalEvaluated_.load());
-}
 
 // --- MaxLengthPredicate ---
 
 MaxLengthPredicate::MaxLengthPredicate(size_t maxLength) : maxLength_(maxLength) {}
 
 auto MaxLengthPredicate::evaluate(const fq::io::FastqRecord& read) const -> bool {
-    totalEvaluated_.fetch_add(1, std::memory_order_relaxed);
-    if (read.seq.size() <= maxLength_) {
-        passedCount_.fetch_add(1, std::memory_order_relaxed);
-        return true;
+    return read.seq.size() <= maxLength_;
+}
+
+void MaxLengthPredicate::evaluateBatch(std::span<const fq::io::FastqRecord> reads,
+                                       ReadPassMask& passMask) const {
+    for (size_t i = 0; i < reads.size(); ++i) {
+        passMask[i] &= static_cast<std::uint8_t>(reads[i].seq.size() <= maxLength_);
     }
-    return false;
 }
 
 auto MaxLengthPredicate::getName() const -> std::string {
@@ -94,31 +138,52 @@ auto MaxLengthPredicate::getName() const -> std::string {
 auto MaxLengthPredicate::getDescription() const -> std::string {
     return fmt::format("Filters reads longer than {} bp", maxLength_);
 }
-auto MaxLengthPredicate::getStatistics() const -> std::string {
-    return fmt::format("MaxLength: Passed {}/{}", passedCount_.load(), totalEvaluated_.load());
-}
 
 // --- MaxNRatioPredicate ---
 
-MaxNRatioPredicate::MaxNRatioPredicate(double maxNRatio) : maxNRatio_(maxNRatio) {}
+MaxNRatioPredicate::MaxNRatioPredicate(double maxNRatio)
+    : maxNRatio_(maxNRatio), kernels_(&fq::common::byteKernels()) {}
 
 auto MaxNRatioPredicate::evaluate(const fq::io::FastqRecord& read) const -> bool {
-    totalEvaluated_.fetch_add(1, std::memory_order_relaxed);
-    if (calculateNRatio(read.seq) <= maxNRatio_) {
-        passedCount_.fetch_add(1, std::memory_order_relaxed);
-        return true;
+    return calculateNRatio(read.seq) <= maxNRatio_;
+}
+
+void MaxNRatioPredicate::evaluateBatch(std::span<const fq::io::FastqRecord> reads,
+                                       ReadPassMask& passMask) const {
+    for (size_t i = 0; i < reads.size(); ++i) {
+        if (passMask[i] != 0) {
+            passMask[i] = calculateNRatio(reads[i].seq) <= maxNRatio_ ? 1 : 0;
+        }
+    }
+}
+
+auto MaxNRatioPredicate::metricsRequest() const -> ReadMetricsRequest {
+    return {kMetricNCount, 0};
+}
+
+void MaxNRatioPredicate::evaluateBatchWithMetrics(std::span<const fq::io::FastqRecord> reads,
+                                                  const ReadMetricsBatch& metrics,
+                                                  ReadPassMask& passMask) const {
+    if (!metrics.has(kMetricNCount)) {
+        evaluateBatch(reads, passMask);
+        return;
+    }
+    for (size_t i = 0; i < reads.size(); ++i) {
+        if (passMask[i] == 0) {
+            continue;
+        }
+        const size_t length = metrics[i].length;
+        const double nRatio =
+            length == 0 ? 0.0
+                        : static_cast<double>(metrics[i].nCount) / static_cast<double>(length);
+        passMask[i] = nRatio <= maxNRatio_ ? 1 : 0;
     }
-    return false;
 }
 
 auto MaxNRatioPredicate::calculateNRatio(std::string_view sequence) const -> double {
     if (sequence.empty())
         return 0.0;
-    size_t nCount = 0;
-    for (char c : sequence) {
-        if (c == 'N' || c == 'n')
-            nCount++;
-    }
+    size_t nCount = kernels_->countLetter(sequence.data(), sequence.size(), 'n');
     return static_cast<double>(nCount) / static_cast<double>(sequence.size());
 }
 
@@ -128,8 +193,5 @@ auto MaxNRatioPredicate::getName() const -> std::string {
 auto MaxNRatioPredicate::getDescription() const -> std::string {
     return fmt::format("Filters reads with N ratio > {:.2f}", maxNRatio_);
 }
-auto MaxNRatioPredicate::getStatistics() const -> std::string {
-    return fmt::format("MaxNRatio: Passed {}/{}", passedCount_.load(), totalEvaluated_.load());
-}
 
 }  // namespace fq::processing
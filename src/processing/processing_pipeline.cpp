@@ -1,5 +1,6 @@
 #include "processing/processing_pipeline.h"
 
+#include "fqtools/common/batch_sizer.h"
 #include "fqtools/io/fastq_batch_pool.h"
 #include "fqtools/io/fastq_reader.h"
 #include "fqtools/io/fastq_writer.h"
@@ -8,6 +9,9 @@
 #include "fqtools/processing/read_predicate_interface.h"
 
 #include <algorithm>
+#include <chrono>
+#include <limits>
+#include <memory>
 #include <stdexcept>
 
 #include <tbb/global_control.h>
@@ -15,6 +19,70 @@
 
 namespace fq::processing {
 
+namespace {
+
+// 未显式指定时，gzip 压缩线程数跟随处理线程数
+auto compressionThreadsFor(const ProcessingConfig& config) -> size_t {
+    if (config.compressionThreads > 0) {
+        return config.compressionThreads;
+    }
+    return std::max<size_t>(1, config.threadCount);
+}
+
+// 按字节分批时记录数不设上限
+auto recordsPerBatch(const ProcessingConfig& config) -> size_t {
+    if (config.batchBytes > 0 || config.adaptiveBatch) {
+        return std::numeric_limits<size_t>::max();
+    }
+    return config.batchSize;
+}
+
+auto makeBatchSizer(const ProcessingConfig& config, size_t threadCount)
+    -> std::unique_ptr<fq::common::AdaptiveBatchSizer> {
+    if (!config.adaptiveBatch) {
+        return nullptr;
+    }
+    fq::common::AdaptiveBatchOptions options;
+    options.initialBytes = config.batchBytes > 0 ? config.batchBytes : config.readChunkBytes;
+    if (config.batchCapacityBytes > 0) {
+        options.maxBytes = config.batchCapacityBytes;
+        options.minBytes = std::min(options.minBytes, options.maxBytes);
+    }
+    options.workers = threadCount;
+    return std::make_unique<fq::common::AdaptiveBatchSizer>(options);
+}
+
+auto countActive(const ReadPassMask& passMask) -> uint64_t {
+    return static_cast<uint64_t>(
+        std::count_if(passMask.begin(), passMask.end(), [](std::uint8_t v) { return v != 0; }));
+}
+
+}  // namespace
+
+auto readerOptionsFor(const ProcessingConfig& config) -> fq::io::FastqReaderOptions {
+    fq::io::FastqReaderOptions options;
+    options.readChunkBytes = config.readChunkBytes;
+    options.zlibBufferBytes = config.zlibBufferBytes;
+    options.maxBufferBytes = config.batchCapacityBytes;
+    options.decompressionThreads = std::max<size_t>(1, config.threadCount);
+    options.speculativeInflate = config.speculativeInflate;
+    options.readAheadBuffers = config.readAheadBuffers;
+    options.ioUring = config.ioUring;
+    options.shardIndex = config.shardIndex;
+    options.shardCount = config.shardCount;
+    options.targetBatchBytes = config.batchBytes;
+    return options;
+}
+
+auto writerOptionsFor(const ProcessingConfig& config) -> fq::io::FastqWriterOptions {
+    fq::io::FastqWriterOptions options;
+    options.outputBufferBytes = config.writerBufferBytes;
+    options.compressionLevel = config.compressionLevel;
+    options.compressionThreads = compressionThreadsFor(config);
+    options.ioUring = config.ioUring;
+    return options;
+}
+
 SequentialProcessingPipeline::SequentialProcessingPipeline() = default;
 SequentialProcessingPipeline::~SequentialProcessingPipeline() = default;
 
@@ -35,30 +103,44 @@ void SequentialProcessingPipeline::addReadPredicate(std::unique_ptr<ReadPredicat
 }
 
 auto SequentialProcessingPipeline::run() -> ProcessingStatistics {
-    if (config_.threadCount > 1) {
-        return processWithTBB();
-    } else {
-        return processSequential();
+    fusedFilter_ = FusedReadFilter::create(predicates_, mutators_);
+    if (fusedFilter_) {
+        fq::logging::debug("Using fused filter path (stages mask {:#x})",
+                           fusedFilter_->params().stages);
+    }
+
+    // 度量按修改前的 read 计算，只对谓词和第一个修改器有效
+    metricsRequest_ = {};
+    for (const auto& predicate : predicates_) {
+        metricsRequest_.merge(predicate->metricsRequest());
+    }
+    if (!mutators_.empty()) {
+        metricsRequest_.merge(mutators_.front()->metricsRequest());
+    }
+
+    auto stats = config_.threadCount > 1 ? processWithTBB() : processSequential();
+    stats.stages.resize(predicates_.size() + mutators_.size());
+    for (size_t i = 0; i < predicates_.size(); ++i) {
+        stats.stages[i].name = predicates_[i]->getName();
+    }
+    for (size_t i = 0; i < mutators_.size(); ++i) {
+        stats.stages[predicates_.size() + i].name = mutators_[i]->getName();
     }
+    return stats;
 }
 
 auto SequentialProcessingPipeline::processSequential() -> ProcessingStatistics {
     ProcessingStatistics stats;
 
     try {
-        fq::io::FastqReaderOptions readerOptions;
-        readerOptions.readChunkBytes = config_.readChunkBytes;
-        readerOptions.zlibBufferBytes = config_.zlibBufferBytes;
-        readerOptions.maxBufferBytes = config_.batchCapacityBytes;
+        const auto readerOptions = readerOptionsFor(config_);
 
         fq::io::FastqReader reader(inputPath_, readerOptions);
         if (!reader.isOpen()) {
             throw std::runtime_error("Failed to open input file: " + inputPath_);
         }
 
-        fq::io::FastqWriterOptions writerOptions;
-        writerOptions.zlibBufferBytes = config_.zlibBufferBytes;
-        writerOptions.outputBufferBytes = config_.writerBufferBytes;
+        const auto writerOptions = writerOptionsFor(config_);
 
         fq::io::FastqWriter writer(outputPath_, writerOptions);
         if (!writer.isOpen()) {
@@ -68,9 +150,32 @@ auto SequentialProcessingPipeline::processSequential() -> ProcessingStatistics {
         fq::io::FastqBatch batch(config_.batchCapacityBytes, config_.batchSize);
         auto startTime = std::chrono::steady_clock::now();
 
-        while (reader.nextBatch(batch, config_.batchSize)) {
+        // 单线程时读取阶段包含解析，三个阶段依次执行；自适应分批仍按各阶段实测耗时调整
+        const auto sizer = makeBatchSizer(config_, 1);
+        const size_t maxRecords = recordsPerBatch(config_);
+        using Clock = std::chrono::steady_clock;
+        while (true) {
+            if (sizer) {
+                reader.setTargetBatchBytes(sizer->batchBytes());
+            }
+            auto begin = Clock::now();
+            if (!reader.nextBatch(batch, maxRecords)) {
+                break;
+            }
+            const size_t bytes = batch.data().size();
+            if (sizer) {
+                sizer->record(fq::common::BatchStage::Read, bytes, Clock::now() - begin);
+                begin = Clock::now();
+            }
             processBatch(batch, stats);
+            if (sizer) {
+                sizer->record(fq::common::BatchStage::Process, bytes, Clock::now() - begin);
+                begin = Clock::now();
+            }
             writer.write(batch);
+            if (sizer) {
+                sizer->record(fq::common::BatchStage::Write, bytes, Clock::now() - begin);
+            }
         }
 
         auto endTime = std::chrono::steady_clock::now();
@@ -93,35 +198,23 @@ auto SequentialProcessingPipeline::processSequential() -> ProcessingStatistics {
 
 auto SequentialProcessingPipeline::processBatch(fq::io::FastqBatch& batch,
                                                 ProcessingStatistics& stats) -> bool {
-    stats.inputBytes += batch.buffer().size();
+    stats.inputBytes += batch.data().size();
     auto& records = batch.records();
-    size_t passedCount = 0;
+    stats.totalReads += records.size();
 
-    for (size_t i = 0; i < records.size(); ++i) {
-        auto& read = records[i];
-        stats.totalReads++;
-
-        bool passed = true;
-        for (const auto& predicate : predicates_) {
-            if (!predicate->evaluate(read)) {
-                passed = false;
-                break;
-            }
-        }
-
-        if (passed) {
-            for (const auto& mutator : mutators_) {
-                mutator->process(read);
-            }
-
-            if (read.empty()) {
-                passed = false;
-            }
-        }
+    ReadPassMask passMask(records.size(), 1);
+    if (fusedFilter_) {
+        // 常用组合：一次扫描完成全部判定与修剪
+        fusedFilter_->applyBatch(records, passMask, stats);
+    } else {
+        applyStages(records, passMask, batch.arena(), stats);
+    }
 
-        if (passed) {
+    size_t passedCount = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (passMask[i] != 0 && !records[i].empty()) {
             if (passedCount != i) {
-                records[passedCount] = read;
+                records[passedCount] = records[i];
             }
             passedCount++;
         } else {
@@ -135,6 +228,62 @@ auto SequentialProcessingPipeline::processBatch(fq::io::FastqBatch& batch,
     return true;
 }
 
+void SequentialProcessingPipeline::applyStages(std::vector<fq::io::FastqRecord>& records,
+                                               ReadPassMask& passMask,
+                                               fq::io::FastqArena& arena,
+                                               ProcessingStatistics& stats) const {
+    const size_t stageCount = predicates_.size() + mutators_.size();
+    if (stats.stages.size() < stageCount) {
+        stats.stages.resize(stageCount);
+    }
+
+    // 共享度量每批只算一次；之后逐阶段整批处理，每个谓词/修改器每批只做一次虚调用。
+    // 各阶段计数由通过掩码与修改前后的序列视图得出，阶段对象内没有共享计数器。
+    ReadMetricsBatch metrics;
+    metrics.compute(records, passMask, metricsRequest_);
+    uint64_t active = countActive(passMask);
+    for (size_t k = 0; k < predicates_.size(); ++k) {
+        predicates_[k]->evaluateBatchWithMetrics(records, metrics, passMask);
+        auto& stage = stats.stages[k];
+        stage.evaluated += active;
+        active = countActive(passMask);
+        stage.passed += active;
+    }
+
+    if (mutators_.empty()) {
+        return;
+    }
+    std::vector<std::string_view> before(records.size());
+    ReadPassMask modifiedMask(records.size(), 0);
+    const ReadMetricsBatch noMetrics;
+    for (size_t k = 0; k < mutators_.size(); ++k) {
+        for (size_t i = 0; i < records.size(); ++i) {
+            before[i] = records[i].seq;
+        }
+        mutators_[k]->processBatchWithArena(records, k == 0 ? metrics : noMetrics, passMask, arena);
+
+        auto& stage = stats.stages[predicates_.size() + k];
+        for (size_t i = 0; i < records.size(); ++i) {
+            if (passMask[i] == 0) {
+                continue;
+            }
+            stage.evaluated++;
+            const auto seq = records[i].seq;
+            if (seq.data() != before[i].data() || seq.size() != before[i].size()) {
+                stage.modified++;
+                modifiedMask[i] = 1;
+                if (seq.size() < before[i].size()) {
+                    stage.basesRemoved += before[i].size() - seq.size();
+                }
+            }
+            if (!seq.empty()) {
+                stage.passed++;
+            }
+        }
+    }
+    stats.modifiedReads += countActive(modifiedMask);
+}
+
 auto SequentialProcessingPipeline::processWithTBB() -> ProcessingStatistics {
     ProcessingStatistics finalStats;
     auto startTime = std::chrono::steady_clock::now();
@@ -142,18 +291,12 @@ auto SequentialProcessingPipeline::processWithTBB() -> ProcessingStatistics {
     const size_t threadCount = std::max<size_t>(1, config_.threadCount);
     tbb::global_control globalLimit(tbb::global_control::max_allowed_parallelism, threadCount);
 
-    fq::io::FastqReaderOptions readerOptions;
-    readerOptions.readChunkBytes = config_.readChunkBytes;
-    readerOptions.zlibBufferBytes = config_.zlibBufferBytes;
-    readerOptions.maxBufferBytes = config_.batchCapacityBytes;
-
+    const auto readerOptions = readerOptionsFor(config_);
     auto reader = std::make_shared<fq::io::FastqReader>(inputPath_, readerOptions);
     if (!reader->isOpen())
         throw std::runtime_error("Failed to open input file: " + inputPath_);
 
-    fq::io::FastqWriterOptions writerOptions;
-    writerOptions.zlibBufferBytes = config_.zlibBufferBytes;
-    writerOptions.outputBufferBytes = config_.writerBufferBytes;
+    const auto writerOptions = writerOptionsFor(config_);
 
     fq::io::FastqWriter writer(outputPath_, writerOptions);
     if (!writer.isOpen())
@@ -173,17 +316,34 @@ auto SequentialProcessingPipeline::processWithTBB() -> ProcessingStatistics {
         }
         maxTokens = std::max(static_cast<size_t>(1), maxTokens);
 
+        // 乱序写出时，慢批次不会挡住其后已完成的批次占着令牌等待
+        const auto writerMode = config_.unorderedOutput ? tbb::filter_mode::serial_out_of_order
+                                                        : tbb::filter_mode::serial_in_order;
+
         // 创建 FastqBatch 对象池，预分配 maxTokens 个对象
         auto batchPool = fq::io::createFastqBatchPool(maxTokens, maxTokens * 2);
+        const auto sizer = makeBatchSizer(config_, threadCount);
+        const size_t maxRecords = recordsPerBatch(config_);
+        using Clock = std::chrono::steady_clock;
 
         tbb::parallel_pipeline(
             maxTokens,
 
+            // 串行阶段只读取原始数据块并确定记录边界，解析在并行阶段完成
             tbb::make_filter<void, std::shared_ptr<fq::io::FastqBatch>>(
                 tbb::filter_mode::serial_in_order,
-                [reader, batchPool, this](tbb::flow_control& fc) -> std::shared_ptr<fq::io::FastqBatch> {
+                [reader, batchPool, &sizer, maxRecords](
+                    tbb::flow_control& fc) -> std::shared_ptr<fq::io::FastqBatch> {
                     auto batch = batchPool->acquire();
-                    if (reader->nextBatch(*batch, config_.batchSize)) {
+                    if (sizer) {
+                        reader->setTargetBatchBytes(sizer->batchBytes());
+                    }
+                    const auto begin = Clock::now();
+                    if (reader->nextChunk(*batch, maxRecords)) {
+                        if (sizer) {
+                            sizer->record(fq::common::BatchStage::Read, batch->data().size(),
+                                          Clock::now() - begin);
+                        }
                         return batch;
                     }
                     fc.stop();
@@ -194,25 +354,35 @@ auto SequentialProcessingPipeline::processWithTBB() -> ProcessingStatistics {
                     std::shared_ptr<fq::io::FastqBatch>,
                     std::pair<std::shared_ptr<fq::io::FastqBatch>, ProcessingStatistics>>(
                     tbb::filter_mode::parallel,
-                    [this](std::shared_ptr<fq::io::FastqBatch> batch) {
+                    [this, &sizer](std::shared_ptr<fq::io::FastqBatch> batch) {
                         ProcessingStatistics batchStats;
+                        const auto begin = Clock::now();
+                        fq::io::FastqReader::parseChunk(*batch);
                         this->processBatch(*batch, batchStats);
+                        if (sizer) {
+                            sizer->record(fq::common::BatchStage::Process, batch->data().size(),
+                                          Clock::now() - begin);
+                        }
                         return std::make_pair(batch, batchStats);
                     }) &
 
                 tbb::make_filter<
                     std::pair<std::shared_ptr<fq::io::FastqBatch>, ProcessingStatistics>,
                     void>(
-                    tbb::filter_mode::serial_in_order,
-                    [&writer, &finalStats](const std::pair<std::shared_ptr<fq::io::FastqBatch>,
-                                                            ProcessingStatistics>& pair) {
+                    writerMode,
+                    [&writer, &finalStats, &sizer](
+                        const std::pair<std::shared_ptr<fq::io::FastqBatch>, ProcessingStatistics>&
+                            pair) {
+                        const auto begin = Clock::now();
                         const auto before = writer.totalUncompressedBytes();
                         writer.write(*pair.first);
                         const auto after = writer.totalUncompressedBytes();
-                        finalStats.totalReads += pair.second.totalReads;
-                        finalStats.passedReads += pair.second.passedReads;
-                        finalStats.filteredReads += pair.second.filteredReads;
-                        finalStats.inputBytes += pair.second.inputBytes;
+                        if (sizer) {
+                            sizer->record(fq::common::BatchStage::Write, pair.first->data().size(),
+                                          Clock::now() - begin);
+                        }
+                        // 每批的计数在工作线程内独立累加，只在串行的写出阶段合并
+                        finalStats.merge(pair.second);
                         finalStats.outputBytes += (after - before);
                     }));
 
@@ -14,11 +14,15 @@
  */
 
 #include "fqtools/io/fastq_io.h"
+#include "fqtools/io/fastq_reader.h"
+#include "fqtools/io/fastq_writer.h"
 #include "fqtools/processing/processing_pipeline_interface.h"
+#include "processing/fused_filter.h"
 
 #include <atomic>
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace fq::processing {
@@ -28,6 +32,17 @@ class ReadPredicateInterface;
 
 // ProcessingStatistics 现在定义在公共接口头文件 processing_pipeline_interface.h 中
 
+/**
+ * @brief 由处理配置生成 Reader 配置
+ * @details 串行与 TBB 两条处理路径共用，新增的输入选项只需在这里转发一次
+ */
+[[nodiscard]] auto readerOptionsFor(const ProcessingConfig& config) -> fq::io::FastqReaderOptions;
+
+/**
+ * @brief 由处理配置生成 Writer 配置，两条处理路径共用
+ */
+[[nodiscard]] auto writerOptionsFor(const ProcessingConfig& config) -> fq::io::FastqWriterOptions;
+
 /**
  * @brief FastQ 数据处理管道实现类
  * @details 该类实现了 FastQ 文件的完整处理流程，包括：
@@ -159,11 +174,22 @@ private:
      */
     auto processBatch(fq::io::FastqBatch& batch, ProcessingStatistics& stats) -> bool;
 
+    /**
+     * @brief 通用路径：依次应用谓词与修改器，并把各阶段计数累加到 stats
+     * @param arena 修改器存放改写内容的批次内存区
+     */
+    void applyStages(std::vector<fq::io::FastqRecord>& records,
+                     ReadPassMask& passMask,
+                     fq::io::FastqArena& arena,
+                     ProcessingStatistics& stats) const;
+
     std::string inputPath_;                                           ///< 输入文件路径
     std::string outputPath_;                                          ///< 输出文件路径
     ProcessingConfig config_;                                          ///< 处理配置
     std::vector<std::unique_ptr<ReadMutatorInterface>> mutators_;      ///< 数据修改器列表
     std::vector<std::unique_ptr<ReadPredicateInterface>> predicates_;  ///< 数据过滤器列表
+    std::optional<FusedReadFilter> fusedFilter_;  ///< 常用组合的融合实现，run() 时选定
+    ReadMetricsRequest metricsRequest_;  ///< 通用路径上各阶段合并后的度量需求，run() 时计算
 };
 
 }  // namespace fq::processing
@@ -5,6 +5,31 @@
 
 namespace fq::processing {
 
+void ProcessingStatistics::merge(const ProcessingStatistics& other) {
+    totalReads += other.totalReads;
+    passedReads += other.passedReads;
+    filteredReads += other.filteredReads;
+    modifiedReads += other.modifiedReads;
+    errorReads += other.errorReads;
+    inputBytes += other.inputBytes;
+    outputBytes += other.outputBytes;
+
+    if (stages.size() < other.stages.size()) {
+        stages.resize(other.stages.size());
+    }
+    for (size_t i = 0; i < other.stages.size(); ++i) {
+        auto& stage = stages[i];
+        const auto& otherStage = other.stages[i];
+        if (stage.name.empty()) {
+            stage.name = otherStage.name;
+        }
+        stage.evaluated += otherStage.evaluated;
+        stage.passed += otherStage.passed;
+        stage.modified += otherStage.modified;
+        stage.basesRemoved += otherStage.basesRemoved;
+    }
+}
+
 auto ProcessingStatistics::toString() const -> std::string {
     std::ostringstream oss;
 
@@ -18,6 +43,12 @@ auto ProcessingStatistics::toString() const -> std::string {
     oss << "  错误读取数: " << errorReads << "\n";
     oss << "  处理时间: " << std::fixed << std::setprecision(2) << processingTimeMs << " ms\n";
     oss << "  处理吞吐量: " << std::fixed << std::setprecision(2) << throughputMbps << " MB/s";
+    for (const auto& stage : stages) {
+        oss << "\n  " << stage.name << ": 通过 " << stage.passed << "/" << stage.evaluated;
+        if (stage.modified > 0 || stage.basesRemoved > 0) {
+            oss << ", 修改 " << stage.modified << ", 移除碱基 " << stage.basesRemoved;
+        }
+    }
 
     return oss.str();
 }
@@ -0,0 +1,52 @@
+#include "fqtools/processing/read_metrics.h"
+
+#include <algorithm>
+
+namespace fq::processing {
+
+auto measureRead(const fq::common::ByteKernels& kernels,
+                 const fq::io::FastqRecord& read,
+                 const ReadMetricsRequest& request) -> ReadMetrics {
+    ReadMetrics metrics;
+    const auto& seq = read.seq;
+    const auto& qual = read.qual;
+    metrics.length = seq.size();
+
+    // 各内核依次扫描同一条 read，此时数据都还在 L1 中
+    if ((request.metrics & kMetricQualitySum) != 0) {
+        metrics.qualitySum = kernels.sum(qual.data(), qual.size());
+    }
+    if ((request.metrics & kMetricNCount) != 0) {
+        metrics.nCount = kernels.countLetter(seq.data(), seq.size(), 'n');
+    }
+    if ((request.metrics & kMetricGcCount) != 0) {
+        metrics.gcCount = kernels.countGc(seq.data(), seq.size());
+    }
+    if ((request.metrics & kMetricHighQualityBounds) != 0) {
+        const size_t len = std::min(seq.size(), qual.size());
+        metrics.firstHighQuality = kernels.findFirstAtLeast(qual.data(), len, request.qualityTarget);
+        // 首个不存在时末个也不存在，省去一次反向扫描
+        metrics.lastHighQuality =
+            metrics.firstHighQuality < len
+                ? kernels.findLastAtLeast(qual.data(), len, request.qualityTarget)
+                : 0;
+    }
+    return metrics;
+}
+
+void ReadMetricsBatch::compute(std::span<const fq::io::FastqRecord> reads,
+                               const ReadPassMask& passMask,
+                               const ReadMetricsRequest& request) {
+    request_ = request;
+    values_.assign(reads.size(), ReadMetrics{});
+    if (request.metrics == 0) {
+        return;
+    }
+    for (size_t i = 0; i < reads.size(); ++i) {
+        if (passMask[i] != 0) {
+            values_[i] = measureRead(*kernels_, reads[i], request);
+        }
+    }
+}
+
+}  // namespace fq::processing
@@ -10,66 +10,189 @@
 
 #include "statistics/fq_statistic.h"
 
+#include "fqtools/common/batch_sizer.h"
 #include "fqtools/io/fastq_batch_pool.h"
 #include "fqtools/io/fastq_reader.h"
 #include "fqtools/logging.h"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
+#include <limits>
 #include <memory>
 #include <numeric>
+#include <stdexcept>
 #include <vector>
 
+#include <fmt/format.h>
+
 #include "spdlog/spdlog.h"
 #include "statistics/fq_statistic_worker.h"
+#include <tbb/enumerable_thread_specific.h>
 #include <tbb/global_control.h>
 #include <tbb/parallel_pipeline.h>
 
 namespace fq::statistic {
 
-/**
- * @brief 统计结果累加操作符重载
- */
-auto FqStatisticResult::operator+=(const FqStatisticResult& other) -> FqStatisticResult& {
-    this->readCount += other.readCount;
-    this->totalBases += other.totalBases;
-    if (other.maxReadLength > this->maxReadLength) {
-        this->maxReadLength = other.maxReadLength;
-        if (this->maxReadLength > this->posQualityDist.size()) {
-            this->posQualityDist.resize(this->maxReadLength, std::vector<uint64_t>(kMaxQual, 0));
-            this->posBaseDist.resize(this->maxReadLength, std::vector<uint64_t>(kMaxBaseNum, 0));
-        }
+namespace {
+
+constexpr std::array<char, 4> kPartialMagic = {'F', 'Q', 'S', '\0'};
+constexpr uint32_t kPartialVersion = 1;
+constexpr uint32_t kPhredOffset = 33;
+
+void putLe32(std::ostream& out, uint32_t value) {
+    std::array<char, 4> bytes{};
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+    out.write(bytes.data(), bytes.size());
+}
+
+void putLe64(std::ostream& out, uint64_t value) {
+    std::array<char, 8> bytes{};
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+    out.write(bytes.data(), bytes.size());
+}
+
+auto getLe32(std::istream& in, const std::string& path) -> uint32_t {
+    std::array<unsigned char, 4> bytes{};
+    if (!in.read(reinterpret_cast<char*>(bytes.data()), bytes.size())) {
+        throw std::runtime_error("Truncated statistics partial: " + path);
+    }
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
     }
+    return value;
+}
+
+auto getLe64(std::istream& in, const std::string& path) -> uint64_t {
+    const uint64_t low = getLe32(in, path);
+    const uint64_t high = getLe32(in, path);
+    return low | (high << 32);
+}
+
+// 从当前位置到文件末尾的字节数
+auto remainingBytes(std::istream& in) -> uint64_t {
+    const auto here = in.tellg();
+    in.seekg(0, std::ios::end);
+    const auto end = in.tellg();
+    in.seekg(here);
+    if (here < 0 || end < here) {
+        return 0;
+    }
+    return static_cast<uint64_t>(end - here);
+}
+
+}  // namespace
+
+auto isStatisticPartialPath(const std::string& path) -> bool {
+    return std::filesystem::path(path).extension() == ".fqs";
+}
 
-    // Merge position stats
-    size_t mergeLen = std::min(this->posQualityDist.size(), other.posQualityDist.size());
-    for (size_t i = 0; i < mergeLen; ++i) {
-        for (size_t j = 0; j < kMaxQual; ++j) {
-            this->posQualityDist[i][j] += other.posQualityDist[i][j];
+void FqStatisticResult::save(const std::string& path, const std::string& sourceName) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Failed to create statistics partial: " + path);
+    }
+    out.write(kPartialMagic.data(), kPartialMagic.size());
+    putLe32(out, kPartialVersion);
+    putLe32(out, kPhredOffset);
+    putLe32(out, kMaxQual);
+    putLe32(out, kMaxBaseNum);
+    putLe64(out, readCount);
+    putLe64(out, totalBases);
+    putLe32(out, maxReadLength);
+    putLe64(out, posDist.size());
+    putLe32(out, static_cast<uint32_t>(sourceName.size()));
+    out.write(sourceName.data(), static_cast<std::streamsize>(sourceName.size()));
+    for (size_t pos = 0; pos < posDist.size(); ++pos) {
+        for (size_t q = 0; q < kMaxQual; ++q) {
+            putLe64(out, posDist.quality(pos)[q]);
         }
-        for (size_t j = 0; j < kMaxBaseNum; ++j) {
-            this->posBaseDist[i][j] += other.posBaseDist[i][j];
+        for (size_t b = 0; b < kMaxBaseNum; ++b) {
+            putLe64(out, posDist.bases(pos)[b]);
         }
     }
+    if (!out.flush()) {
+        throw std::runtime_error("Failed to write statistics partial: " + path);
+    }
+}
+
+auto FqStatisticResult::load(const std::string& path, std::string* sourceName)
+    -> FqStatisticResult {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Failed to open statistics partial: " + path);
+    }
+    std::array<char, 4> magic{};
+    if (!in.read(magic.data(), magic.size()) || magic != kPartialMagic) {
+        throw std::runtime_error("Not a statistics partial (.fqs) file: " + path);
+    }
+    const uint32_t version = getLe32(in, path);
+    if (version != kPartialVersion) {
+        throw std::runtime_error(
+            fmt::format("Unsupported statistics partial version {}: {}", version, path));
+    }
+    const uint32_t phredOffset = getLe32(in, path);
+    const uint32_t maxQual = getLe32(in, path);
+    const uint32_t maxBaseNum = getLe32(in, path);
+    if (phredOffset != kPhredOffset || maxQual != kMaxQual || maxBaseNum != kMaxBaseNum) {
+        throw std::runtime_error("Statistics partial has an incompatible layout: " + path);
+    }
+
+    FqStatisticResult result;
+    result.readCount = getLe64(in, path);
+    result.totalBases = getLe64(in, path);
+    result.maxReadLength = getLe32(in, path);
+    const uint64_t positions = getLe64(in, path);
+    const uint32_t nameLength = getLe32(in, path);
+    // 长度字段来自文件，分配前先与剩余字节数核对，损坏或截断的文件不会触发巨量分配
+    constexpr auto kRowBytes = static_cast<uint64_t>(kMaxQual + kMaxBaseNum) * sizeof(uint64_t);
+    const uint64_t remaining = remainingBytes(in);
+    if (positions < result.maxReadLength || nameLength > remaining ||
+        positions > (remaining - nameLength) / kRowBytes) {
+        throw std::runtime_error("Corrupted statistics partial header: " + path);
+    }
+    std::string name(nameLength, '\0');
+    if (!in.read(name.data(), static_cast<std::streamsize>(name.size()))) {
+        throw std::runtime_error("Truncated statistics partial: " + path);
+    }
+    if (sourceName != nullptr) {
+        *sourceName = std::move(name);
+    }
 
-    // If other is longer, copy the rest (should be handled by resize above? no, operator+= logic)
-    // Actually, if we resized 'this', the new parts are 0, so we just add.
-    if (other.posQualityDist.size() > mergeLen) {
-        // Copy remaining parts from other
-        for (size_t i = mergeLen; i < other.posQualityDist.size(); ++i) {
-            this->posQualityDist[i] = other.posQualityDist[i];
-            this->posBaseDist[i] = other.posBaseDist[i];
+    result.posDist.ensure(positions);
+    for (size_t pos = 0; pos < positions; ++pos) {
+        for (size_t q = 0; q < kMaxQual; ++q) {
+            result.posDist.quality(pos)[q] = getLe64(in, path);
+        }
+        for (size_t b = 0; b < kMaxBaseNum; ++b) {
+            result.posDist.bases(pos)[b] = getLe64(in, path);
         }
     }
+    return result;
+}
 
+/**
+ * @brief 统计结果累加操作符重载
+ */
+auto FqStatisticResult::operator+=(const FqStatisticResult& other) -> FqStatisticResult& {
+    this->readCount += other.readCount;
+    this->totalBases += other.totalBases;
+    this->maxReadLength = std::max(this->maxReadLength, other.maxReadLength);
+    this->posDist += other.posDist;
     return *this;
 }
 
 // Helper function
-[[nodiscard]] static auto calculateErrorPerPosition(const std::vector<uint64_t>& posQualityDist, uint64_t readCount) -> double {
+[[nodiscard]] static auto calculateErrorPerPosition(const uint64_t* posQualityDist, uint64_t readCount) -> double {
     if (readCount == 0) {
         return 0.0;
     }
@@ -87,6 +210,48 @@ FastqStatisticCalculator::FastqStatisticCalculator(const StatisticOptions& optio
 }
 
 void FastqStatisticCalculator::run() {
+    std::string sourceName;
+    FqStatisticResult finalResult;
+    if (!options_.mergeInputPaths.empty()) {
+        finalResult = mergePartials(sourceName);
+    } else {
+        sourceName = std::filesystem::path(options_.inputFastqPath).filename().string();
+        finalResult = computeResult();
+    }
+
+    if (isStatisticPartialPath(options_.outputStatPath)) {
+        finalResult.save(options_.outputStatPath, sourceName);
+        fq::logging::info("Statistics partial saved to '{}'", options_.outputStatPath);
+    } else {
+        writeResult(finalResult, sourceName);
+        fq::logging::info("Statistics report saved to '{}'", options_.outputStatPath);
+    }
+}
+
+auto FastqStatisticCalculator::mergePartials(std::string& sourceName) -> FqStatisticResult {
+    fq::logging::info("Merging {} statistics partials.", options_.mergeInputPaths.size());
+
+    FqStatisticResult merged;
+    std::vector<std::string> names;
+    for (const auto& path : options_.mergeInputPaths) {
+        std::string name;
+        merged += FqStatisticResult::load(path, &name);
+        if (std::find(names.begin(), names.end(), name) == names.end()) {
+            names.push_back(std::move(name));
+        }
+    }
+
+    sourceName.clear();
+    for (const auto& name : names) {
+        if (!sourceName.empty()) {
+            sourceName += ',';
+        }
+        sourceName += name;
+    }
+    return merged;
+}
+
+auto FastqStatisticCalculator::computeResult() -> FqStatisticResult {
     fq::logging::info("Starting FASTQ statistics generation for '{}' using TBB pipeline (New IO).",
                  options_.inputFastqPath);
 
@@ -113,6 +278,31 @@ void FastqStatisticCalculator::run() {
     readerOptions.readChunkBytes = options_.readChunkBytes;
     readerOptions.zlibBufferBytes = options_.zlibBufferBytes;
     readerOptions.maxBufferBytes = options_.batchCapacityBytes;
+    readerOptions.decompressionThreads = threadCount;
+    readerOptions.speculativeInflate = options_.speculativeInflate;
+    readerOptions.readAheadBuffers = options_.readAheadBuffers;
+    readerOptions.ioUring = options_.ioUring;
+    readerOptions.shardIndex = options_.shardIndex;
+    readerOptions.shardCount = options_.shardCount;
+    readerOptions.targetBatchBytes = options_.batchBytes;
+
+    // 按字节分批时记录数不设上限
+    const bool sizeByBytes = options_.batchBytes > 0 || options_.adaptiveBatch;
+    const size_t maxRecords = sizeByBytes ? std::numeric_limits<size_t>::max()
+                                          : static_cast<size_t>(options_.batchSize);
+    std::unique_ptr<fq::common::AdaptiveBatchSizer> sizer;
+    if (options_.adaptiveBatch) {
+        fq::common::AdaptiveBatchOptions sizerOptions;
+        sizerOptions.initialBytes =
+            options_.batchBytes > 0 ? options_.batchBytes : options_.readChunkBytes;
+        if (options_.batchCapacityBytes > 0) {
+            sizerOptions.maxBytes = options_.batchCapacityBytes;
+            sizerOptions.minBytes = std::min(sizerOptions.minBytes, sizerOptions.maxBytes);
+        }
+        sizerOptions.workers = threadCount;
+        sizer = std::make_unique<fq::common::AdaptiveBatchSizer>(sizerOptions);
+    }
+    using Clock = std::chrono::steady_clock;
 
     // Shared reader for serial stage
     auto reader = std::make_shared<fq::io::FastqReader>(options_.inputFastqPath, readerOptions);
@@ -121,48 +311,63 @@ void FastqStatisticCalculator::run() {
     }
 
     auto batchPool = fq::io::createFastqBatchPool(maxLiveTokens, maxLiveTokens * 2);
+    tbb::enumerable_thread_specific<FqStatisticResult> localResults;
 
     tbb::parallel_pipeline(
         maxLiveTokens,
-        // Stage 1: Input Filter (Serial)
+        // Stage 1: Input Filter (Serial) - raw chunk + record boundary only
         tbb::make_filter<void, std::shared_ptr<fq::io::FastqBatch>>(
             tbb::filter_mode::serial_in_order,
-            [reader, batchPool, this](tbb::flow_control& fc) -> std::shared_ptr<fq::io::FastqBatch> {
+            [reader, batchPool, this, &sizer, maxRecords](
+                tbb::flow_control& fc) -> std::shared_ptr<fq::io::FastqBatch> {
                 auto batch = batchPool->acquire();
-                batch->buffer().reserve(options_.batchCapacityBytes);
                 batch->records().reserve(static_cast<size_t>(options_.batchSize));
-                if (reader->nextBatch(*batch, static_cast<size_t>(options_.batchSize))) {
+                if (sizer) {
+                    reader->setTargetBatchBytes(sizer->batchBytes());
+                }
+                const auto begin = Clock::now();
+                if (reader->nextChunk(*batch, maxRecords)) {
+                    if (sizer) {
+                        sizer->record(fq::common::BatchStage::Read, batch->data().size(),
+                                      Clock::now() - begin);
+                    }
                     return batch;
                 } else {
                     fc.stop();
                     return nullptr;
                 }
             }) &
-            // Stage 2: Processing Filter (Parallel)
-            tbb::make_filter<std::shared_ptr<fq::io::FastqBatch>, FqStatisticResult>(
+            // Stage 2: Parsing + Processing Filter (Parallel)
+            // 每个线程累加到自己的结果中，整个运行期间复用，不再经过串行聚合阶段
+            tbb::make_filter<std::shared_ptr<fq::io::FastqBatch>, void>(
                 tbb::filter_mode::parallel,
-                [](const std::shared_ptr<fq::io::FastqBatch>& batch) -> FqStatisticResult {
+                [&localResults, &sizer](const std::shared_ptr<fq::io::FastqBatch>& batch) {
                     if (!batch) {
-                        return FqStatisticResult();
+                        return;
                     }
+                    const auto begin = Clock::now();
+                    fq::io::FastqReader::parseChunk(*batch);
                     // Assuming default qual offset 33 for now.
                     // TODO: Auto-detect quality system in Reader and pass here.
-                    FqStatisticWorker worker(33);
-                    return worker.calculateStats(*batch);
-                }) &
-            // Stage 3: Aggregation Filter (Serial)
-            tbb::make_filter<FqStatisticResult, void>(
-                tbb::filter_mode::serial_in_order,
-                [&finalResult](const FqStatisticResult& partialResult) {
-                    finalResult += partialResult;
+                    const FqStatisticWorker worker(33);
+                    worker.accumulate(*batch, localResults.local());
+                    if (sizer) {
+                        sizer->record(fq::common::BatchStage::Process, batch->data().size(),
+                                      Clock::now() - begin);
+                    }
                 }));
 
-    fq::logging::info("TBB pipeline finished. Aggregated results from all batches.");
-    writeResult(finalResult);
-    fq::logging::info("Statistics report saved to '{}'", options_.outputStatPath);
+    // 各线程的结果在结束时合并一次
+    localResults.combine_each(
+        [&finalResult](const FqStatisticResult& partialResult) { finalResult += partialResult; });
+
+    fq::logging::info("TBB pipeline finished. Aggregated results from {} thread-local accumulators.",
+                      localResults.size());
+    return finalResult;
 }
 
-void FastqStatisticCalculator::writeResult(const FqStatisticResult& result) {
+void FastqStatisticCalculator::writeResult(const FqStatisticResult& result,
+                                           const std::string& sourceName) {
     std::ofstream writer(options_.outputStatPath);
     if (!writer) {
         throw std::runtime_error(
@@ -176,13 +381,11 @@ void FastqStatisticCalculator::writeResult(const FqStatisticResult& result) {
         return;
     }
 
-    std::string fqName = std::filesystem::path(options_.inputFastqPath).filename().string();
-
     // Infer info for header
     // Since we removed FileAttributes, we just output what we know.
     // QScoreType defaults to Sanger (33)
 
-    writer << "#Name\t" << fqName << "\n";
+    writer << "#Name\t" << sourceName << "\n";
     writer << "#PhredQual\t" << 33 << "\n";
     writer << "#ReadNum\t" << result.readCount << "\n";
     writer << "#MaxReadLength\t" << result.maxReadLength
@@ -196,22 +399,24 @@ void FastqStatisticCalculator::writeResult(const FqStatisticResult& result) {
 
     // Iterate up to maxReadLength
     for (size_t i = 0; i < result.maxReadLength; ++i) {
-        if (i >= result.posQualityDist.size()) {
+        if (i >= result.posDist.size()) {
             break;
         }
+        const uint64_t* quality = result.posDist.quality(i);
+        const uint64_t* bases = result.posDist.bases(i);
 
         for (int j = kQ20Threshold; j < kMaxQual; ++j) {
-            nQ20 += result.posQualityDist[i][j];
+            nQ20 += quality[j];
         }
         for (int j = kQ30Threshold; j < kMaxQual; ++j) {
-            nQ30 += result.posQualityDist[i][j];
+            nQ30 += quality[j];
         }
 
-        nA += result.posBaseDist[i][0];
-        nC += result.posBaseDist[i][1];
-        nG += result.posBaseDist[i][2];
-        nT += result.posBaseDist[i][3];
-        nN += result.posBaseDist[i][4];
+        nA += bases[0];
+        nC += bases[1];
+        nG += bases[2];
+        nT += bases[3];
+        nN += bases[4];
     }
 
     writer << "#Q20(>=20)\t" << nQ20 << "\t"
@@ -234,26 +439,27 @@ void FastqStatisticCalculator::writeResult(const FqStatisticResult& result) {
 
     writer << "#Pos\tA\tC\tG\tT\tN\tAvgQual\tErrRate\n";
     for (size_t i = 0; i < result.maxReadLength; ++i) {
-        if (i >= result.posBaseDist.size())
+        if (i >= result.posDist.size())
             break;
 
+        const uint64_t* quality = result.posDist.quality(i);
+        const uint64_t* bases = result.posDist.bases(i);
         writer << i + 1 << "\t";
-        writer << result.posBaseDist[i][0] << "\t" << result.posBaseDist[i][1] << "\t"
-               << result.posBaseDist[i][2] << "\t" << result.posBaseDist[i][3] << "\t"
-               << result.posBaseDist[i][4] << "\t";
+        writer << bases[0] << "\t" << bases[1] << "\t" << bases[2] << "\t" << bases[3] << "\t"
+               << bases[4] << "\t";
 
         uint64_t sumQual = 0;
         uint64_t countReadsAtPos = 0;  // Reads that cover this position
 
         for (int j = 0; j < kMaxQual; ++j) {
-            sumQual += result.posQualityDist[i][j] * j;
-            countReadsAtPos += result.posQualityDist[i][j];
+            sumQual += quality[j] * j;
+            countReadsAtPos += quality[j];
         }
 
         if (countReadsAtPos > 0) {
             writer << static_cast<double>(sumQual) / static_cast<double>(countReadsAtPos)
                    << "\t";
-            writer << calculateErrorPerPosition(result.posQualityDist[i], countReadsAtPos) << "\n";
+            writer << calculateErrorPerPosition(quality, countReadsAtPos) << "\n";
         } else {
             writer << "0.0\t0.0\n";
         }
@@ -17,6 +17,7 @@
 #include "fqtools/io/fastq_io.h"
 #include "fqtools/statistics/statistic_calculator_interface.h"
 #include "fqtools/statistics/statistic_interface.h"
+#include "statistics/position_histogram.h"
 
 #include <cstdint>
 #include <memory>
@@ -34,8 +35,7 @@ struct FqStatisticResult {
     uint64_t readCount = 0;                         ///< 总读取数量
     uint64_t totalBases = 0;                        ///< 总碱基数
     uint32_t maxReadLength = 0;                     ///< 最大读取长度
-    std::vector<std::vector<uint64_t>> posQualityDist;    ///< 位置质量分数分布
-    std::vector<std::vector<uint64_t>> posBaseDist;       ///< 位置碱基分布
+    PositionHistogram posDist;                      ///< 位置质量分数分布与碱基分布
 
     /**
      * @brief 重载 += 运算符，用于合并统计结果
@@ -45,8 +45,36 @@ struct FqStatisticResult {
      * @return 合并后的统计结果引用
      */
     auto operator+=(const FqStatisticResult& other) -> FqStatisticResult&;
+
+    /**
+     * @brief 将统计结果保存为可合并的二进制中间结果（.fqs）
+     * @details 小端格式：头部为 magic "FQS\0"、version(u32)、phredOffset(u32)、maxQual(u32)、
+     *          maxBaseNum(u32)、readCount(u64)、totalBases(u64)、maxReadLength(u32)、
+     *          positions(u64)、sourceName 长度(u32) 与内容；随后逐位置写出质量分布与碱基分布计数(u64)。
+     *
+     * @param path 输出文件路径
+     * @param sourceName 统计来源（通常为输入文件名），合并后写入报告的 #Name
+     * @throw std::runtime_error 文件无法写入
+     */
+    void save(const std::string& path, const std::string& sourceName) const;
+
+    /**
+     * @brief 读取 save() 写出的中间结果
+     *
+     * @param path .fqs 文件路径
+     * @param sourceName 非空时返回保存时记录的统计来源
+     * @return 统计结果，可直接用 += 合并
+     * @throw std::runtime_error 文件无法打开、格式或版本不符、数据截断
+     */
+    static auto load(const std::string& path, std::string* sourceName = nullptr)
+        -> FqStatisticResult;
 };
 
+/**
+ * @brief 判断输出路径是否为二进制中间结果（.fqs 后缀）
+ */
+[[nodiscard]] auto isStatisticPartialPath(const std::string& path) -> bool;
+
 /**
  * @brief FASTQ 统计信息管理器
  * @details 该类使用 TBB 管道管理完整的 FASTQ 统计信息生成过程，
@@ -69,21 +97,35 @@ public:
 
     /**
      * @brief 执行统计信息生成过程
-     * @details 使用 TBB 并行管道执行完整的 FASTQ 统计信息生成过程
+     * @details 使用 TBB 并行管道执行完整的 FASTQ 统计信息生成过程；
+     *          options.mergeInputPaths 非空时改为读取并合并各 .fqs 中间结果。
+     *          输出路径以 .fqs 结尾时写出二进制中间结果，否则写出文本报告。
      * @post 统计结果被写入到指定的输出文件中
      */
     void run() override;
 
 private:
+    /**
+     * @brief 统计输入 FASTQ 文件
+     */
+    auto computeResult() -> FqStatisticResult;
+
+    /**
+     * @brief 读取并合并 options.mergeInputPaths 中的中间结果
+     * @param sourceName 返回去重后以逗号连接的统计来源
+     */
+    auto mergePartials(std::string& sourceName) -> FqStatisticResult;
+
     /**
      * @brief 将最终聚合的统计信息写入输出文件
      * @details 将统计结果以适当的格式写入到输出文件中
      *
      * @param result 要写入的最终结果
+     * @param sourceName 报告中 #Name 的取值
      * @pre result 必须包含有效的统计数据
      * @post 统计信息被写入到配置指定的输出文件中
      */
-    void writeResult(const FqStatisticResult& result);
+    void writeResult(const FqStatisticResult& result, const std::string& sourceName);
 
     StatisticOptions options_;  ///< 统计配置选项
 };
@@ -14,6 +14,8 @@
 #pragma once
 
 #include "fqtools/statistics/statistic_interface.h"
+#include "statistics/position_count_kernel.h"
+#include "statistics/position_histogram.h"
 
 #include <cstdint>
 #include <memory>
@@ -22,10 +24,6 @@
 
 namespace fq::statistic {
 
-// Replaced macros with constexpr for type safety and scoping
-constexpr int kMaxQual = 42;     ///< 最大质量分数值
-constexpr int kMaxBaseNum = 5;  ///< 最大碱基数量
-
 /**
  * @brief FASTQ 统计信息工作器
  * @details 该类用于处理 FASTQ 记录批次并生成统计信息，是一个独立的工具类，
@@ -55,8 +53,18 @@ public:
      */
     auto calculateStats(const Batch& batch) -> Result override;
 
+    /**
+     * @brief 将批次的统计累加到已有结果中
+     * @details 供长期存在的线程局部累加器使用，避免每个批次分配新的结果与位置表
+     *
+     * @param batch 要处理的记录批次
+     * @param result 累加目标，位置表按需扩展
+     */
+    void accumulate(const Batch& batch, Result& result) const;
+
 private:
     int qualOffset_ = 33;  ///< 质量分数偏移量
+    PositionCountKernel kernel_ = nullptr;  ///< 按 CPU 选择的计数内核
 };
 
 }  // namespace fq::statistic
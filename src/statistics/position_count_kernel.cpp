@@ -0,0 +1,216 @@
+#include "statistics/position_count_kernel.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+// 与 common/simd.cpp 一致，只在 x86-64 上启用向量内核，32 位 x86 走标量实现
+#if defined(__x86_64__)
+#define FQ_POSITION_COUNT_X86 1
+#include <immintrin.h>
+#endif
+
+namespace fq::statistic {
+
+namespace {
+
+constexpr uint8_t kBaseN = 4;
+
+// A/C/G/T（含小写）映射为 0-3，其余字符为 N
+constexpr auto kBaseIndex = [] {
+    std::array<uint8_t, 256> table{};
+    table.fill(kBaseN);
+    table['A'] = table['a'] = 0;
+    table['C'] = table['c'] = 1;
+    table['G'] = table['g'] = 2;
+    table['T'] = table['t'] = 3;
+    return table;
+}();
+
+// 与原实现一致：按有符号 char 减去偏移，截断到 [0, kMaxQual)
+inline auto qualityIndex(char qualChar, int qualOffset) -> size_t {
+    const int q = static_cast<int>(qualChar) - qualOffset;
+    return static_cast<size_t>(std::clamp(q, 0, kMaxQual - 1));
+}
+
+void countScalarRange(std::string_view seq, std::string_view qual, int qualOffset,
+                      PositionHistogram& hist, size_t begin) {
+    const size_t withQual = std::min(seq.size(), qual.size());
+    size_t i = begin;
+    for (; i < withQual; ++i) {
+        uint64_t* row = hist.quality(i);
+        row[qualityIndex(qual[i], qualOffset)]++;
+        row[PositionHistogram::kBaseOffset + kBaseIndex[static_cast<unsigned char>(seq[i])]]++;
+    }
+    for (; i < seq.size(); ++i) {
+        hist.bases(i)[kBaseIndex[static_cast<unsigned char>(seq[i])]]++;
+    }
+}
+
+void countScalar(std::string_view seq, std::string_view qual, int qualOffset,
+                 PositionHistogram& hist) {
+    countScalarRange(seq, qual, qualOffset, hist, 0);
+}
+
+#ifdef FQ_POSITION_COUNT_X86
+
+// 每个位置对应不同的行，同一条 read 内的累加互不冲突，向量化只负责下标计算
+template <size_t Width>
+inline void scatterCounts(const uint8_t* qualIdx, const uint8_t* baseIdx, size_t pos,
+                          PositionHistogram& hist) {
+    for (size_t j = 0; j < Width; ++j) {
+        uint64_t* row = hist.quality(pos + j);
+        row[qualIdx[j]]++;
+        row[PositionHistogram::kBaseOffset + baseIdx[j]]++;
+    }
+}
+
+// 偏移超出 [0, 127] 时按字节饱和减法无法还原标量语义，交给标量版本
+inline auto simdOffsetSupported(int qualOffset) -> bool {
+    return qualOffset >= 0 && qualOffset <= 127;
+}
+
+// 碱基按 (c | 0x20) & 0x0f 查表：a=1 c=3 t=4 g=7 互不冲突，再与期望字符比较排除其他字符
+#define FQ_BASE_LUT_INDEX 4, 0, 4, 1, 3, 4, 4, 2, 4, 4, 4, 4, 4, 4, 4, 4
+#define FQ_BASE_LUT_CHAR 0, 'a', 0, 'c', 't', 0, 0, 'g', 0, 0, 0, 0, 0, 0, 0, 0
+
+__attribute__((target("sse4.2"))) void countSse42(std::string_view seq, std::string_view qual,
+                                                  int qualOffset, PositionHistogram& hist) {
+    if (!simdOffsetSupported(qualOffset)) {
+        countScalar(seq, qual, qualOffset, hist);
+        return;
+    }
+    const size_t withQual = std::min(seq.size(), qual.size());
+    const __m128i offset = _mm_set1_epi8(static_cast<char>(qualOffset));
+    const __m128i maxQual = _mm_set1_epi8(static_cast<char>(kMaxQual - 1));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lower = _mm_set1_epi8(0x20);
+    const __m128i nibbleMask = _mm_set1_epi8(0x0f);
+    const __m128i baseN = _mm_set1_epi8(static_cast<char>(kBaseN));
+    const __m128i lutIndex = _mm_setr_epi8(FQ_BASE_LUT_INDEX);
+    const __m128i lutChar = _mm_setr_epi8(FQ_BASE_LUT_CHAR);
+
+    alignas(16) std::array<uint8_t, 16> qualIdx{};
+    alignas(16) std::array<uint8_t, 16> baseIdx{};
+    size_t i = 0;
+    for (; i + 16 <= withQual; i += 16) {
+        const __m128i q = _mm_loadu_si128(reinterpret_cast<const __m128i*>(qual.data() + i));
+        const __m128i negative = _mm_cmplt_epi8(q, zero);
+        const __m128i clamped = _mm_min_epu8(_mm_subs_epu8(q, offset), maxQual);
+        _mm_store_si128(reinterpret_cast<__m128i*>(qualIdx.data()),
+                        _mm_andnot_si128(negative, clamped));
+
+        const __m128i s = _mm_or_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(seq.data() + i)), lower);
+        const __m128i nibble = _mm_and_si128(s, nibbleMask);
+        const __m128i valid = _mm_cmpeq_epi8(s, _mm_shuffle_epi8(lutChar, nibble));
+        _mm_store_si128(reinterpret_cast<__m128i*>(baseIdx.data()),
+                        _mm_blendv_epi8(baseN, _mm_shuffle_epi8(lutIndex, nibble), valid));
+
+        scatterCounts<16>(qualIdx.data(), baseIdx.data(), i, hist);
+    }
+    countScalarRange(seq, qual, qualOffset, hist, i);
+}
+
+__attribute__((target("avx2"))) void countAvx2(std::string_view seq, std::string_view qual,
+                                               int qualOffset, PositionHistogram& hist) {
+    if (!simdOffsetSupported(qualOffset)) {
+        countScalar(seq, qual, qualOffset, hist);
+        return;
+    }
+    const size_t withQual = std::min(seq.size(), qual.size());
+    const __m256i offset = _mm256_set1_epi8(static_cast<char>(qualOffset));
+    const __m256i maxQual = _mm256_set1_epi8(static_cast<char>(kMaxQual - 1));
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lower = _mm256_set1_epi8(0x20);
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0f);
+    const __m256i baseN = _mm256_set1_epi8(static_cast<char>(kBaseN));
+    const __m256i lutIndex = _mm256_setr_epi8(FQ_BASE_LUT_INDEX, FQ_BASE_LUT_INDEX);
+    const __m256i lutChar = _mm256_setr_epi8(FQ_BASE_LUT_CHAR, FQ_BASE_LUT_CHAR);
+
+    alignas(32) std::array<uint8_t, 32> qualIdx{};
+    alignas(32) std::array<uint8_t, 32> baseIdx{};
+    size_t i = 0;
+    for (; i + 32 <= withQual; i += 32) {
+        const __m256i q = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(qual.data() + i));
+        const __m256i negative = _mm256_cmpgt_epi8(zero, q);
+        const __m256i clamped = _mm256_min_epu8(_mm256_subs_epu8(q, offset), maxQual);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(qualIdx.data()),
+                           _mm256_andnot_si256(negative, clamped));
+
+        const __m256i s = _mm256_or_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(seq.data() + i)), lower);
+        const __m256i nibble = _mm256_and_si256(s, nibbleMask);
+        const __m256i valid = _mm256_cmpeq_epi8(s, _mm256_shuffle_epi8(lutChar, nibble));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(baseIdx.data()),
+                           _mm256_blendv_epi8(baseN, _mm256_shuffle_epi8(lutIndex, nibble), valid));
+
+        scatterCounts<32>(qualIdx.data(), baseIdx.data(), i, hist);
+    }
+    countScalarRange(seq, qual, qualOffset, hist, i);
+}
+
+__attribute__((target("avx512f,avx512bw"))) void countAvx512(std::string_view seq,
+                                                             std::string_view qual, int qualOffset,
+                                                             PositionHistogram& hist) {
+    if (!simdOffsetSupported(qualOffset)) {
+        countScalar(seq, qual, qualOffset, hist);
+        return;
+    }
+    const size_t withQual = std::min(seq.size(), qual.size());
+    const __m512i offset = _mm512_set1_epi8(static_cast<char>(qualOffset));
+    const __m512i maxQual = _mm512_set1_epi8(static_cast<char>(kMaxQual - 1));
+    const __m512i lower = _mm512_set1_epi8(0x20);
+    const __m512i nibbleMask = _mm512_set1_epi8(0x0f);
+    const __m512i baseN = _mm512_set1_epi8(static_cast<char>(kBaseN));
+    // vpshufb 在每个 128 位通道内独立查表，查找表复制到四个通道
+    alignas(64) static constexpr std::array<char, 64> kLutIndex = {
+        FQ_BASE_LUT_INDEX, FQ_BASE_LUT_INDEX, FQ_BASE_LUT_INDEX, FQ_BASE_LUT_INDEX};
+    alignas(64) static constexpr std::array<char, 64> kLutChar = {
+        FQ_BASE_LUT_CHAR, FQ_BASE_LUT_CHAR, FQ_BASE_LUT_CHAR, FQ_BASE_LUT_CHAR};
+    const __m512i lutIndex = _mm512_load_si512(kLutIndex.data());
+    const __m512i lutChar = _mm512_load_si512(kLutChar.data());
+
+    alignas(64) std::array<uint8_t, 64> qualIdx{};
+    alignas(64) std::array<uint8_t, 64> baseIdx{};
+    size_t i = 0;
+    for (; i + 64 <= withQual; i += 64) {
+        const __m512i q = _mm512_loadu_si512(qual.data() + i);
+        const __mmask64 negative = _mm512_movepi8_mask(q);
+        const __m512i clamped = _mm512_min_epu8(_mm512_subs_epu8(q, offset), maxQual);
+        _mm512_store_si512(qualIdx.data(), _mm512_maskz_mov_epi8(~negative, clamped));
+
+        const __m512i s = _mm512_or_si512(_mm512_loadu_si512(seq.data() + i), lower);
+        const __m512i nibble = _mm512_and_si512(s, nibbleMask);
+        const __mmask64 valid = _mm512_cmpeq_epi8_mask(s, _mm512_shuffle_epi8(lutChar, nibble));
+        _mm512_store_si512(baseIdx.data(),
+                           _mm512_mask_blend_epi8(valid, baseN, _mm512_shuffle_epi8(lutIndex, nibble)));
+
+        scatterCounts<64>(qualIdx.data(), baseIdx.data(), i, hist);
+    }
+    countScalarRange(seq, qual, qualOffset, hist, i);
+}
+
+#undef FQ_BASE_LUT_INDEX
+#undef FQ_BASE_LUT_CHAR
+
+#endif  // FQ_POSITION_COUNT_X86
+
+}  // namespace
+
+auto positionCountKernel(common::SimdLevel level) -> PositionCountKernel {
+    switch (std::min(level, common::detectSimdLevel())) {
+#ifdef FQ_POSITION_COUNT_X86
+        case common::SimdLevel::Avx512:
+            return &countAvx512;
+        case common::SimdLevel::Avx2:
+            return &countAvx2;
+        case common::SimdLevel::Sse42:
+            return &countSse42;
+#endif
+        default:
+            return &countScalar;
+    }
+}
+
+}  // namespace fq::statistic
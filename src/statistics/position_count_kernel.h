@@ -0,0 +1,48 @@
+/**
+ * @file position_count_kernel.h
+ * @brief 单条 read 的按位置质量/碱基计数内核
+ * @details 内核把质量字符换算为截断到 [0, kMaxQual) 的分数、把碱基映射为 A/C/G/T/N 下标，
+ *          再累加到 PositionHistogram 对应位置的行中。提供标量、SSE4.2、AVX2 与 AVX-512 版本，
+ *          按 fq::common 的运行时 SIMD 级别选择，结果完全一致。
+ *
+ * @author FastQTools Team
+ * @date 2026-10-17
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2026 FastQTools
+ * @license MIT License
+ */
+
+#pragma once
+
+#include "fqtools/common/simd.h"
+
+#include "statistics/position_histogram.h"
+
+#include <cstdint>
+#include <string_view>
+
+namespace fq::statistic {
+
+/**
+ * @brief 累加一条 read 的计数
+ * @pre hist.size() >= seq.size()
+ */
+using PositionCountKernel = void (*)(std::string_view seq,
+                                     std::string_view qual,
+                                     int qualOffset,
+                                     PositionHistogram& hist);
+
+/**
+ * @brief 取指定级别的内核；CPU 不支持时退回可用的最高级别
+ */
+[[nodiscard]] auto positionCountKernel(common::SimdLevel level) -> PositionCountKernel;
+
+/**
+ * @brief 当前生效级别的内核
+ */
+[[nodiscard]] inline auto positionCountKernel() -> PositionCountKernel {
+    return positionCountKernel(common::activeSimdLevel());
+}
+
+}  // namespace fq::statistic
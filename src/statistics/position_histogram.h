@@ -0,0 +1,107 @@
+/**
+ * @file position_histogram.h
+ * @brief 按位置组织的质量分数与碱基计数表
+ * @details 每个位置占一行：kMaxQual 个质量计数后紧跟 kMaxBaseNum 个碱基计数，补齐到
+ *          kStride 个 uint64_t（整数个缓存行）。所有行连续存放在一块对齐的内存中，
+ *          统计内循环只做一次行内寻址，合并是逐元素相加。
+ *
+ * @author FastQTools Team
+ * @date 2026-10-17
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2026 FastQTools
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fq::statistic {
+
+// Replaced macros with constexpr for type safety and scoping
+constexpr int kMaxQual = 42;     ///< 最大质量分数值
+constexpr int kMaxBaseNum = 5;  ///< 最大碱基数量
+
+class PositionHistogram {
+public:
+    static constexpr size_t kCacheLineBytes = 64;
+    static constexpr size_t kBaseOffset = kMaxQual;  ///< 行内碱基计数的起始下标
+    static constexpr size_t kStride = 48;            ///< 每行的计数个数（含补齐）
+
+    /**
+     * @brief 已分配的位置数
+     */
+    [[nodiscard]] auto size() const -> size_t {
+        return rows_.size();
+    }
+
+    [[nodiscard]] auto empty() const -> bool {
+        return rows_.empty();
+    }
+
+    /**
+     * @brief 保证至少覆盖 positions 个位置，新增行清零；不会缩小
+     */
+    void ensure(size_t positions) {
+        if (positions > rows_.size()) {
+            rows_.resize(positions);
+        }
+    }
+
+    /**
+     * @brief 位置 pos 的质量计数（kMaxQual 个）
+     */
+    [[nodiscard]] auto quality(size_t pos) -> uint64_t* {
+        return rows_[pos].counts.data();
+    }
+    [[nodiscard]] auto quality(size_t pos) const -> const uint64_t* {
+        return rows_[pos].counts.data();
+    }
+
+    /**
+     * @brief 位置 pos 的碱基计数（A/C/G/T/N）
+     */
+    [[nodiscard]] auto bases(size_t pos) -> uint64_t* {
+        return rows_[pos].counts.data() + kBaseOffset;
+    }
+    [[nodiscard]] auto bases(size_t pos) const -> const uint64_t* {
+        return rows_[pos].counts.data() + kBaseOffset;
+    }
+
+    /**
+     * @brief 合并另一张表：必要时扩展行数，随后逐元素相加
+     */
+    auto operator+=(const PositionHistogram& other) -> PositionHistogram& {
+        ensure(other.size());
+        for (size_t pos = 0; pos < other.rows_.size(); ++pos) {
+            auto& dst = rows_[pos].counts;
+            const auto& src = other.rows_[pos].counts;
+            for (size_t i = 0; i < kStride; ++i) {
+                dst[i] += src[i];
+            }
+        }
+        return *this;
+    }
+
+    auto operator==(const PositionHistogram& other) const -> bool {
+        return rows_.size() == other.rows_.size() &&
+               std::equal(rows_.begin(), rows_.end(), other.rows_.begin(),
+                          [](const Row& a, const Row& b) { return a.counts == b.counts; });
+    }
+
+private:
+    struct alignas(kCacheLineBytes) Row {
+        std::array<uint64_t, kStride> counts{};
+    };
+    static_assert(kMaxQual + kMaxBaseNum <= kStride);
+    static_assert(sizeof(Row) % kCacheLineBytes == 0 && sizeof(Row) == kStride * sizeof(uint64_t));
+
+    std::vector<Row> rows_;
+};
+
+}  // namespace fq::statistic
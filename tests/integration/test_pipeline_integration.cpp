@@ -1,8 +1,16 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <zlib.h>
 #include "test_helpers.h"
 #include "fixture_loader.h"
+#include "fqtools/processing/predicates.h"
+#include "fqtools/processing/read_mutator_interface.h"
+#include "fqtools/processing/processing_pipeline.h"
 
 namespace fq::test {
 
@@ -39,4 +47,292 @@ TEST_F(PipelineIntegrationTest, FileIOIntegration) {
     EXPECT_TRUE(std::filesystem::exists(test_file));
 }
 
+namespace {
+
+// 每条记录的四行拼成一个字符串，便于比较记录集合
+auto readRecords(const std::filesystem::path& path) -> std::vector<std::string> {
+    std::ifstream in(path);
+    std::vector<std::string> records;
+    std::string line;
+    std::string record;
+    size_t lineNo = 0;
+    while (std::getline(in, line)) {
+        record += line;
+        record += '\n';
+        if (++lineNo % 4 == 0) {
+            records.push_back(std::move(record));
+            record.clear();
+        }
+    }
+    return records;
+}
+
+void writeGzip(const std::filesystem::path& path, const std::string& text) {
+    gzFile out = gzopen(path.string().c_str(), "wb");
+    ASSERT_NE(out, nullptr);
+    ASSERT_EQ(gzwrite(out, text.data(), static_cast<unsigned>(text.size())),
+              static_cast<int>(text.size()));
+    gzclose(out);
+}
+
+auto filterConfig() -> fq::processing::ProcessingConfig {
+    fq::processing::ProcessingConfig config;
+    config.threadCount = 4;
+    config.batchSize = 64;
+    return config;
+}
+
+auto runFilter(const std::filesystem::path& input,
+               const std::filesystem::path& output,
+               const fq::processing::ProcessingConfig& config)
+    -> fq::processing::ProcessingStatistics {
+    auto pipeline = fq::processing::createProcessingPipeline();
+    pipeline->setInputPath(input.string());
+    pipeline->setOutputPath(output.string());
+    pipeline->setProcessingConfig(config);
+    pipeline->addReadPredicate(std::make_unique<fq::processing::MinQualityPredicate>(30.0));
+    return pipeline->run();
+}
+
+// 反向互补：生成新字节的修改器，改写结果放在批次的 arena 中
+class ReverseComplementMutator : public fq::processing::ReadMutatorInterface {
+public:
+    void process(fq::io::FastqRecord& read) override { (void)read; }
+
+    void processBatchWithArena(std::span<fq::io::FastqRecord> reads,
+                               const fq::processing::ReadMetricsBatch& /*metrics*/,
+                               const fq::processing::ReadPassMask& passMask,
+                               fq::io::FastqArena& arena) override {
+        for (size_t i = 0; i < reads.size(); ++i) {
+            if (passMask[i] == 0) {
+                continue;
+            }
+            auto& read = reads[i];
+            char* seq = arena.allocate(read.seq.size());
+            char* qual = arena.allocate(read.qual.size());
+            for (size_t j = 0; j < read.seq.size(); ++j) {
+                seq[j] = complement(read.seq[read.seq.size() - 1 - j]);
+            }
+            std::reverse_copy(read.qual.begin(), read.qual.end(), qual);
+            read.seq = {seq, read.seq.size()};
+            read.qual = {qual, read.qual.size()};
+        }
+    }
+
+    static auto complement(char base) -> char {
+        switch (base) {
+            case 'A': return 'T';
+            case 'C': return 'G';
+            case 'G': return 'C';
+            case 'T': return 'A';
+            default: return 'N';
+        }
+    }
+};
+
+// 记录每次批量判定看到的批次大小，判定本身全部通过
+class BatchSizeRecorder : public fq::processing::ReadPredicateInterface {
+public:
+    auto evaluate(const fq::io::FastqRecord& /*read*/) const -> bool override { return true; }
+
+    void evaluateBatch(std::span<const fq::io::FastqRecord> reads,
+                       fq::processing::ReadPassMask& /*passMask*/) const override {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        sizes_.push_back(reads.size());
+    }
+
+    [[nodiscard]] auto sizes() const -> std::vector<size_t> {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return sizes_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    mutable std::vector<size_t> sizes_;
+};
+
+}  // namespace
+
+TEST_F(PipelineIntegrationTest, ArenaMutatorRewritesBases) {
+    auto input = temp_dir_ / "input.fastq";
+    {
+        std::ofstream out(input);
+        out << TestHelpers::generateFastQRecords(4000, 100);
+    }
+
+    std::vector<std::string> expected;
+    for (const auto& record : readRecords(input)) {
+        const auto seqBegin = record.find('\n') + 1;
+        const auto seqEnd = record.find('\n', seqBegin);
+        const auto qualBegin = record.find('\n', seqEnd + 1) + 1;
+        const auto qualEnd = record.find('\n', qualBegin);
+        std::string seq = record.substr(seqBegin, seqEnd - seqBegin);
+        std::string qual = record.substr(qualBegin, qualEnd - qualBegin);
+        std::reverse(seq.begin(), seq.end());
+        std::transform(seq.begin(), seq.end(), seq.begin(), ReverseComplementMutator::complement);
+        std::reverse(qual.begin(), qual.end());
+        expected.push_back(record.substr(0, seqBegin) + seq + "\n+\n" + qual + "\n");
+    }
+
+    for (const size_t threads : {size_t{1}, size_t{4}}) {
+        auto config = filterConfig();
+        config.threadCount = threads;
+        const auto output = temp_dir_ / ("rc" + std::to_string(threads) + ".fastq");
+        auto pipeline = fq::processing::createProcessingPipeline();
+        pipeline->setInputPath(input.string());
+        pipeline->setOutputPath(output.string());
+        pipeline->setProcessingConfig(config);
+        pipeline->addReadMutator(std::make_unique<ReverseComplementMutator>());
+        const auto stats = pipeline->run();
+
+        EXPECT_EQ(stats.totalReads, expected.size());
+        EXPECT_EQ(readRecords(output), expected) << threads << " threads";
+    }
+}
+
+TEST_F(PipelineIntegrationTest, UnorderedOutputKeepsEveryRecord) {
+    auto input = temp_dir_ / "input.fastq";
+    {
+        std::ofstream out(input);
+        out << TestHelpers::generateFastQRecords(5000, 80);
+    }
+
+    auto config = filterConfig();
+    const auto orderedStats = runFilter(input, temp_dir_ / "ordered.fastq", config);
+    config.unorderedOutput = true;
+    const auto unorderedStats = runFilter(input, temp_dir_ / "unordered.fastq", config);
+
+    auto ordered = readRecords(temp_dir_ / "ordered.fastq");
+    auto unordered = readRecords(temp_dir_ / "unordered.fastq");
+    EXPECT_EQ(orderedStats.totalReads, 5000U);
+    EXPECT_EQ(unorderedStats.passedReads, orderedStats.passedReads);
+    ASSERT_EQ(unordered.size(), orderedStats.passedReads);
+
+    std::sort(ordered.begin(), ordered.end());
+    std::sort(unordered.begin(), unordered.end());
+    EXPECT_EQ(unordered, ordered);
+}
+
+TEST_F(PipelineIntegrationTest, ByteSizedBatchesMatchRecordSizedBatches) {
+    auto input = temp_dir_ / "input.fastq";
+    {
+        std::ofstream out(input);
+        out << TestHelpers::generateFastQRecords(3000, 150);
+    }
+
+    auto config = filterConfig();
+    runFilter(input, temp_dir_ / "records.fastq", config);
+    config.batchBytes = 16 * 1024;
+    runFilter(input, temp_dir_ / "bytes.fastq", config);
+    config.adaptiveBatch = true;
+    config.batchCapacityBytes = 256 * 1024;
+    runFilter(input, temp_dir_ / "adaptive.fastq", config);
+
+    const auto expected = readRecords(temp_dir_ / "records.fastq");
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(readRecords(temp_dir_ / "bytes.fastq"), expected);
+    EXPECT_EQ(readRecords(temp_dir_ / "adaptive.fastq"), expected);
+}
+
+TEST_F(PipelineIntegrationTest, SequentialAdaptiveBatchesFollowSizer) {
+    auto input = temp_dir_ / "input.fastq";
+    {
+        std::ofstream out(input);
+        out << TestHelpers::generateFastQRecords(20000, 150);
+    }
+
+    // 单线程路径同样由 AdaptiveBatchSizer 决定每批字节数，不应停留在起步大小
+    auto config = filterConfig();
+    config.threadCount = 1;
+    config.adaptiveBatch = true;
+    config.batchBytes = 64 * 1024;
+    config.batchCapacityBytes = 1024 * 1024;
+    auto recorder = std::make_unique<BatchSizeRecorder>();
+    const auto* observed = recorder.get();
+
+    auto pipeline = fq::processing::createProcessingPipeline();
+    pipeline->setInputPath(input.string());
+    pipeline->setOutputPath((temp_dir_ / "adaptive.fastq").string());
+    pipeline->setProcessingConfig(config);
+    pipeline->addReadPredicate(std::move(recorder));
+    const auto stats = pipeline->run();
+    EXPECT_EQ(stats.totalReads, 20000U);
+
+    const auto sizes = observed->sizes();
+    ASSERT_GT(sizes.size(), 2U);
+    EXPECT_GT(*std::max_element(sizes.begin(), sizes.end()), 2 * sizes.front());
+}
+
+TEST_F(PipelineIntegrationTest, ThreadedFilterWithReadAhead) {
+    auto input = temp_dir_ / "input.fastq.gz";
+    writeGzip(input, TestHelpers::generateFastQRecords(4000, 120));
+
+    auto config = filterConfig();
+    config.readChunkBytes = 16 * 1024;
+    const auto directStats = runFilter(input, temp_dir_ / "direct.fastq", config);
+    config.readAheadBuffers = 3;
+    const auto readAheadStats = runFilter(input, temp_dir_ / "read_ahead.fastq", config);
+
+    const auto expected = readRecords(temp_dir_ / "direct.fastq");
+    EXPECT_EQ(directStats.totalReads, 4000U);
+    EXPECT_EQ(readAheadStats.totalReads, directStats.totalReads);
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(readRecords(temp_dir_ / "read_ahead.fastq"), expected);
+}
+
+TEST_F(PipelineIntegrationTest, ThreadedFilterWithIoUring) {
+    auto input = temp_dir_ / "input.fastq";
+    {
+        std::ofstream out(input);
+        out << TestHelpers::generateFastQRecords(4000, 120);
+    }
+
+    // 内核不支持 io_uring 时 Reader/Writer 回退到同步读写，输出同样应一致
+    auto config = filterConfig();
+    config.readChunkBytes = 16 * 1024;
+    config.writerBufferBytes = 16 * 1024;
+    const auto syncStats = runFilter(input, temp_dir_ / "sync.fastq", config);
+    config.ioUring = true;
+    const auto uringStats = runFilter(input, temp_dir_ / "uring.fastq", config);
+
+    const auto expected = readRecords(temp_dir_ / "sync.fastq");
+    EXPECT_EQ(syncStats.totalReads, 4000U);
+    EXPECT_EQ(uringStats.totalReads, syncStats.totalReads);
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(readRecords(temp_dir_ / "uring.fastq"), expected);
+}
+
+TEST_F(PipelineIntegrationTest, ThreadedChunksFollowMeasuredRecordSize) {
+    // 短 read 的记录远小于默认估算的 512 字节，首块之后的块大小应按实测值收敛到 batchSize 附近
+    const std::string records = TestHelpers::generateFastQRecords(20000, 20);
+    auto plain = temp_dir_ / "short.fastq";
+    {
+        std::ofstream out(plain);
+        out << records;
+    }
+    auto gzip = temp_dir_ / "short.fastq.gz";
+    writeGzip(gzip, records);
+
+    for (const auto& input : {plain, gzip}) {
+        auto config = filterConfig();
+        config.batchSize = 200;
+        auto recorder = std::make_unique<BatchSizeRecorder>();
+        const auto* observed = recorder.get();
+
+        auto pipeline = fq::processing::createProcessingPipeline();
+        pipeline->setInputPath(input.string());
+        pipeline->setOutputPath((temp_dir_ / "out.fastq").string());
+        pipeline->setProcessingConfig(config);
+        pipeline->addReadPredicate(std::move(recorder));
+        const auto stats = pipeline->run();
+        EXPECT_EQ(stats.totalReads, 20000U);
+
+        const auto sizes = observed->sizes();
+        ASSERT_GT(sizes.size(), 2U);
+        const auto oversized = std::count_if(sizes.begin(), sizes.end(),
+                                             [&](size_t n) { return n > 2 * config.batchSize; });
+        EXPECT_LE(oversized, 1) << input;
+    }
+}
+
 }  // namespace fq::test
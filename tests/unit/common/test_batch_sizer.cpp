@@ -0,0 +1,83 @@
+#include "fqtools/common/batch_sizer.h"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+namespace fq::common {
+
+namespace {
+
+using std::chrono::nanoseconds;
+
+constexpr size_t kMiB = 1024 * 1024;
+
+auto makeOptions() -> AdaptiveBatchOptions {
+    AdaptiveBatchOptions options;
+    options.initialBytes = 1 * kMiB;
+    options.minBytes = 64 * 1024;
+    options.maxBytes = 16 * kMiB;
+    options.workers = 4;
+    options.targetLatency = std::chrono::milliseconds(20);
+    return options;
+}
+
+// 按给定的每字节耗时喂入若干批
+void feed(AdaptiveBatchSizer& sizer, double readNs, double processNs, double writeNs, int batches) {
+    for (int i = 0; i < batches; ++i) {
+        const size_t bytes = sizer.batchBytes();
+        const auto cost = [bytes](double ns) {
+            return nanoseconds(static_cast<long long>(ns * static_cast<double>(bytes)));
+        };
+        sizer.record(BatchStage::Read, bytes, cost(readNs));
+        sizer.record(BatchStage::Write, bytes, cost(writeNs));
+        sizer.record(BatchStage::Process, bytes, cost(processNs));
+    }
+}
+
+}  // namespace
+
+TEST(AdaptiveBatchSizerTest, ConvergesToTargetLatencyWhenProcessingBound) {
+    AdaptiveBatchSizer sizer(makeOptions());
+    EXPECT_EQ(sizer.batchBytes(), 1 * kMiB);
+
+    // 处理 10 ns/B，串行阶段 1 ns/B：20 ms 对应 2 MB
+    feed(sizer, 1.0, 10.0, 1.0, 20);
+    EXPECT_NEAR(static_cast<double>(sizer.batchBytes()), 2'000'000.0, 1000.0);
+
+    // read 变长、处理变慢后随之缩小
+    feed(sizer, 1.0, 100.0, 1.0, 40);
+    EXPECT_NEAR(static_cast<double>(sizer.batchBytes()), 200'000.0, 1000.0);
+}
+
+TEST(AdaptiveBatchSizerTest, GrowsWhenSerialStageIsTheBottleneck) {
+    AdaptiveBatchSizer sizer(makeOptions());
+    // 读取 5 ns/B × 4 个线程 > 处理 10 ns/B，并行阶段喂不饱
+    feed(sizer, 5.0, 10.0, 1.0, 20);
+    EXPECT_EQ(sizer.batchBytes(), 16 * kMiB);
+}
+
+TEST(AdaptiveBatchSizerTest, StaysWithinBoundsAndStepLimit) {
+    auto options = makeOptions();
+    AdaptiveBatchSizer sizer(options);
+
+    // 极慢的处理一次最多把批次缩小一半，最终停在下限
+    sizer.record(BatchStage::Process, sizer.batchBytes(), nanoseconds(1'000'000'000'000));
+    EXPECT_EQ(sizer.batchBytes(), 512 * 1024U);
+    feed(sizer, 0.0, 1'000'000.0, 0.0, 20);
+    EXPECT_EQ(sizer.batchBytes(), options.minBytes);
+
+    // 空批次不计入
+    sizer.record(BatchStage::Process, 0, nanoseconds(1'000'000'000));
+    EXPECT_EQ(sizer.batchBytes(), options.minBytes);
+
+    // 极快的处理停在上限
+    AdaptiveBatchSizer fast(options);
+    feed(fast, 0.0, 0.001, 0.0, 20);
+    EXPECT_EQ(fast.batchBytes(), options.maxBytes);
+
+    options.initialBytes = 64 * kMiB;
+    EXPECT_EQ(AdaptiveBatchSizer(options).batchBytes(), options.maxBytes);
+}
+
+}  // namespace fq::common
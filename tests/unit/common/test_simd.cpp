@@ -0,0 +1,109 @@
+#include "fqtools/common/simd.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace fq::common {
+
+namespace {
+
+constexpr SimdLevel kAllLevels[] = {
+    SimdLevel::Scalar, SimdLevel::Sse42, SimdLevel::Avx2, SimdLevel::Avx512};
+
+auto makeBytes(size_t size, uint32_t seed) -> std::string {
+    std::string bytes;
+    uint32_t state = seed;
+    for (size_t i = 0; i < size; ++i) {
+        state = state * 1103515245U + 12345U;
+        bytes.push_back(static_cast<char>(state >> 16));
+    }
+    return bytes;
+}
+
+}  // namespace
+
+TEST(SimdTest, ParseSimdLevel) {
+    EXPECT_EQ(parseSimdLevel("scalar"), SimdLevel::Scalar);
+    EXPECT_EQ(parseSimdLevel("sse4.2"), SimdLevel::Sse42);
+    EXPECT_EQ(parseSimdLevel("avx2"), SimdLevel::Avx2);
+    EXPECT_EQ(parseSimdLevel("avx512"), SimdLevel::Avx512);
+    EXPECT_EQ(parseSimdLevel("auto"), detectSimdLevel());
+    EXPECT_THROW((void)parseSimdLevel("neon"), std::runtime_error);
+    for (const auto level : kAllLevels) {
+        EXPECT_EQ(parseSimdLevel(simdLevelName(level)), level);
+    }
+}
+
+TEST(SimdTest, SetSimdLevelCapsActiveLevel) {
+    setSimdLevel(SimdLevel::Scalar);
+    EXPECT_EQ(activeSimdLevel(), SimdLevel::Scalar);
+    setSimdLevel(SimdLevel::Avx512);
+    EXPECT_EQ(activeSimdLevel(), detectSimdLevel());
+}
+
+TEST(SimdTest, ByteKernelsMatchScalar) {
+    const ByteKernels& scalar = byteKernels(SimdLevel::Scalar);
+    // 长度覆盖各级向量宽度的整数倍与余数部分，阈值覆盖有符号 char 的边界
+    for (const size_t size : {0, 1, 15, 16, 33, 64, 150, 257}) {
+        std::string bytes = makeBytes(size, static_cast<uint32_t>(size) + 7);
+        for (size_t i = 0; i < bytes.size(); i += 5) {
+            bytes[i] = (i % 2 == 0) ? 'N' : 'n';
+        }
+        for (size_t i = 1; i < bytes.size(); i += 3) {
+            bytes[i] = "GCgc"[i % 4];
+        }
+        for (const auto level : kAllLevels) {
+            const ByteKernels& kernels = byteKernels(level);
+            const std::string name(simdLevelName(level));
+            EXPECT_EQ(kernels.sum(bytes.data(), size), scalar.sum(bytes.data(), size)) << name;
+            EXPECT_EQ(kernels.countLetter(bytes.data(), size, 'n'),
+                      scalar.countLetter(bytes.data(), size, 'n'))
+                << name;
+            EXPECT_EQ(kernels.countGc(bytes.data(), size), scalar.countGc(bytes.data(), size))
+                << name;
+            for (const int threshold : {-200, -128, -1, 0, 53, 100, 127, 128, 300}) {
+                EXPECT_EQ(kernels.findFirstAtLeast(bytes.data(), size, threshold),
+                          scalar.findFirstAtLeast(bytes.data(), size, threshold))
+                    << name << " size=" << size << " threshold=" << threshold;
+                EXPECT_EQ(kernels.findLastAtLeast(bytes.data(), size, threshold),
+                          scalar.findLastAtLeast(bytes.data(), size, threshold))
+                    << name << " size=" << size << " threshold=" << threshold;
+            }
+        }
+    }
+}
+
+TEST(SimdTest, StructuralMasksMatchScalar) {
+    const ByteKernels& scalar = byteKernels(SimdLevel::Scalar);
+    for (const size_t blocks : {0, 1, 3, 16}) {
+        std::string bytes = makeBytes(blocks * 64, static_cast<uint32_t>(blocks) + 11);
+        for (size_t i = 0; i < bytes.size(); i += 7) {
+            bytes[i] = "\n \t\r"[i % 4];
+        }
+        std::vector<uint64_t> expectedNewlines(blocks);
+        std::vector<uint64_t> expectedSeparators(blocks);
+        scalar.structuralMasks(bytes.data(), blocks, expectedNewlines.data(),
+                               expectedSeparators.data());
+        for (size_t k = 0; k < blocks; ++k) {
+            for (size_t j = 0; j < 64; ++j) {
+                const char c = bytes[k * 64 + j];
+                EXPECT_EQ(((expectedNewlines[k] >> j) & 1U) != 0, c == '\n');
+                EXPECT_EQ(((expectedSeparators[k] >> j) & 1U) != 0, c == ' ' || c == '\t');
+            }
+        }
+        for (const auto level : kAllLevels) {
+            std::vector<uint64_t> newlines(blocks);
+            std::vector<uint64_t> separators(blocks);
+            byteKernels(level).structuralMasks(bytes.data(), blocks, newlines.data(),
+                                               separators.data());
+            EXPECT_EQ(newlines, expectedNewlines) << simdLevelName(level);
+            EXPECT_EQ(separators, expectedSeparators) << simdLevelName(level);
+        }
+    }
+}
+
+}  // namespace fq::common
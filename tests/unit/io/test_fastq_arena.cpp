@@ -0,0 +1,58 @@
+#include "fqtools/io/fastq_batch_pool.h"
+#include "fqtools/io/fastq_io.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace fq::io {
+
+TEST(FastqArenaTest, AllocationsStayValidUntilReset) {
+    FastqArena arena;
+    EXPECT_EQ(arena.capacity(), 0U);
+
+    // 跨越多个块，早先分配的内容不随新块移动
+    std::vector<std::string> expected;
+    std::vector<std::string_view> copies;
+    for (int i = 0; i < 2000; ++i) {
+        expected.push_back(std::string(static_cast<size_t>(50 + i % 300), "ACGT"[i % 4]) +
+                           std::to_string(i));
+        copies.push_back(arena.copy(expected.back()));
+    }
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(copies[i], expected[i]);
+    }
+
+    // reset 后合并为一块，同样大小的下一批不再分配
+    const size_t capacity = arena.capacity();
+    arena.reset();
+    EXPECT_EQ(arena.capacity(), capacity);
+    const char* first = arena.allocate(1);
+    size_t used = 1;
+    for (const auto& text : expected) {
+        const auto copy = arena.copy(text);
+        EXPECT_EQ(copy.data(), first + used);
+        used += text.size();
+    }
+    EXPECT_EQ(arena.capacity(), capacity);
+
+    // 单次分配大于默认块
+    const auto big = std::string(1 << 20, 'N');
+    EXPECT_EQ(arena.copy(big), big);
+}
+
+TEST(FastqArenaTest, BatchResetClearsArena) {
+    FastqBatch batch(1024);
+    const auto view = batch.arena().copy("ACGT");
+    EXPECT_EQ(view, "ACGT");
+    const size_t capacity = batch.arena().capacity();
+    EXPECT_GT(capacity, 0U);
+
+    resetFastqBatch(batch);
+    EXPECT_EQ(batch.arena().capacity(), capacity);
+    EXPECT_EQ(batch.arena().copy("TTTT").data(), view.data());
+}
+
+}  // namespace fq::io
@@ -0,0 +1,172 @@
+#include "fqtools/io/fastq_index.h"
+#include "fqtools/io/fastq_reader.h"
+#include "fqtools/io/fastq_writer.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace fq::io {
+
+class FastqIndexTest : public ::testing::Test {
+protected:
+    static constexpr int kRecords = 2500;
+
+    void SetUp() override {
+        plainPath_ = "test_index.fastq";
+        bgzfPath_ = "test_index.fastq.gz";
+        FastqWriterOptions options;
+        options.compression = FastqWriterCompressionMode::Gzip;
+        FastqWriter writer(bgzfPath_, options);
+        std::ofstream plain(plainPath_);
+        plain << "\n";  // 开头的空行不影响记录偏移
+        for (int i = 0; i < kRecords; ++i) {
+            const std::string id = std::string("r").append(std::to_string(i));
+            const std::string seq(static_cast<size_t>(30 + (i % 71)), "ACGT"[i % 4]);
+            const std::string qual(seq.size(), i % 2 == 0 ? '@' : '+');
+            plain << "@" << id << "\n" << seq << "\n+\n" << qual << "\n";
+            FastqRecord rec;
+            rec.id = id;
+            rec.seq = seq;
+            rec.qual = qual;
+            writer.write(rec);
+        }
+    }
+
+    void TearDown() override {
+        for (const auto& path : {plainPath_, bgzfPath_, plainPath_ + ".fqi"}) {
+            std::filesystem::remove(path);
+        }
+    }
+
+    static auto readIds(FastqReader& reader, size_t maxRecords) -> std::vector<std::string> {
+        std::vector<std::string> ids;
+        FastqBatch batch;
+        while (reader.nextBatch(batch, maxRecords)) {
+            for (const auto& rec : batch) {
+                ids.emplace_back(rec.id);
+            }
+        }
+        return ids;
+    }
+
+    static auto expectedIds(uint64_t first, uint64_t count) -> std::vector<std::string> {
+        std::vector<std::string> ids;
+        for (uint64_t i = first; i < std::min<uint64_t>(kRecords, first + count); ++i) {
+            ids.push_back(std::string("r").append(std::to_string(i)));
+        }
+        return ids;
+    }
+
+    std::string plainPath_;
+    std::string bgzfPath_;
+};
+
+TEST_F(FastqIndexTest, SaveLoadRoundTrip) {
+    const auto index = FastqIndex::build(plainPath_, 100);
+    EXPECT_EQ(index.format(), FastqIndexFormat::Plain);
+    EXPECT_EQ(index.totalRecords(), static_cast<uint64_t>(kRecords));
+    ASSERT_EQ(index.entries().size(), 25U);
+    EXPECT_EQ(index.entries()[0].offset, 1U);
+
+    const auto path = FastqIndex::defaultPath(plainPath_);
+    index.save(path);
+    const auto loaded = FastqIndex::load(path);
+    EXPECT_EQ(loaded.sourceSize(), std::filesystem::file_size(plainPath_));
+    EXPECT_EQ(loaded.interval(), 100U);
+    ASSERT_EQ(loaded.entries().size(), index.entries().size());
+    for (size_t i = 0; i < index.entries().size(); ++i) {
+        EXPECT_EQ(loaded.entries()[i].recordNumber, index.entries()[i].recordNumber);
+        EXPECT_EQ(loaded.entries()[i].offset, index.entries()[i].offset);
+    }
+    EXPECT_EQ(loaded.checkpointFor(1234).recordNumber, 1200U);
+}
+
+TEST_F(FastqIndexTest, CorruptEntryCountThrowsBeforeAllocating) {
+    const auto path = FastqIndex::defaultPath(plainPath_);
+    FastqIndex::build(plainPath_, 100).save(path);
+    std::string valid;
+    {
+        std::ifstream in(path, std::ios::binary);
+        valid.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    // 头部字段偏移：interval 为 u64@24，totalRecords 为 u64@32，条目数为 u64@40
+    auto putField = [](std::string& bytes, size_t offset, uint64_t value) {
+        for (size_t i = 0; i < 8; ++i) {
+            bytes[offset + i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+    };
+    auto expectCorrupt = [&](const std::string& bytes) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+        try {
+            (void)FastqIndex::load(path);
+            ADD_FAILURE() << "corrupt index was accepted";
+        } catch (const std::runtime_error& e) {
+            EXPECT_NE(std::string(e.what()).find("Corrupted FASTQ index"), std::string::npos)
+                << e.what();
+        }
+    };
+
+    // 与 totalRecords/interval 自洽、但远超文件大小的条目数
+    for (const uint64_t count : {uint64_t{1} << 40, uint64_t{1} << 62, ~uint64_t{0}}) {
+        std::string bytes = valid;
+        putField(bytes, 24, 1);
+        putField(bytes, 32, count);
+        putField(bytes, 40, count);
+        expectCorrupt(bytes);
+    }
+    expectCorrupt(valid.substr(0, valid.size() - 1));
+}
+
+TEST_F(FastqIndexTest, SeekToRecordRange) {
+    for (const auto& path : {plainPath_, bgzfPath_}) {
+        const auto index = FastqIndex::build(path, 64);
+        for (const auto mode : {FastqReaderInputMode::Auto, FastqReaderInputMode::Stream}) {
+            FastqReaderOptions options;
+            options.inputMode = mode;
+            options.readChunkBytes = 1000;
+
+            FastqReader ranged(path, options);
+            ranged.seekToRecord(index, 1000, 333);
+            EXPECT_EQ(readIds(ranged, 50), expectedIds(1000, 333)) << path;
+
+            FastqReader tail(path, options);
+            tail.seekToRecord(index, 2400);
+            EXPECT_EQ(readIds(tail, 1000), expectedIds(2400, 1000)) << path;
+
+            FastqReader past(path, options);
+            past.seekToRecord(index, kRecords);
+            EXPECT_TRUE(readIds(past, 10).empty());
+        }
+    }
+}
+
+TEST_F(FastqIndexTest, RangedChunksArePreParsed) {
+    const auto index = FastqIndex::build(bgzfPath_);
+    FastqReader reader(bgzfPath_);
+    reader.seekToRecord(index, 10, 20);
+    FastqBatch batch;
+    size_t total = 0;
+    while (reader.nextChunk(batch, 7)) {
+        FastqReader::parseChunk(batch);
+        total += batch.size();
+    }
+    EXPECT_EQ(total, 20U);
+}
+
+TEST_F(FastqIndexTest, RejectsMismatchedInput) {
+    const auto index = FastqIndex::build(plainPath_);
+    FastqReader bgzf(bgzfPath_);
+    EXPECT_THROW(bgzf.seekToRecord(index, 0), std::runtime_error);
+
+    std::ofstream(plainPath_, std::ios::app) << "@extra\nA\n+\nI\n";
+    FastqReader stale(plainPath_);
+    EXPECT_THROW(stale.seekToRecord(index, 0), std::runtime_error);
+}
+
+}  // namespace fq::io
@@ -1,11 +1,19 @@
 #include "fqtools/io/fastq_reader.h"
 #include "fqtools/io/fastq_io.h"
+#include "fqtools/io/fastq_index.h"
+#include "fqtools/io/fastq_writer.h"
 #include "fqtools/error/error.h"
+#include "fqtools/common/simd.h"
+#include "io/uring_file.h"
 
 #include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
+#include <zlib.h>
 
 class FastqReaderTest : public ::testing::Test {
 protected:
@@ -68,6 +76,599 @@ TEST_F(FastqReaderTest, ReadBasic) {
     EXPECT_TRUE(batch.records().empty());
 }
 
+TEST_F(FastqReaderTest, MmapModeIsZeroCopy) {
+    fq::io::FastqReaderOptions options;
+    options.inputMode = fq::io::FastqReaderInputMode::Mmap;
+    fq::io::FastqReader reader(tmpFile_, options);
+    ASSERT_TRUE(reader.isOpen());
+    EXPECT_TRUE(reader.isMemoryMapped());
+
+    fq::io::FastqBatch batch;
+    ASSERT_TRUE(reader.nextBatch(batch));
+    ASSERT_EQ(batch.size(), 3);
+    EXPECT_TRUE(batch.buffer().empty());
+
+    const auto data = batch.data();
+    for (const auto& rec : batch) {
+        EXPECT_GE(rec.seq.data(), data.data());
+        EXPECT_LE(rec.qual.data() + rec.qual.size(), data.data() + data.size());
+    }
+    EXPECT_EQ(batch.records()[1].comment, "length=4");
+    EXPECT_EQ(batch.records()[2].qual, "IIIIIIIIIIII");
+    EXPECT_FALSE(reader.nextBatch(batch));
+}
+
+TEST_F(FastqReaderTest, MmapMatchesStreamWithRecordLimit) {
+    fq::io::FastqReaderOptions streamOptions;
+    streamOptions.inputMode = fq::io::FastqReaderInputMode::Stream;
+    fq::io::FastqReader streamReader(tmpFile_, streamOptions);
+    EXPECT_FALSE(streamReader.isMemoryMapped());
+
+    fq::io::FastqReader mappedReader(tmpFile_);
+    EXPECT_TRUE(mappedReader.isMemoryMapped());
+
+    fq::io::FastqBatch streamBatch;
+    fq::io::FastqBatch mappedBatch;
+    size_t batches = 0;
+    while (streamReader.nextBatch(streamBatch, 2)) {
+        ASSERT_TRUE(mappedReader.nextBatch(mappedBatch, 2));
+        ASSERT_EQ(streamBatch.size(), mappedBatch.size());
+        for (size_t i = 0; i < streamBatch.size(); ++i) {
+            EXPECT_EQ(streamBatch.records()[i].id, mappedBatch.records()[i].id);
+            EXPECT_EQ(streamBatch.records()[i].seq, mappedBatch.records()[i].seq);
+            EXPECT_EQ(streamBatch.records()[i].qual, mappedBatch.records()[i].qual);
+        }
+        EXPECT_EQ(streamBatch.data(), mappedBatch.data());
+        ++batches;
+    }
+    EXPECT_EQ(batches, 2);
+    EXPECT_FALSE(mappedReader.nextBatch(mappedBatch));
+}
+
+TEST(FastqReaderChunkTest, ChunksSplitOnlyAtRecordBoundaries) {
+    // 质量行以 '@' / '+' 开头，用于验证边界判定不会被质量行误导
+    const std::string path = "test_reader_chunks.fastq";
+    std::vector<std::string> expectedIds;
+    {
+        std::ofstream out(path);
+        for (int i = 0; i < 500; ++i) {
+            const std::string seq(static_cast<size_t>(20 + (i % 37)), "ACGT"[i % 4]);
+            std::string qual(seq.size(), 'I');
+            qual[0] = (i % 3 == 0) ? '@' : (i % 3 == 1 ? '+' : 'F');
+            out << "@r" << i << " c\n" << seq << "\n+\n" << qual << "\n";
+            if (i % 50 == 0) {
+                out << "\n";
+            }
+            expectedIds.push_back(std::string("r").append(std::to_string(i)));
+        }
+    }
+
+    for (const auto mode : {fq::io::FastqReaderInputMode::Stream, fq::io::FastqReaderInputMode::Mmap}) {
+        fq::io::FastqReaderOptions options;
+        options.inputMode = mode;
+        options.readChunkBytes = 97;
+        options.maxBufferBytes = 1024;
+        fq::io::FastqReader reader(path, options);
+        ASSERT_TRUE(reader.isOpen());
+
+        std::vector<std::string> ids;
+        size_t chunks = 0;
+        fq::io::FastqBatch batch;
+        while (reader.nextChunk(batch, 4)) {
+            EXPECT_TRUE(batch.records().empty());
+            fq::io::FastqReader::parseChunk(batch);
+            for (const auto& rec : batch) {
+                EXPECT_EQ(rec.seq.size(), rec.qual.size());
+                EXPECT_EQ(rec.comment, "c");
+                ids.emplace_back(rec.id);
+            }
+            ++chunks;
+        }
+        EXPECT_GT(chunks, 10);
+        EXPECT_EQ(ids, expectedIds);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(FastqReaderChunkTest, TargetBatchBytesSizesChunks) {
+    const std::string path = "test_reader_batch_bytes.fastq";
+    size_t total = 0;
+    {
+        std::ofstream out(path);
+        for (int i = 0; i < 400; ++i) {
+            const std::string seq(static_cast<size_t>(40 + (i % 41)), "ACGT"[i % 4]);
+            const std::string record =
+                "@r" + std::to_string(i) + "\n" + seq + "\n+\n" + std::string(seq.size(), 'I') + "\n";
+            out << record;
+            total += record.size();
+        }
+    }
+    constexpr size_t kMaxRecordBytes = 200;
+    constexpr size_t kChunkBytes = 256;
+
+    for (const auto mode : {fq::io::FastqReaderInputMode::Stream, fq::io::FastqReaderInputMode::Mmap}) {
+        fq::io::FastqReaderOptions options;
+        options.inputMode = mode;
+        options.readChunkBytes = kChunkBytes;
+        options.targetBatchBytes = 4000;
+        fq::io::FastqReader reader(path, options);
+        ASSERT_TRUE(reader.isOpen());
+
+        // 记录数上限很小时，数据块大小仍由目标字节数决定
+        size_t seen = 0;
+        size_t target = options.targetBatchBytes;
+        fq::io::FastqBatch batch;
+        while (reader.nextChunk(batch, 1)) {
+            const size_t size = batch.data().size();
+            seen += size;
+            if (seen < total) {
+                EXPECT_GE(size + kMaxRecordBytes, target);
+                EXPECT_LE(size, target + kChunkBytes);
+            }
+            if (seen > total / 2 && target != 1000) {
+                target = 1000;
+                reader.setTargetBatchBytes(target);
+            }
+        }
+        EXPECT_EQ(seen, total);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(FastqReaderChunkTest, StreamBatchesReferenceReadBlocksInPlace) {
+    const std::string path = "test_reader_stream_blocks.fastq";
+    std::string content;
+    for (int i = 0; i < 300; ++i) {
+        // 夹杂比 readChunkBytes 更长的记录，尾部经常跨批次
+        const size_t len = (i % 25 == 0) ? 700 : static_cast<size_t>(30 + (i % 53));
+        const std::string seq(len, "ACGT"[i % 4]);
+        content += "@r" + std::to_string(i) + "\n" + seq + "\n+\n" + std::string(len, 'I') + "\n";
+    }
+    {
+        std::ofstream out(path);
+        out << content;
+    }
+
+    fq::io::FastqReaderOptions options;
+    options.inputMode = fq::io::FastqReaderInputMode::Stream;
+    options.readChunkBytes = 256;
+    options.targetBatchBytes = 1000;
+
+    // 批次全部保留：同一数据块内相邻批次首尾相接，说明尾部没有被拷贝
+    {
+        fq::io::FastqReader reader(path, options);
+        std::vector<fq::io::FastqBatch> batches;
+        std::string joined;
+        size_t adjacent = 0;
+        while (true) {
+            fq::io::FastqBatch batch(0, 0);
+            if (!reader.nextChunk(batch, 1)) {
+                break;
+            }
+            EXPECT_TRUE(batch.buffer().empty());
+            const auto data = batch.data();
+            if (!batches.empty()) {
+                const auto prev = batches.back().data();
+                adjacent += (prev.data() + prev.size() == data.data()) ? 1 : 0;
+            }
+            joined.append(data);
+            batches.push_back(std::move(batch));
+        }
+        EXPECT_EQ(joined, content);
+        EXPECT_GT(batches.size(), 20U);
+        EXPECT_GE(adjacent * 2, batches.size());
+    }
+
+    // 复用同一个批次对象：释放后的数据块被重新填充，内容不受影响
+    {
+        fq::io::FastqReader reader(path, options);
+        fq::io::FastqBatch batch;
+        size_t records = 0;
+        while (reader.nextBatch(batch, 7)) {
+            for (const auto& rec : batch) {
+                EXPECT_EQ(rec.seq.size(), rec.qual.size());
+                EXPECT_EQ(rec.id, "r" + std::to_string(records));
+                ++records;
+            }
+        }
+        EXPECT_EQ(records, 300U);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(FastqReaderChunkTest, ParseChunkHandlesCrlfAndSeparatorsAtEverySimdLevel) {
+    struct Expected {
+        std::string id;
+        std::string comment;
+        std::string seq;
+    };
+    std::string text;
+    std::vector<Expected> expected;
+    for (int i = 0; i < 200; ++i) {
+        // 头行长短不一，使记录跨越 64 字节块与 1 KiB 位图分组的边界
+        const std::string id = "r" + std::to_string(i) + std::string(static_cast<size_t>(i % 97), 'x');
+        const std::string comment = (i % 3 == 0) ? "" : (i % 3 == 1 ? "a b" : "t\tc");
+        const std::string seq(static_cast<size_t>(1 + (i * 37) % 190), "ACGT"[i % 4]);
+        const std::string eol = (i % 2 == 0) ? "\r\n" : "\n";
+        text += "@" + id;
+        if (!comment.empty()) {
+            text += (i % 3 == 1 ? " " : "\t") + comment;
+        }
+        text += eol + seq + eol + "+" + eol + std::string(seq.size(), 'I') + eol;
+        if (i % 50 == 0) {
+            text += eol;
+        }
+        expected.push_back({id, comment, seq});
+    }
+    // 最后一行没有换行符
+    text += "@last\nAC\n+\nII";
+    expected.push_back({"last", "", "AC"});
+
+    for (const auto level : {fq::common::SimdLevel::Scalar, fq::common::SimdLevel::Sse42,
+                             fq::common::SimdLevel::Avx2, fq::common::SimdLevel::Avx512}) {
+        fq::common::setSimdLevel(level);
+        fq::io::FastqBatch batch;
+        batch.buffer().assign(text.begin(), text.end());
+        fq::io::FastqReader::parseChunk(batch);
+        ASSERT_EQ(batch.size(), expected.size()) << fq::common::simdLevelName(level);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            const auto& rec = batch.records()[i];
+            EXPECT_EQ(rec.id, expected[i].id) << i;
+            EXPECT_EQ(rec.comment, expected[i].comment) << i;
+            EXPECT_EQ(rec.seq, expected[i].seq) << i;
+            EXPECT_EQ(rec.qual, std::string(expected[i].seq.size(), 'I')) << i;
+        }
+    }
+    fq::common::setSimdLevel(fq::common::SimdLevel::Avx512);
+}
+
+TEST(FastqReaderBgzfTest, ParallelBgzfMatchesPlainGzip) {
+    const std::string bgzfPath = "test_reader_bgzf.fastq.gz";
+    const std::string gzipPath = "test_reader_plain.fastq.gz";
+    std::vector<std::string> expectedIds;
+    {
+        fq::io::FastqWriterOptions writerOptions;
+        writerOptions.compression = fq::io::FastqWriterCompressionMode::Gzip;
+        fq::io::FastqWriter writer(bgzfPath, writerOptions);
+        gzFile plain = gzopen(gzipPath.c_str(), "wb");
+        ASSERT_NE(plain, nullptr);
+        for (int i = 0; i < 5000; ++i) {
+            const std::string id = std::string("r").append(std::to_string(i));
+            const std::string seq(static_cast<size_t>(50 + (i % 101)), "ACGT"[i % 4]);
+            const std::string qual(seq.size(), static_cast<char>('!' + (i % 41)));
+            fq::io::FastqRecord rec;
+            rec.id = id;
+            rec.seq = seq;
+            rec.qual = qual;
+            writer.write(rec);
+            const std::string text = "@" + id + "\n" + seq + "\n+\n" + qual + "\n";
+            gzwrite(plain, text.data(), static_cast<unsigned>(text.size()));
+            expectedIds.push_back(id);
+        }
+        gzclose(plain);
+    }
+
+    auto readIds = [](const std::string& path, size_t threads, bool expectBgzf) {
+        fq::io::FastqReaderOptions options;
+        options.decompressionThreads = threads;
+        options.readChunkBytes = 4096;
+        fq::io::FastqReader reader(path, options);
+        EXPECT_TRUE(reader.isOpen());
+        EXPECT_EQ(reader.isBgzf(), expectBgzf);
+        std::vector<std::string> ids;
+        fq::io::FastqBatch batch;
+        while (reader.nextBatch(batch, 700)) {
+            for (const auto& rec : batch) {
+                EXPECT_EQ(rec.seq.size(), rec.qual.size());
+                ids.emplace_back(rec.id);
+            }
+        }
+        return ids;
+    };
+
+    EXPECT_EQ(readIds(bgzfPath, 1, true), expectedIds);
+    EXPECT_EQ(readIds(bgzfPath, 4, true), expectedIds);
+    EXPECT_EQ(readIds(gzipPath, 4, false), expectedIds);
+
+    std::filesystem::remove(bgzfPath);
+    std::filesystem::remove(gzipPath);
+}
+
+TEST(FastqReaderBgzfTest, LargeExtraFieldBeforeBcSubfield) {
+    const std::string sourcePath = "test_reader_bgzf_source.fastq.gz";
+    const std::string path = "test_reader_bgzf_extra.fastq.gz";
+    std::vector<std::string> expectedIds;
+    {
+        fq::io::FastqWriterOptions writerOptions;
+        writerOptions.compression = fq::io::FastqWriterCompressionMode::Gzip;
+        fq::io::FastqWriter writer(sourcePath, writerOptions);
+        for (int i = 0; i < 3000; ++i) {
+            const std::string id = std::string("x").append(std::to_string(i));
+            const std::string seq(static_cast<size_t>(40 + (i % 83)), "ACGT"[i % 4]);
+            const std::string qual(seq.size(), static_cast<char>('!' + (i % 41)));
+            fq::io::FastqRecord rec;
+            rec.id = id;
+            rec.seq = seq;
+            rec.qual = qual;
+            writer.write(rec);
+            expectedIds.push_back(id);
+        }
+    }
+
+    // 在每个块的 BC 子字段之前插入一个 200 字节的子字段，并相应调整 XLEN 与 BSIZE
+    std::string source;
+    {
+        std::ifstream in(sourcePath, std::ios::binary);
+        source.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    constexpr size_t kExtraPayload = 200;
+    auto le16 = [](size_t v) { return std::string{static_cast<char>(v & 0xff), static_cast<char>((v >> 8) & 0xff)}; };
+    auto getLe16 = [&](size_t pos) {
+        return static_cast<size_t>(static_cast<unsigned char>(source[pos])) |
+            (static_cast<size_t>(static_cast<unsigned char>(source[pos + 1])) << 8);
+    };
+    std::string rewritten;
+    size_t blocks = 0;
+    for (size_t pos = 0; pos < source.size(); ++blocks) {
+        ASSERT_EQ(getLe16(pos + 10), 6U);  // 只有 BC 子字段
+        const size_t blockSize = getLe16(pos + 16) + 1;
+        const size_t newBlockSize = blockSize + 4 + kExtraPayload;
+        rewritten += source.substr(pos, 10);
+        rewritten += le16(6 + 4 + kExtraPayload);
+        rewritten += "XY" + le16(kExtraPayload) + std::string(kExtraPayload, 'z');
+        rewritten += "BC" + le16(2) + le16(newBlockSize - 1);
+        rewritten += source.substr(pos + 18, blockSize - 18);
+        pos += blockSize;
+    }
+    ASSERT_GT(blocks, 2U);
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << rewritten;
+    }
+
+    for (const size_t threads : {size_t{1}, size_t{4}}) {
+        fq::io::FastqReaderOptions options;
+        options.decompressionThreads = threads;
+        options.readChunkBytes = 4096;
+        fq::io::FastqReader reader(path, options);
+        ASSERT_TRUE(reader.isOpen());
+        EXPECT_TRUE(reader.isBgzf());
+        std::vector<std::string> ids;
+        fq::io::FastqBatch batch;
+        while (reader.nextBatch(batch, 500)) {
+            for (const auto& rec : batch) {
+                ids.emplace_back(rec.id);
+            }
+        }
+        EXPECT_EQ(ids, expectedIds);
+    }
+
+    // 建索引时按块头扫描整个文件
+    const auto index = fq::io::FastqIndex::build(path, 100);
+    EXPECT_EQ(index.format(), fq::io::FastqIndexFormat::Bgzf);
+    EXPECT_EQ(index.totalRecords(), expectedIds.size());
+
+    std::filesystem::remove(sourcePath);
+    std::filesystem::remove(path);
+}
+
+TEST(FastqReaderGzipTest, SpeculativeInflateMatchesZlib) {
+    // 两个成员拼接，段大小远小于文件，保证大部分段从推测的块边界开始解码
+    const std::string path = "test_reader_speculative.fastq.gz";
+    std::vector<std::string> expectedIds;
+    for (int member = 0; member < 2; ++member) {
+        gzFile out = gzopen(path.c_str(), member == 0 ? "wb" : "ab");
+        ASSERT_NE(out, nullptr);
+        for (int i = 0; i < 20000; ++i) {
+            const std::string id = std::string("m").append(std::to_string(member)).append(":").append(std::to_string(i));
+            std::string seq(static_cast<size_t>(60 + (i * 7) % 90), 'A');
+            for (size_t j = 0; j < seq.size(); ++j) {
+                seq[j] = "ACGTN"[(i * 31 + j * j) % 5];
+            }
+            std::string qual(seq.size(), 'I');
+            for (size_t j = 0; j < qual.size(); ++j) {
+                qual[j] = static_cast<char>('!' + (i + j * 13) % 41);
+            }
+            const std::string text = "@" + id + "\n" + seq + "\n+\n" + qual + "\n";
+            gzwrite(out, text.data(), static_cast<unsigned>(text.size()));
+            expectedIds.push_back(id);
+        }
+        gzclose(out);
+    }
+
+    for (const size_t threads : {size_t{1}, size_t{4}}) {
+        fq::io::FastqReaderOptions options;
+        options.speculativeInflate = true;
+        options.decompressionThreads = threads;
+        options.readChunkBytes = 16 * 1024;
+        fq::io::FastqReader reader(path, options);
+        ASSERT_TRUE(reader.isOpen());
+        EXPECT_FALSE(reader.isBgzf());
+
+        std::vector<std::string> ids;
+        fq::io::FastqBatch batch;
+        while (reader.nextBatch(batch, 1000)) {
+            for (const auto& rec : batch) {
+                EXPECT_EQ(rec.seq.size(), rec.qual.size());
+                ids.emplace_back(rec.id);
+            }
+        }
+        EXPECT_EQ(ids, expectedIds);
+    }
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) * 3 / 4);
+    fq::io::FastqReaderOptions options;
+    options.speculativeInflate = true;
+    options.decompressionThreads = 4;
+    fq::io::FastqReader truncated(path, options);
+    fq::io::FastqBatch batch;
+    EXPECT_THROW(
+        {
+            while (truncated.nextBatch(batch)) {
+            }
+        },
+        std::runtime_error);
+
+    std::filesystem::remove(path);
+}
+
+TEST(FastqReaderReadAheadTest, ReadAheadMatchesDirectReads) {
+    const std::string plainPath = "test_reader_read_ahead.fastq";
+    const std::string gzipPath = "test_reader_read_ahead.fastq.gz";
+    std::vector<std::string> expectedIds;
+    {
+        std::ofstream plain(plainPath);
+        gzFile gz = gzopen(gzipPath.c_str(), "wb");
+        ASSERT_NE(gz, nullptr);
+        for (int i = 0; i < 3000; ++i) {
+            const std::string id = std::string("ra").append(std::to_string(i));
+            const std::string seq(static_cast<size_t>(30 + (i % 97)), "ACGT"[i % 4]);
+            const std::string text = "@" + id + "\n" + seq + "\n+\n" + std::string(seq.size(), 'I') + "\n";
+            plain << text;
+            gzwrite(gz, text.data(), static_cast<unsigned>(text.size()));
+            expectedIds.push_back(id);
+        }
+        gzclose(gz);
+    }
+
+    auto readIds = [](const std::string& path, size_t readAhead, size_t shardIndex, size_t shardCount) {
+        fq::io::FastqReaderOptions options;
+        options.inputMode = fq::io::FastqReaderInputMode::Stream;
+        options.readChunkBytes = 1000;
+        options.readAheadBuffers = readAhead;
+        options.shardIndex = shardIndex;
+        options.shardCount = shardCount;
+        fq::io::FastqReader reader(path, options);
+        EXPECT_TRUE(reader.isOpen());
+        std::vector<std::string> ids;
+        fq::io::FastqBatch batch;
+        while (reader.nextChunk(batch, 100)) {
+            fq::io::FastqReader::parseChunk(batch);
+            for (const auto& rec : batch) {
+                EXPECT_EQ(rec.seq.size(), rec.qual.size());
+                ids.emplace_back(rec.id);
+            }
+        }
+        return ids;
+    };
+
+    for (const size_t buffers : {size_t{2}, size_t{8}}) {
+        EXPECT_EQ(readIds(plainPath, buffers, 0, 1), expectedIds);
+        EXPECT_EQ(readIds(gzipPath, buffers, 0, 1), expectedIds);
+
+        // 分片在构造时 seek，预读线程从分片起点开始
+        auto ids = readIds(plainPath, buffers, 0, 3);
+        for (size_t shard = 1; shard < 3; ++shard) {
+            const auto part = readIds(plainPath, buffers, shard, 3);
+            ids.insert(ids.end(), part.begin(), part.end());
+        }
+        EXPECT_EQ(ids, expectedIds);
+    }
+
+    // 解压错误在 I/O 线程上发生，仍在读取方抛出
+    std::filesystem::resize_file(gzipPath, std::filesystem::file_size(gzipPath) / 2);
+    fq::io::FastqReaderOptions options;
+    options.speculativeInflate = true;
+    options.readAheadBuffers = 2;
+    fq::io::FastqReader truncated(gzipPath, options);
+    fq::io::FastqBatch batch;
+    EXPECT_THROW(
+        {
+            while (truncated.nextBatch(batch)) {
+            }
+        },
+        std::runtime_error);
+
+    std::filesystem::remove(plainPath);
+    std::filesystem::remove(gzipPath);
+}
+
+TEST(FastqReaderReadAheadTest, LongRecordsSpanReadAheadBlocks) {
+    // 记录远长于预读块开头预留的空间时，尾部无法拼到新块开头，需要退回拷贝
+    const std::string path = "test_reader_read_ahead_long.fastq";
+    std::vector<std::string> expected;
+    {
+        std::ofstream out(path);
+        for (int i = 0; i < 300; ++i) {
+            const size_t length = i % 50 == 7 ? 200000 : static_cast<size_t>(40 + i % 61);
+            const std::string seq(length, "ACGT"[i % 4]);
+            out << "@l" << i << "\n" << seq << "\n+\n" << std::string(length, 'I') << "\n";
+            expected.push_back(seq);
+        }
+    }
+
+    fq::io::FastqReaderOptions options;
+    options.inputMode = fq::io::FastqReaderInputMode::Stream;
+    options.readChunkBytes = 1000;
+    options.readAheadBuffers = 4;
+    fq::io::FastqReader reader(path, options);
+    std::vector<std::string> seqs;
+    fq::io::FastqBatch batch;
+    while (reader.nextBatch(batch, 10)) {
+        for (const auto& rec : batch) {
+            seqs.emplace_back(rec.seq);
+        }
+    }
+    EXPECT_EQ(seqs, expected);
+    std::filesystem::remove(path);
+}
+
+TEST(FastqReaderUringTest, IoUringMatchesDirectReads) {
+    const std::string path = "test_reader_uring.fastq";
+    std::vector<std::string> expectedIds;
+    {
+        std::ofstream out(path);
+        for (int i = 0; i < 3000; ++i) {
+            const std::string id = std::string("u").append(std::to_string(i));
+            const std::string seq(static_cast<size_t>(20 + (i % 131)), "ACGT"[i % 4]);
+            out << "@" << id << "\n" << seq << "\n+\n" << std::string(seq.size(), 'I') << "\n";
+            expectedIds.push_back(id);
+        }
+    }
+
+    auto readIds = [&](fq::io::FastqReaderInputMode mode, size_t readAhead, size_t shardIndex,
+                       size_t shardCount) {
+        fq::io::FastqReaderOptions options;
+        options.inputMode = mode;
+        options.ioUring = true;
+        options.readChunkBytes = 1000;
+        options.readAheadBuffers = readAhead;
+        options.shardIndex = shardIndex;
+        options.shardCount = shardCount;
+        fq::io::FastqReader reader(path, options);
+        EXPECT_TRUE(reader.isOpen());
+        if (mode == fq::io::FastqReaderInputMode::Auto) {
+            // 支持 io_uring 时 Auto 模式不再映射文件
+            EXPECT_EQ(reader.isMemoryMapped(), !fq::io::ioUringSupported());
+        }
+        std::vector<std::string> ids;
+        fq::io::FastqBatch batch;
+        while (reader.nextBatch(batch, 70)) {
+            for (const auto& rec : batch) {
+                EXPECT_EQ(rec.seq.size(), rec.qual.size());
+                ids.emplace_back(rec.id);
+            }
+        }
+        return ids;
+    };
+
+    EXPECT_EQ(readIds(fq::io::FastqReaderInputMode::Auto, 0, 0, 1), expectedIds);
+    EXPECT_EQ(readIds(fq::io::FastqReaderInputMode::Stream, 0, 0, 1), expectedIds);
+    EXPECT_EQ(readIds(fq::io::FastqReaderInputMode::Stream, 4, 0, 1), expectedIds);
+
+    auto ids = readIds(fq::io::FastqReaderInputMode::Stream, 0, 0, 3);
+    for (size_t shard = 1; shard < 3; ++shard) {
+        const auto part = readIds(fq::io::FastqReaderInputMode::Stream, 0, shard, 3);
+        ids.insert(ids.end(), part.begin(), part.end());
+    }
+    EXPECT_EQ(ids, expectedIds);
+
+    std::filesystem::remove(path);
+}
+
 TEST_F(FastqReaderTest, SmallBufferBoundary) {
     // This test is hard to deterministicly trigger buffer resizing logic
     // without mocking internal buffer size, but it verifies overall correctness.
@@ -0,0 +1,194 @@
+#include "fqtools/io/fastq_index.h"
+#include "fqtools/io/fastq_merge.h"
+#include "fqtools/io/fastq_reader.h"
+#include "fqtools/io/fastq_writer.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+namespace fq::io {
+
+class FastqShardTest : public ::testing::Test {
+protected:
+    static constexpr int kRecords = 1500;
+
+    void SetUp() override {
+        plainPath_ = "test_shard.fastq";
+        bgzfPath_ = "test_shard.fastq.gz";
+        FastqWriterOptions options;
+        options.compression = FastqWriterCompressionMode::Gzip;
+        FastqWriter writer(bgzfPath_, options);
+        std::ofstream plain(plainPath_);
+        for (int i = 0; i < kRecords; ++i) {
+            const std::string id = std::string("r").append(std::to_string(i));
+            const std::string seq(static_cast<size_t>(20 + (i % 53)), "ACGTN"[i % 5]);
+            // 质量行以 '@' 或 '+' 开头，分片边界不能把它们误认成记录头或分隔行
+            std::string qual(seq.size(), 'I');
+            qual[0] = i % 3 == 0 ? '@' : (i % 3 == 1 ? '+' : 'I');
+            plain << "@" << id << "\n" << seq << "\n+\n" << qual << "\n";
+            FastqRecord rec;
+            rec.id = id;
+            rec.seq = seq;
+            rec.qual = qual;
+            writer.write(rec);
+        }
+    }
+
+    void TearDown() override {
+        for (const auto& path : {plainPath_, bgzfPath_, bgzfPath_ + ".fqi"}) {
+            std::filesystem::remove(path);
+        }
+        for (const auto& path : extraPaths_) {
+            std::filesystem::remove(path);
+        }
+    }
+
+    static auto readIds(FastqReader& reader) -> std::vector<std::string> {
+        std::vector<std::string> ids;
+        FastqBatch batch;
+        while (reader.nextBatch(batch, 97)) {
+            for (const auto& rec : batch) {
+                ids.emplace_back(rec.id);
+            }
+        }
+        return ids;
+    }
+
+    static auto allIds() -> std::vector<std::string> {
+        std::vector<std::string> ids;
+        for (int i = 0; i < kRecords; ++i) {
+            ids.push_back(std::string("r").append(std::to_string(i)));
+        }
+        return ids;
+    }
+
+    auto readShards(const std::string& path, size_t shardCount, FastqReaderInputMode mode)
+        -> std::vector<std::string> {
+        std::vector<std::string> ids;
+        for (size_t shard = 0; shard < shardCount; ++shard) {
+            FastqReaderOptions options;
+            options.inputMode = mode;
+            options.readChunkBytes = 4096;
+            options.shardIndex = shard;
+            options.shardCount = shardCount;
+            FastqReader reader(path, options);
+            const auto shardIds = readIds(reader);
+            ids.insert(ids.end(), shardIds.begin(), shardIds.end());
+        }
+        return ids;
+    }
+
+    static auto readFile(const std::string& path) -> std::string {
+        std::ifstream in(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+
+    std::string plainPath_;
+    std::string bgzfPath_;
+    std::vector<std::string> extraPaths_;
+};
+
+TEST_F(FastqShardTest, PlainShardsPartitionRecords) {
+    for (const auto mode : {FastqReaderInputMode::Mmap, FastqReaderInputMode::Stream}) {
+        for (const size_t shardCount : {1U, 2U, 3U, 7U, 64U}) {
+            EXPECT_EQ(readShards(plainPath_, shardCount, mode), allIds())
+                << "shards=" << shardCount;
+        }
+    }
+}
+
+TEST_F(FastqShardTest, MoreShardsThanRecordsYieldsEmptyShards) {
+    const std::string tinyPath = "test_shard_tiny.fastq";
+    extraPaths_.push_back(tinyPath);
+    std::ofstream(tinyPath) << "@a\nAC\n+\n@@\n@b\nGT\n+\n++\n";
+    std::vector<std::string> ids;
+    for (size_t shard = 0; shard < 16; ++shard) {
+        FastqReaderOptions options;
+        options.shardIndex = shard;
+        options.shardCount = 16;
+        FastqReader reader(tinyPath, options);
+        const auto shardIds = readIds(reader);
+        ids.insert(ids.end(), shardIds.begin(), shardIds.end());
+    }
+    EXPECT_EQ(ids, (std::vector<std::string>{"a", "b"}));
+}
+
+TEST_F(FastqShardTest, BgzfShardsRequireIndex) {
+    FastqReaderOptions options;
+    options.shardIndex = 1;
+    options.shardCount = 4;
+    EXPECT_THROW(FastqReader(bgzfPath_, options), std::runtime_error);
+
+    FastqIndex::build(bgzfPath_, 100).save(FastqIndex::defaultPath(bgzfPath_));
+    EXPECT_EQ(readShards(bgzfPath_, 4, FastqReaderInputMode::Auto), allIds());
+}
+
+TEST_F(FastqShardTest, InvalidShardsThrow) {
+    const std::string gzipPath = "test_shard_plain.fastq.gz";
+    extraPaths_.push_back(gzipPath);
+    gzFile out = gzopen(gzipPath.c_str(), "wb");
+    const std::string content = readFile(plainPath_);
+    gzwrite(out, content.data(), static_cast<unsigned>(content.size()));
+    gzclose(out);
+
+    FastqReaderOptions options;
+    options.shardIndex = 0;
+    options.shardCount = 2;
+    EXPECT_THROW(FastqReader(gzipPath, options), std::runtime_error);
+
+    options.shardIndex = 2;
+    EXPECT_THROW(FastqReader(plainPath_, options), std::runtime_error);
+}
+
+TEST_F(FastqShardTest, MergeConcatenatesShardOutputs) {
+    std::vector<std::string> plainParts;
+    std::vector<std::string> bgzfParts;
+    for (size_t shard = 0; shard < 3; ++shard) {
+        FastqReaderOptions options;
+        options.shardIndex = shard;
+        options.shardCount = 3;
+        FastqReader reader(plainPath_, options);
+        plainParts.push_back("test_shard_part" + std::to_string(shard) + ".fastq");
+        bgzfParts.push_back(plainParts.back() + ".gz");
+        FastqWriter plainWriter(plainParts.back());
+        FastqWriter bgzfWriter(bgzfParts.back());
+        FastqBatch batch;
+        while (reader.nextBatch(batch)) {
+            plainWriter.write(batch);
+            bgzfWriter.write(batch);
+        }
+    }
+    extraPaths_.insert(extraPaths_.end(), plainParts.begin(), plainParts.end());
+    extraPaths_.insert(extraPaths_.end(), bgzfParts.begin(), bgzfParts.end());
+
+    const std::string mergedPlain = "test_shard_merged.fastq";
+    const std::string mergedBgzf = "test_shard_merged.fastq.gz";
+    const std::string mixed = "test_shard_mixed.fastq";
+    extraPaths_.insert(extraPaths_.end(), {mergedPlain, mergedBgzf, mixed});
+
+    EXPECT_TRUE(mergeFastqFiles(plainParts, mergedPlain));
+    EXPECT_EQ(readFile(mergedPlain), readFile(plainPath_));
+
+    EXPECT_TRUE(mergeFastqFiles(bgzfParts, mergedBgzf));
+    FastqReader bgzfReader(mergedBgzf);
+    EXPECT_TRUE(bgzfReader.isBgzf());
+    EXPECT_EQ(readIds(bgzfReader), allIds());
+
+    EXPECT_FALSE(mergeFastqFiles({bgzfParts[0], plainParts[1], bgzfParts[2]}, mixed));
+    EXPECT_EQ(readFile(mixed), readFile(plainPath_));
+
+    // 重新读取时 BGZF 输入按 readerOptions 解压，与写出的压缩线程数无关
+    FastqReaderOptions readerOptions;
+    readerOptions.decompressionThreads = 4;
+    EXPECT_FALSE(
+        mergeFastqFiles({bgzfParts[0], plainParts[1], bgzfParts[2]}, mixed, {}, readerOptions));
+    EXPECT_EQ(readFile(mixed), readFile(plainPath_));
+}
+
+}  // namespace fq::io
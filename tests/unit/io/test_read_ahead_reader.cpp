@@ -0,0 +1,85 @@
+#include "io/read_ahead_reader.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+namespace fq::io {
+
+namespace {
+
+auto sourceText(size_t size) -> std::string {
+    std::string text(size, '\0');
+    for (size_t i = 0; i < size; ++i) {
+        text[i] = static_cast<char>('a' + (i * 7) % 26);
+    }
+    return text;
+}
+
+}  // namespace
+
+TEST(ReadAheadReaderTest, SpansStayInPlaceAfterHeadroom) {
+    const std::string text = sourceText(100000);
+    size_t offset = 0;
+    auto source = [&](char* dst, size_t size) -> ssize_t {
+        // 每次只给出一部分，验证区间按实际读取的字节数划分
+        const size_t n = std::min({size, size_t{777}, text.size() - offset});
+        std::memcpy(dst, text.data() + offset, n);
+        offset += n;
+        return static_cast<ssize_t>(n);
+    };
+
+    constexpr size_t kHeadroom = 300;
+    ReadAheadReader reader(source, 1000, 3, 8000, kHeadroom);
+    std::string result;
+    ReadAheadReader::Span previous;
+    size_t blocks = 0;
+    while (true) {
+        ReadAheadReader::Span span;
+        const ssize_t n = reader.read(500, span);
+        ASSERT_GE(n, 0);
+        if (n == 0) {
+            break;
+        }
+        ASSERT_LE(static_cast<size_t>(n), 500U);
+        if (span.block == previous.block) {
+            // 同一块中相继取出的区间彼此相邻，读取方可以原地延伸
+            EXPECT_EQ(span.begin, previous.end);
+        } else {
+            // 新块开头留出 headroom，供读取方拼接上一块的尾部
+            EXPECT_EQ(span.begin, kHeadroom);
+            ++blocks;
+            if (previous.block) {
+                reader.recycle(std::move(previous.block));
+            }
+        }
+        result.append(span.block->data.get() + span.begin, span.end - span.begin);
+        previous = std::move(span);
+    }
+    EXPECT_EQ(result, text);
+    EXPECT_GT(blocks, 1U);
+}
+
+TEST(ReadAheadReaderTest, SourceErrorIsReportedAfterData) {
+    bool first = true;
+    auto source = [&](char* dst, size_t size) -> ssize_t {
+        if (!first) {
+            errno = EIO;
+            return -1;
+        }
+        first = false;
+        std::memset(dst, 'x', std::min<size_t>(size, 10));
+        return 10;
+    };
+
+    ReadAheadReader reader(source, 100, 2, 1000, 0);
+    ReadAheadReader::Span span;
+    EXPECT_EQ(reader.read(100, span), 10);
+    EXPECT_EQ(reader.read(100, span), -1);
+    EXPECT_EQ(errno, EIO);
+}
+
+}  // namespace fq::io
@@ -0,0 +1,151 @@
+#include "io/speculative_inflate_reader.h"
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <string>
+#include <vector>
+
+namespace fq::io {
+
+namespace {
+
+auto fastqText(int first, int count) -> std::string {
+    std::string text;
+    for (int i = first; i < first + count; ++i) {
+        std::string seq(static_cast<size_t>(60 + (i * 7) % 90), 'A');
+        for (size_t j = 0; j < seq.size(); ++j) {
+            seq[j] = "ACGTN"[(static_cast<size_t>(i) * 31 + j * j) % 5];
+        }
+        std::string qual(seq.size(), 'I');
+        for (size_t j = 0; j < qual.size(); ++j) {
+            qual[j] = static_cast<char>('!' + (static_cast<size_t>(i) + j * 13) % 41);
+        }
+        text += "@r" + std::to_string(i) + "\n" + seq + "\n+\n" + qual + "\n";
+    }
+    return text;
+}
+
+// 原始 deflate（无 gzip 头）：非最终的动态块，其后是 Z_SYNC_FLUSH 的空存储块
+auto rawDeflateBlock(const std::string& text) -> std::string {
+    z_stream strm{};
+    EXPECT_EQ(deflateInit2(&strm, 6, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY), Z_OK);
+    std::string out(deflateBound(&strm, text.size()) + 16, '\0');
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(text.data()));
+    strm.avail_in = static_cast<uInt>(text.size());
+    strm.next_out = reinterpret_cast<Bytef*>(out.data());
+    strm.avail_out = static_cast<uInt>(out.size());
+    EXPECT_EQ(deflate(&strm, Z_SYNC_FLUSH), Z_OK);
+    out.resize(strm.total_out);
+    deflateEnd(&strm);
+    return out;
+}
+
+/**
+ * @brief 把若干段数据写成一个 gzip 成员，每段使用各自的压缩级别（0 为存储块）
+ */
+auto gzipSegments(const std::vector<std::pair<std::string, int>>& segments) -> std::string {
+    z_stream strm{};
+    EXPECT_EQ(deflateInit2(&strm, segments.front().second, Z_DEFLATED, 15 + 16, 8,
+                           Z_DEFAULT_STRATEGY),
+              Z_OK);
+    std::string out;
+    std::vector<char> buffer(256 * 1024);
+    auto drain = [&](int flush) {
+        do {
+            strm.next_out = reinterpret_cast<Bytef*>(buffer.data());
+            strm.avail_out = static_cast<uInt>(buffer.size());
+            const int rc = deflate(&strm, flush);
+            EXPECT_NE(rc, Z_STREAM_ERROR);
+            out.append(buffer.data(), buffer.size() - strm.avail_out);
+        } while (strm.avail_out == 0);
+    };
+    for (size_t i = 0; i < segments.size(); ++i) {
+        if (i > 0) {
+            drain(Z_BLOCK);
+            EXPECT_EQ(deflateParams(&strm, segments[i].second, Z_DEFAULT_STRATEGY), Z_OK);
+        }
+        strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(segments[i].first.data()));
+        strm.avail_in = static_cast<uInt>(segments[i].first.size());
+        drain(Z_NO_FLUSH);
+    }
+    drain(Z_FINISH);
+    deflateEnd(&strm);
+    return out;
+}
+
+struct InflateResult {
+    std::string text;
+    uint64_t accepted = 0;
+    uint64_t discarded = 0;
+};
+
+auto inflateAll(const std::string& gz, size_t threads, size_t chunkBytes) -> InflateResult {
+    SpeculativeInflateReader reader(reinterpret_cast<const unsigned char*>(gz.data()), gz.size(),
+                                    threads, chunkBytes);
+    InflateResult result;
+    std::vector<char> buffer(64 * 1024);
+    while (true) {
+        const ssize_t n = reader.read(buffer.data(), buffer.size());
+        if (n <= 0) {
+            break;
+        }
+        result.text.append(buffer.data(), static_cast<size_t>(n));
+    }
+    result.accepted = reader.acceptedSegments();
+    result.discarded = reader.discardedSegments();
+    return result;
+}
+
+}  // namespace
+
+TEST(SpeculativeInflateTest, ParallelSegmentsAreAccepted) {
+    const std::string text = fastqText(0, 40000);
+    const std::string gz = gzipSegments({{text, 6}});
+
+    const auto serial = inflateAll(gz, 1, 16 * 1024);
+    EXPECT_EQ(serial.text, text);
+    EXPECT_EQ(serial.accepted, 0U);
+
+    // 4 个线程时各轮的推测段必须真正被接受，否则只是在验证第一段的精确解码
+    const auto parallel = inflateAll(gz, 4, 16 * 1024);
+    EXPECT_EQ(parallel.text, text);
+    EXPECT_GT(parallel.accepted, 1U);
+}
+
+TEST(SpeculativeInflateTest, FalseBlockHeadersAreDiscarded) {
+    // 存储块中首尾相接地嵌入完整的动态块：从其中开始的推测段能一直解码到终点，
+    // 但起点与前一段的终点不衔接，必须被丢弃
+    const std::string decoy = rawDeflateBlock(fastqText(900000, 40));
+    ASSERT_FALSE(decoy.empty());
+    ASSERT_EQ(static_cast<unsigned char>(decoy[0]) & 0x7, 0x4) << "decoy must start with a dynamic block";
+
+    std::vector<std::pair<std::string, int>> segments;
+    std::string expected;
+    for (int round = 0; round < 12; ++round) {
+        const std::string text = fastqText(round * 200, 200);
+        std::string stored;
+        while (stored.size() < 24 * 1024) {
+            stored += decoy;
+        }
+        segments.emplace_back(text, 6);
+        segments.emplace_back(stored, 0);
+        expected += text;
+        expected += stored;
+    }
+    const std::string gz = gzipSegments(segments);
+
+    const auto result = inflateAll(gz, 4, 4096);
+    EXPECT_EQ(result.text.size(), expected.size());
+    EXPECT_TRUE(result.text == expected);
+    EXPECT_GT(result.discarded, 0U);
+}
+
+TEST(SpeculativeInflateTest, CorruptCrcThrows) {
+    const std::string text = fastqText(0, 5000);
+    std::string gz = gzipSegments({{text, 6}});
+    gz[gz.size() - 8] = static_cast<char>(gz[gz.size() - 8] ^ 0x1);
+    EXPECT_THROW(inflateAll(gz, 4, 16 * 1024), std::runtime_error);
+}
+
+}  // namespace fq::io
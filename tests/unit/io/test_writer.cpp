@@ -1,8 +1,10 @@
 #include "fqtools/io/fastq_writer.h"
 #include "fqtools/io/fastq_io.h"
+#include "fqtools/io/fastq_reader.h"
 #include <gtest/gtest.h>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <zlib.h>
 
 namespace fq::io {
@@ -60,4 +62,186 @@ TEST_F(FastqWriterTest, WriteBasic) {
     gzclose(file);
 }
 
+TEST_F(FastqWriterTest, ParallelBgzfRoundTrip) {
+    FastqWriterOptions options;
+    options.compression = FastqWriterCompressionMode::Gzip;
+    options.compressionThreads = 4;
+
+    std::string expected;
+    {
+        FastqWriter writer(tmpFile_, options);
+        ASSERT_TRUE(writer.isOpen());
+        for (int i = 0; i < 20000; ++i) {
+            FastqRecord rec;
+            const std::string id = std::string("read").append(std::to_string(i));
+            const std::string seq(100 + (i % 50), "ACGT"[i % 4]);
+            const std::string qual(seq.size(), static_cast<char>('!' + (i % 40)));
+            rec.id = id;
+            rec.seq = seq;
+            rec.qual = qual;
+            writer.write(rec);
+            expected.append("@").append(id).append("\n").append(seq).append("\n+\n");
+            expected.append(qual).append("\n");
+        }
+    }
+
+    std::ifstream raw(tmpFile_, std::ios::binary);
+    const std::string compressed((std::istreambuf_iterator<char>(raw)),
+                                 std::istreambuf_iterator<char>());
+    ASSERT_GT(compressed.size(), 28U);
+    // BGZF 头：FEXTRA 标志和 BC 子字段
+    EXPECT_EQ(static_cast<unsigned char>(compressed[3]), 0x04);
+    EXPECT_EQ(compressed[12], 'B');
+    EXPECT_EQ(compressed[13], 'C');
+    // 末尾为 28 字节的 BGZF EOF 块
+    EXPECT_EQ(compressed.substr(compressed.size() - 28, 4), std::string("\x1f\x8b\x08\x04", 4));
+    EXPECT_EQ(static_cast<unsigned char>(compressed[compressed.size() - 12]), 0x1b);
+
+    gzFile file = gzopen(tmpFile_.c_str(), "rb");
+    ASSERT_NE(file, nullptr);
+    std::string content;
+    char buffer[65536];
+    int len = 0;
+    while ((len = gzread(file, buffer, sizeof(buffer))) > 0) {
+        content.append(buffer, static_cast<size_t>(len));
+    }
+    gzclose(file);
+    EXPECT_EQ(content, expected);
+}
+
+TEST_F(FastqWriterTest, IoUringMatchesSyncWrite) {
+    auto writeFile = [](const std::string& path, FastqWriterCompressionMode compression, bool ioUring) {
+        FastqWriterOptions options;
+        options.compression = compression;
+        options.outputBufferBytes = 4096;
+        options.ioUring = ioUring;
+        FastqWriter writer(path, options);
+        for (int i = 0; i < 5000; ++i) {
+            FastqRecord rec;
+            const std::string id = std::string("w").append(std::to_string(i));
+            const std::string seq(static_cast<size_t>(30 + (i % 170)), "ACGT"[i % 4]);
+            const std::string qual(seq.size(), static_cast<char>('!' + (i % 40)));
+            rec.id = id;
+            rec.seq = seq;
+            rec.qual = qual;
+            writer.write(rec);
+        }
+    };
+    auto readFile = [](const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+
+    const std::string syncFile = "test_writer_sync_output.fastq";
+    for (const auto compression : {FastqWriterCompressionMode::None, FastqWriterCompressionMode::Gzip}) {
+        writeFile(syncFile, compression, false);
+        writeFile(tmpFile_, compression, true);
+        const std::string expected = readFile(syncFile);
+        ASSERT_FALSE(expected.empty());
+        EXPECT_EQ(readFile(tmpFile_), expected);
+    }
+    std::filesystem::remove(syncFile);
+}
+
+TEST_F(FastqWriterTest, BatchWriteMatchesPerRecordWrite) {
+    // 混合 '+' 行带 ID、注释、制表符分隔与 CRLF 的记录
+    std::string input;
+    for (int i = 0; i < 3000; ++i) {
+        const std::string id = "b" + std::to_string(i);
+        const std::string seq(static_cast<size_t>(20 + (i % 130)), "ACGT"[i % 4]);
+        const std::string qual(seq.size(), static_cast<char>('#' + (i % 30)));
+        const char* eol = i % 97 == 0 ? "\r\n" : "\n";
+        input += "@" + id;
+        if (i % 5 == 0) {
+            input += " len=" + std::to_string(seq.size());
+        } else if (i % 11 == 0) {
+            input += "\tlen=" + std::to_string(seq.size());
+        }
+        input += eol + seq + eol + "+" + (i % 3 == 0 ? id : "") + eol + qual + eol;
+    }
+    const std::string inputFile = "test_writer_batch_input.fastq";
+    {
+        std::ofstream out(inputFile, std::ios::binary);
+        out << input;
+    }
+    auto readFile = [](const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+
+    const std::string perRecordFile = "test_writer_per_record_output.fastq";
+    for (const auto compression : {FastqWriterCompressionMode::None, FastqWriterCompressionMode::Gzip}) {
+        FastqWriterOptions options;
+        options.compression = compression;
+        options.outputBufferBytes = 4096;
+        {
+            FastqReaderOptions readerOptions;
+            readerOptions.targetBatchBytes = 64 * 1024;
+            FastqReader reader(inputFile, readerOptions);
+            FastqWriter batchWriter(tmpFile_, options);
+            FastqWriter recordWriter(perRecordFile, options);
+            FastqBatch batch;
+            size_t index = 0;
+            while (reader.nextBatch(batch)) {
+                // 裁剪部分记录、丢弃部分记录，其余保持原样
+                std::vector<FastqRecord> kept;
+                for (auto rec : batch.records()) {
+                    const size_t i = index++;
+                    if (i % 7 == 0) {
+                        continue;
+                    }
+                    if (i % 4 == 0) {
+                        rec.seq = rec.seq.substr(2);
+                        rec.qual = rec.qual.substr(2);
+                    }
+                    kept.push_back(rec);
+                }
+                batch.records() = std::move(kept);
+                batchWriter.write(batch);
+                for (const auto& rec : batch) {
+                    recordWriter.write(rec);
+                }
+            }
+            EXPECT_EQ(batchWriter.totalUncompressedBytes(), recordWriter.totalUncompressedBytes());
+        }
+        const std::string expected = readFile(perRecordFile);
+        ASSERT_FALSE(expected.empty());
+        EXPECT_EQ(readFile(tmpFile_), expected);
+    }
+
+    // LF、空格分隔的输入原样写出时与输入逐字节相同，'+' 行内容不丢失
+    std::string lfInput;
+    for (const char c : input) {
+        if (c != '\r') {
+            lfInput += c == '\t' ? ' ' : c;
+        }
+    }
+    {
+        std::ofstream out(inputFile, std::ios::binary | std::ios::trunc);
+        out << lfInput;
+    }
+    {
+        FastqWriterOptions options;
+        options.compression = FastqWriterCompressionMode::None;
+        options.outputBufferBytes = 4096;
+        FastqReader reader(inputFile);
+        FastqWriter writer(tmpFile_, options);
+        FastqBatch batch;
+        while (reader.nextBatch(batch)) {
+            writer.write(batch);
+        }
+    }
+    EXPECT_EQ(readFile(tmpFile_), lfInput);
+
+    std::filesystem::remove(inputFile);
+    std::filesystem::remove(perRecordFile);
+}
+
+TEST_F(FastqWriterTest, InvalidCompressionLevelThrows) {
+    FastqWriterOptions options;
+    options.compression = FastqWriterCompressionMode::Gzip;
+    options.compressionLevel = 99;
+    EXPECT_THROW(FastqWriter(tmpFile_, options), std::runtime_error);
+}
+
 } // namespace fq::io
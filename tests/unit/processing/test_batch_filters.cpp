@@ -0,0 +1,140 @@
+#include "fqtools/processing/mutators/quality_trimmer.h"
+#include "fqtools/processing/predicates/min_quality_predicate.h"
+#include "fqtools/processing/read_metrics.h"
+#include "test_reads.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace fq::processing {
+
+TEST(BatchFilterTest, PredicateBatchMatchesPerRead) {
+    const MinLengthPredicate minLength(5);
+    const MaxLengthPredicate maxLength(12);
+    const MaxNRatioPredicate maxN(0.2);
+    const MinQualityPredicate minQuality(20.0);
+    const std::vector<const ReadPredicateInterface*> predicates = {
+        &minLength, &maxLength, &maxN, &minQuality};
+
+    const auto reads = fq::test::makeTestReads();
+    auto records = reads.build();
+    ReadPassMask passMask(records.size(), 1);
+    for (const auto* predicate : predicates) {
+        predicate->evaluateBatch(records, passMask);
+    }
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        bool expected = true;
+        for (const auto* predicate : predicates) {
+            expected = expected && predicate->evaluate(records[i]);
+        }
+        EXPECT_EQ(passMask[i] != 0, expected) << "read " << i;
+    }
+    EXPECT_EQ(passMask, (ReadPassMask{1, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 0}));
+}
+
+TEST(BatchFilterTest, MutatorBatchSkipsMaskedReads) {
+    QualityTrimmer trimmer(20.0, 1);
+    const auto reads = fq::test::makeTestReads();
+    auto records = reads.build();
+    const ReadPassMask passMask = {1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0};
+    trimmer.processBatch(records, passMask);
+
+    EXPECT_EQ(records[4].seq, "GTACGTACGTAC");
+    EXPECT_EQ(records[4].qual, "IIIIIIIIIIII");
+    // 被过滤的 read 保持原样
+    EXPECT_EQ(records[5].seq, "ACGTACGTAC");
+}
+
+TEST(BatchFilterTest, AverageQualityThresholdMatchesDivision) {
+    // 与原先的 double 除法判定逐一比较，长度覆盖预计算表之外的部分
+    for (const double minQuality : {0.0, 20.0, 20.1, 27.35, 30.5, 41.0, -1.0}) {
+        const AverageQualityThreshold threshold(minQuality, 33);
+        for (const size_t length : {1, 2, 3, 7, 10, 100, 151, 1023, 1024, 5000}) {
+            for (std::uint64_t sumQual = 0; sumQual <= 42 * length; sumQual += (length / 7) + 1) {
+                const auto qualitySum = static_cast<std::int64_t>(sumQual + 33 * length);
+                const double avgQual =
+                    static_cast<double>(sumQual) / static_cast<double>(length);
+                EXPECT_EQ(threshold.passes(qualitySum, length), avgQual >= minQuality)
+                    << "minQuality=" << minQuality << " length=" << length << " sum=" << sumQual;
+            }
+        }
+        EXPECT_FALSE(threshold.passes(0, 0));
+    }
+
+    const AverageQualityThreshold nanThreshold(std::numeric_limits<double>::quiet_NaN(), 33);
+    EXPECT_FALSE(nanThreshold.passes(40 * 10, 10));
+    const AverageQualityThreshold hugeThreshold(1e30, 33);
+    EXPECT_FALSE(hugeThreshold.passes(126 * 10, 10));
+}
+
+TEST(BatchFilterTest, MeasureReadComputesRequestedMetrics) {
+    fq::io::FastqRecord rec;
+    rec.seq = "NGCnacgTAC";
+    rec.qual = "##IIII##I#";
+    const auto& kernels = fq::common::byteKernels();
+
+    const auto all = measureRead(
+        kernels,
+        rec,
+        {kMetricQualitySum | kMetricNCount | kMetricGcCount | kMetricHighQualityBounds, 'I'});
+    EXPECT_EQ(all.length, 10U);
+    EXPECT_EQ(all.qualitySum, 5 * 'I' + 5 * '#');
+    EXPECT_EQ(all.nCount, 2U);
+    EXPECT_EQ(all.gcCount, 5U);
+    EXPECT_EQ(all.firstHighQuality, 2U);
+    EXPECT_EQ(all.lastHighQuality, 9U);
+
+    // 未请求的度量保持为 0
+    const auto none = measureRead(kernels, rec, {});
+    EXPECT_EQ(none.qualitySum, 0);
+    EXPECT_EQ(none.nCount, 0U);
+    EXPECT_EQ(none.length, 10U);
+}
+
+TEST(BatchFilterTest, SharedMetricsMatchPlainBatch) {
+    const MaxNRatioPredicate maxN(0.2);
+    const MinQualityPredicate minQuality(20.0);
+    const std::vector<const ReadPredicateInterface*> predicates = {&maxN, &minQuality};
+
+    for (const auto mode : {QualityTrimmer::TrimMode::Both,
+                            QualityTrimmer::TrimMode::FivePrime,
+                            QualityTrimmer::TrimMode::ThreePrime}) {
+        QualityTrimmer plainTrimmer(20.0, 3, mode);
+        QualityTrimmer metricsTrimmer(20.0, 3, mode);
+
+        const auto reads = fq::test::makeTestReads();
+        auto plain = reads.build();
+        ReadPassMask plainMask(plain.size(), 1);
+        for (const auto* predicate : predicates) {
+            predicate->evaluateBatch(plain, plainMask);
+        }
+        plainTrimmer.processBatch(plain, plainMask);
+
+        auto shared = reads.build();
+        ReadPassMask sharedMask(shared.size(), 1);
+        ReadMetricsRequest request;
+        for (const auto* predicate : predicates) {
+            request.merge(predicate->metricsRequest());
+        }
+        request.merge(metricsTrimmer.metricsRequest());
+        ReadMetricsBatch metrics;
+        metrics.compute(shared, sharedMask, request);
+        for (const auto* predicate : predicates) {
+            predicate->evaluateBatchWithMetrics(shared, metrics, sharedMask);
+        }
+        metricsTrimmer.processBatchWithMetrics(shared, metrics, sharedMask);
+
+        EXPECT_EQ(sharedMask, plainMask);
+        for (size_t i = 0; i < plain.size(); ++i) {
+            EXPECT_EQ(shared[i].seq, plain[i].seq) << "read " << i;
+            EXPECT_EQ(shared[i].qual, plain[i].qual) << "read " << i;
+        }
+    }
+}
+
+}  // namespace fq::processing
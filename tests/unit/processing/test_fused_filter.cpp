@@ -0,0 +1,141 @@
+#include "processing/fused_filter.h"
+#include "test_reads.h"
+
+#include "fqtools/processing/mutators/quality_trimmer.h"
+#include "fqtools/processing/predicates/min_quality_predicate.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace fq::processing {
+
+namespace {
+
+struct Stages {
+    std::vector<std::unique_ptr<ReadPredicateInterface>> predicates;
+    std::vector<std::unique_ptr<ReadMutatorInterface>> mutators;
+};
+
+auto countActive(const ReadPassMask& passMask) -> uint64_t {
+    uint64_t count = 0;
+    for (const auto v : passMask) {
+        count += v != 0 ? 1 : 0;
+    }
+    return count;
+}
+
+// 添加顺序与融合路径内部的求值顺序不同，用来检验各阶段计数按添加顺序折算
+auto makeStages(unsigned mask, QualityTrimmer::TrimMode mode) -> Stages {
+    Stages stages;
+    if ((mask & kFuseMaxNRatio) != 0) {
+        stages.predicates.push_back(std::make_unique<MaxNRatioPredicate>(0.2));
+    }
+    if ((mask & kFuseMinQuality) != 0) {
+        stages.predicates.push_back(std::make_unique<MinQualityPredicate>(20.0));
+    }
+    if ((mask & kFuseMaxLength) != 0) {
+        stages.predicates.push_back(std::make_unique<MaxLengthPredicate>(12));
+    }
+    if ((mask & kFuseMinLength) != 0) {
+        stages.predicates.push_back(std::make_unique<MinLengthPredicate>(5));
+    }
+    if ((mask & kFuseQualityTrim) != 0) {
+        stages.mutators.push_back(std::make_unique<QualityTrimmer>(20.0, 3, mode));
+    }
+    return stages;
+}
+
+}  // namespace
+
+TEST(FusedFilterTest, MatchesGenericPathForEveryCombination) {
+    const auto reads = fq::test::makeTestReads();
+    const QualityTrimmer::TrimMode modes[] = {QualityTrimmer::TrimMode::Both,
+                                              QualityTrimmer::TrimMode::FivePrime,
+                                              QualityTrimmer::TrimMode::ThreePrime};
+
+    for (unsigned mask = 1; mask <= kFuseAllStages; ++mask) {
+        for (const auto mode : modes) {
+            auto stages = makeStages(mask, mode);
+            const auto fused = FusedReadFilter::create(stages.predicates, stages.mutators);
+            ASSERT_TRUE(fused.has_value()) << "mask " << mask;
+            EXPECT_EQ(fused->params().stages, mask);
+
+            auto expected = reads.build();
+            ReadPassMask expectedMask(expected.size(), 1);
+            std::vector<StageStatistics> expectedStages;
+            for (const auto& predicate : stages.predicates) {
+                StageStatistics stage;
+                stage.evaluated = countActive(expectedMask);
+                predicate->evaluateBatch(expected, expectedMask);
+                stage.passed = countActive(expectedMask);
+                expectedStages.push_back(stage);
+            }
+            for (const auto& mutator : stages.mutators) {
+                const auto before = expected;
+                mutator->processBatch(expected, expectedMask);
+                StageStatistics stage;
+                for (size_t i = 0; i < expected.size(); ++i) {
+                    if (expectedMask[i] == 0) {
+                        continue;
+                    }
+                    stage.evaluated++;
+                    if (expected[i].seq.size() != before[i].seq.size()) {
+                        stage.modified++;
+                        stage.basesRemoved += before[i].seq.size() - expected[i].seq.size();
+                    }
+                    stage.passed += expected[i].empty() ? 0 : 1;
+                }
+                expectedStages.push_back(stage);
+            }
+
+            auto actual = reads.build();
+            ReadPassMask actualMask(actual.size(), 1);
+            ProcessingStatistics stats;
+            fused->applyBatch(actual, actualMask, stats);
+
+            ASSERT_EQ(stats.stages.size(), expectedStages.size());
+            for (size_t k = 0; k < expectedStages.size(); ++k) {
+                EXPECT_EQ(stats.stages[k].evaluated, expectedStages[k].evaluated)
+                    << "mask " << mask << " stage " << k;
+                EXPECT_EQ(stats.stages[k].passed, expectedStages[k].passed)
+                    << "mask " << mask << " stage " << k;
+                EXPECT_EQ(stats.stages[k].modified, expectedStages[k].modified)
+                    << "mask " << mask << " stage " << k;
+                EXPECT_EQ(stats.stages[k].basesRemoved, expectedStages[k].basesRemoved)
+                    << "mask " << mask << " stage " << k;
+            }
+
+            for (size_t i = 0; i < expected.size(); ++i) {
+                const bool expectedPass = expectedMask[i] != 0 && !expected[i].empty();
+                ASSERT_EQ(actualMask[i] != 0, expectedPass) << "mask " << mask << " read " << i;
+                if (expectedPass) {
+                    EXPECT_EQ(actual[i].seq, expected[i].seq) << "mask " << mask << " read " << i;
+                    EXPECT_EQ(actual[i].qual, expected[i].qual)
+                        << "mask " << mask << " read " << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(FusedFilterTest, UnsupportedCombinationsUseGenericPath) {
+    std::vector<std::unique_ptr<ReadPredicateInterface>> predicates;
+    std::vector<std::unique_ptr<ReadMutatorInterface>> mutators;
+    EXPECT_FALSE(FusedReadFilter::create(predicates, mutators).has_value());
+
+    // 同类谓词重复
+    predicates.push_back(std::make_unique<MinLengthPredicate>(5));
+    predicates.push_back(std::make_unique<MinLengthPredicate>(10));
+    EXPECT_FALSE(FusedReadFilter::create(predicates, mutators).has_value());
+
+    // 非质量修剪器
+    predicates.pop_back();
+    mutators.push_back(std::make_unique<LengthTrimmer>(50));
+    EXPECT_FALSE(FusedReadFilter::create(predicates, mutators).has_value());
+}
+
+}  // namespace fq::processing
@@ -1,9 +1,68 @@
 #include "fqtools/processing/processing_pipeline.h"
 #include "fqtools/processing/mutators.h"
 #include "fqtools/processing/predicates.h"
+#include "processing/processing_pipeline.h"
 #include <gtest/gtest.h>
 
 TEST(PipelineSmokeTest, CanCreatePipelineFromFactory) {
     auto pipeline = fq::processing::createProcessingPipeline();
     ASSERT_TRUE(static_cast<bool>(pipeline));
 }
+
+TEST(PipelineSmokeTest, StatisticsMergeAddsStageCounts) {
+    fq::processing::ProcessingStatistics total;
+    fq::processing::ProcessingStatistics batch;
+    batch.totalReads = 10;
+    batch.passedReads = 7;
+    batch.filteredReads = 3;
+    batch.modifiedReads = 2;
+    batch.stages.resize(2);
+    batch.stages[0].evaluated = 10;
+    batch.stages[0].passed = 8;
+    batch.stages[1].evaluated = 8;
+    batch.stages[1].passed = 7;
+    batch.stages[1].modified = 2;
+    batch.stages[1].basesRemoved = 15;
+
+    total.merge(batch);
+    total.merge(batch);
+    EXPECT_EQ(total.totalReads, 20U);
+    EXPECT_EQ(total.passedReads, 14U);
+    EXPECT_EQ(total.filteredReads, 6U);
+    EXPECT_EQ(total.modifiedReads, 4U);
+    ASSERT_EQ(total.stages.size(), 2U);
+    EXPECT_EQ(total.stages[0].evaluated, 20U);
+    EXPECT_EQ(total.stages[0].passed, 16U);
+    EXPECT_EQ(total.stages[1].modified, 4U);
+    EXPECT_EQ(total.stages[1].basesRemoved, 30U);
+}
+
+TEST(PipelineSmokeTest, ReaderOptionsForwardInputSettings) {
+    fq::processing::ProcessingConfig config;
+    config.threadCount = 4;
+    config.readChunkBytes = 64 * 1024;
+    config.readAheadBuffers = 3;
+    config.batchBytes = 32 * 1024;
+    config.ioUring = true;
+
+    const auto options = fq::processing::readerOptionsFor(config);
+    EXPECT_EQ(options.readChunkBytes, 64U * 1024);
+    EXPECT_EQ(options.decompressionThreads, 4U);
+    EXPECT_EQ(options.readAheadBuffers, 3U);
+    EXPECT_EQ(options.targetBatchBytes, 32U * 1024);
+    EXPECT_TRUE(options.ioUring);
+}
+
+TEST(PipelineSmokeTest, WriterOptionsForwardOutputSettings) {
+    fq::processing::ProcessingConfig config;
+    config.threadCount = 4;
+    config.writerBufferBytes = 256 * 1024;
+    config.compressionLevel = 3;
+    config.ioUring = true;
+
+    const auto options = fq::processing::writerOptionsFor(config);
+    EXPECT_EQ(options.outputBufferBytes, 256U * 1024);
+    EXPECT_EQ(options.compressionLevel, 3);
+    EXPECT_EQ(options.compressionThreads, 4U);
+    EXPECT_TRUE(options.ioUring);
+}
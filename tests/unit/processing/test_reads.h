@@ -0,0 +1,54 @@
+#pragma once
+
+#include "fqtools/io/fastq_io.h"
+
+#include <string>
+#include <vector>
+
+namespace fq::test {
+
+/**
+ * @brief 过滤/修剪测试共用的一组 read
+ * @details 覆盖正常、过短、含 N（大小写）、两端低质量、全低质量、序列与质量长度不一致、空 read 等情况；
+ *          记录以视图引用这里的字符串，使用期间本对象必须存活；build() 每次生成一份新的记录，
+ *          供对照的两条路径各自修改。
+ */
+struct TestReads {
+    std::vector<std::string> seqs;
+    std::vector<std::string> quals;
+
+    void add(std::string seq, std::string qual) {
+        seqs.push_back(std::move(seq));
+        quals.push_back(std::move(qual));
+    }
+
+    [[nodiscard]] auto build() const -> std::vector<fq::io::FastqRecord> {
+        std::vector<fq::io::FastqRecord> records;
+        for (size_t i = 0; i < seqs.size(); ++i) {
+            fq::io::FastqRecord rec;
+            rec.seq = seqs[i];
+            rec.qual = quals[i];
+            records.push_back(rec);
+        }
+        return records;
+    }
+};
+
+inline auto makeTestReads() -> TestReads {
+    TestReads reads;
+    reads.add("ACGTACGTAC", "IIIIIIIIII");
+    reads.add("ACG", "III");
+    reads.add("NNNNACGTAC", "IIIIIIIIII");
+    reads.add("nACGTACGTA", "IIIIIIIIII");
+    reads.add("ACGTACGTACGTACGT", "##IIIIIIIIIIII##");
+    reads.add("ACGTACGTAC", "##########");
+    reads.add("ACGTACGTAC", "#I#######I");
+    reads.add("ACGTACGTACGT", "I#IIIIIIII#I");
+    reads.add("ACGTACGTAC", "IIIII");
+    reads.add("ACGTA", "IIIIIIIIII");
+    reads.add("", "");
+    reads.add("", "III");
+    return reads;
+}
+
+}  // namespace fq::test
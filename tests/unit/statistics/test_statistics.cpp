@@ -1,26 +1,40 @@
 #include "statistics/fq_statistic_worker.h"
 #include "statistics/fq_statistic.h"
+#include "statistics/position_count_kernel.h"
 #include "fqtools/io/fastq_io.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
 #include <vector>
 
 namespace fq::statistic {
 
+using fq::common::SimdLevel;
+
 TEST(FqStatisticResultTest, OperatorPlusEquals) {
     FqStatisticResult res1;
     res1.readCount = 10;
     res1.totalBases = 1000;
     res1.maxReadLength = 100;
-    res1.posQualityDist.resize(100, std::vector<uint64_t>(kMaxQual, 1));
-    res1.posBaseDist.resize(100, std::vector<uint64_t>(kMaxBaseNum, 2));
+    res1.posDist.ensure(100);
+    for (size_t i = 0; i < 100; ++i) {
+        std::fill_n(res1.posDist.quality(i), kMaxQual, 1);
+        std::fill_n(res1.posDist.bases(i), kMaxBaseNum, 2);
+    }
 
     FqStatisticResult res2;
     res2.readCount = 5;
     res2.totalBases = 500;
     res2.maxReadLength = 120; // Longer reads
-    res2.posQualityDist.resize(120, std::vector<uint64_t>(kMaxQual, 3));
-    res2.posBaseDist.resize(120, std::vector<uint64_t>(kMaxBaseNum, 4));
+    res2.posDist.ensure(120);
+    for (size_t i = 0; i < 120; ++i) {
+        std::fill_n(res2.posDist.quality(i), kMaxQual, 3);
+        std::fill_n(res2.posDist.bases(i), kMaxBaseNum, 4);
+    }
 
     res1 += res2;
 
@@ -30,17 +44,91 @@ TEST(FqStatisticResultTest, OperatorPlusEquals) {
     
     // Check combined distributions for first 100 positions
     for (int i = 0; i < 100; ++i) {
-        EXPECT_EQ(res1.posQualityDist[i][0], 4); // 1 + 3
-        EXPECT_EQ(res1.posBaseDist[i][0], 6);    // 2 + 4
+        EXPECT_EQ(res1.posDist.quality(i)[0], 4); // 1 + 3
+        EXPECT_EQ(res1.posDist.bases(i)[0], 6);   // 2 + 4
     }
     
     // Check distribution for positions 100-120 (only from res2)
     for (int i = 100; i < 120; ++i) {
-        EXPECT_EQ(res1.posQualityDist[i][0], 3);
-        EXPECT_EQ(res1.posBaseDist[i][0], 4);
+        EXPECT_EQ(res1.posDist.quality(i)[0], 3);
+        EXPECT_EQ(res1.posDist.bases(i)[0], 4);
     }
 }
 
+TEST(FqStatisticResultTest, PartialSaveLoadMerge) {
+    FqStatisticResult res1;
+    res1.readCount = 3;
+    res1.totalBases = 12;
+    res1.maxReadLength = 4;
+    res1.posDist.ensure(4);
+    for (size_t i = 0; i < 4; ++i) {
+        res1.posDist.quality(i)[i + 30] = 3;
+        res1.posDist.bases(i)[i % kMaxBaseNum] = 3;
+    }
+
+    const std::string path = "test_statistics_partial.fqs";
+    res1.save(path, "lane1.fq");
+    std::string name;
+    auto loaded = FqStatisticResult::load(path, &name);
+    EXPECT_EQ(name, "lane1.fq");
+    EXPECT_EQ(loaded.readCount, 3);
+    EXPECT_EQ(loaded.totalBases, 12);
+    EXPECT_EQ(loaded.maxReadLength, 4);
+    EXPECT_TRUE(loaded.posDist == res1.posDist);
+
+    loaded += FqStatisticResult::load(path);
+    EXPECT_EQ(loaded.readCount, 6);
+    EXPECT_EQ(loaded.posDist.quality(2)[32], 6);
+
+    std::ofstream(path, std::ios::trunc) << "not a partial";
+    EXPECT_THROW(FqStatisticResult::load(path), std::runtime_error);
+    std::filesystem::remove(path);
+
+    EXPECT_TRUE(isStatisticPartialPath("out/lane1.fqs"));
+    EXPECT_FALSE(isStatisticPartialPath("lane1.stat.txt"));
+}
+
+TEST(FqStatisticResultTest, CorruptPartialHeaderThrowsBeforeAllocating) {
+    FqStatisticResult res;
+    res.readCount = 1;
+    res.totalBases = 4;
+    res.maxReadLength = 4;
+    res.posDist.ensure(4);
+
+    const std::string path = "test_statistics_corrupt.fqs";
+    res.save(path, "lane1.fq");
+    std::string valid;
+    {
+        std::ifstream in(path, std::ios::binary);
+        valid.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    // 头部字段偏移：positions 为 u64@40，名称长度为 u32@48
+    auto expectCorrupt = [&](std::string bytes) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+        try {
+            (void)FqStatisticResult::load(path);
+            ADD_FAILURE() << "corrupt partial was accepted";
+        } catch (const std::runtime_error& e) {
+            EXPECT_NE(std::string(e.what()).find("Corrupted statistics partial"), std::string::npos)
+                << e.what();
+        }
+    };
+    auto withField = [&](size_t offset, size_t width, uint64_t value) {
+        std::string bytes = valid;
+        for (size_t i = 0; i < width; ++i) {
+            bytes[offset + i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+        return bytes;
+    };
+    expectCorrupt(withField(40, 8, uint64_t{1} << 40));
+    expectCorrupt(withField(40, 8, ~uint64_t{0}));
+    expectCorrupt(withField(48, 4, 0xffffffffU));
+    expectCorrupt(valid.substr(0, valid.size() - 1));
+
+    std::filesystem::remove(path);
+}
+
 TEST(FqStatisticWorkerTest, CalculateStats) {
     FqStatisticWorker worker(33); // Sanger offset
     fq::io::FastqBatch batch;
@@ -64,14 +152,72 @@ TEST(FqStatisticWorkerTest, CalculateStats) {
     EXPECT_EQ(result.maxReadLength, 5);
 
     // Check base distribution at pos 0: 1 A (from rec2), 1 A (from rec1) -> 2 A
-    EXPECT_EQ(result.posBaseDist[0][0], 2); // A
+    EXPECT_EQ(result.posDist.bases(0)[0], 2); // A
     
     // Check N count at pos 4: 1 N (from rec1)
-    EXPECT_EQ(result.posBaseDist[4][4], 1); // N
+    EXPECT_EQ(result.posDist.bases(4)[4], 1); // N
     
     // Check Quality distribution at pos 0: 1 '!' (0), 1 'I' (40)
-    EXPECT_EQ(result.posQualityDist[0][0], 1);
-    EXPECT_EQ(result.posQualityDist[0][40], 1);
+    EXPECT_EQ(result.posDist.quality(0)[0], 1);
+    EXPECT_EQ(result.posDist.quality(0)[40], 1);
+}
+
+TEST(FqStatisticWorkerTest, AccumulateMatchesMergedBatchResults) {
+    FqStatisticWorker worker(33);
+    fq::io::FastqBatch shortBatch;
+    fq::io::FastqRecord rec;
+    rec.id = "short";
+    rec.seq = "ACG";
+    rec.qual = "5?I";
+    shortBatch.records().push_back(rec);
+
+    fq::io::FastqBatch longBatch;
+    rec.id = "long";
+    rec.seq = "TTGCAN";
+    rec.qual = "IIII#!";
+    longBatch.records().push_back(rec);
+
+    FqStatisticResult accumulated;
+    worker.accumulate(shortBatch, accumulated);
+    worker.accumulate(longBatch, accumulated);
+
+    auto merged = worker.calculateStats(shortBatch);
+    merged += worker.calculateStats(longBatch);
+
+    EXPECT_EQ(accumulated.readCount, merged.readCount);
+    EXPECT_EQ(accumulated.totalBases, merged.totalBases);
+    EXPECT_EQ(accumulated.maxReadLength, 6);
+    EXPECT_TRUE(accumulated.posDist == merged.posDist);
+}
+
+TEST(PositionCountKernelTest, AllSimdLevelsMatchScalar) {
+    // 覆盖大小写碱基、非法字符、超出范围与高位质量字符，以及质量行短于序列的情况
+    const std::string alphabet = "ACGTNacgtnRYx.-@\x80\xff";
+    std::string seq;
+    std::string qual;
+    uint32_t state = 12345;
+    auto next = [&state] {
+        state = state * 1103515245U + 12345U;
+        return state >> 16;
+    };
+    for (size_t i = 0; i < 173; ++i) {
+        seq.push_back(alphabet[next() % alphabet.size()]);
+        qual.push_back(static_cast<char>(next() % 256));
+    }
+
+    PositionHistogram expected;
+    expected.ensure(seq.size());
+    positionCountKernel(SimdLevel::Scalar)(seq, qual, 33, expected);
+    positionCountKernel(SimdLevel::Scalar)(seq, std::string_view(qual).substr(0, 50), 33,
+                                           expected);
+
+    for (const auto level : {SimdLevel::Sse42, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        PositionHistogram actual;
+        actual.ensure(seq.size());
+        positionCountKernel(level)(seq, qual, 33, actual);
+        positionCountKernel(level)(seq, std::string_view(qual).substr(0, 50), 33, actual);
+        EXPECT_TRUE(actual == expected) << "level=" << fq::common::simdLevelName(level);
+    }
 }
 
 TEST(FqStatisticWorkerTest, EmptyBatch) {
@@ -79,7 +225,7 @@ TEST(FqStatisticWorkerTest, EmptyBatch) {
     fq::io::FastqBatch batch;
     auto result = worker.calculateStats(batch);
     EXPECT_EQ(result.readCount, 0);
-    EXPECT_TRUE(result.posQualityDist.empty());
+    EXPECT_TRUE(result.posDist.empty());
 }
 
 } // namespace fq::statistic